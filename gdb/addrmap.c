@@ -133,32 +133,28 @@ static void *
 addrmap_fixed_find (const addrmap *self, CORE_ADDR addr)
 {
   const addrmap_fixed *map = (const addrmap_fixed *) self;
-  const addrmap_transition *bottom = &map->transitions[0];
-  const addrmap_transition *top = &map->transitions[map->num_transitions - 1];
 
-  while (bottom < top)
+  /* Find the last transition whose address is <= ADDR.  There always
+     is one, since the first transition is for address 0.
+
+     This is on the hot path of PC to block and PC to CU lookups, so
+     it is written to avoid unpredictable branches: the loop runs a
+     number of iterations that only depends on the size of the map,
+     and the comparison is typically compiled to a conditional move.
+     The map never changes once created, so concurrent lookups are
+     safe.  */
+  const addrmap_transition *base = &map->transitions[0];
+  size_t n = map->num_transitions;
+
+  while (n > 1)
     {
-      /* This needs to round towards top, or else when top = bottom +
-	 1 (i.e., two entries are under consideration), then mid ==
-	 bottom, and then we may not narrow the range when (mid->addr
-	 < addr).  */
-      const addrmap_transition *mid = top - (top - bottom) / 2;
+      size_t half = n / 2;
 
-      if (mid->addr == addr)
-	{
-	  bottom = mid;
-	  break;
-	}
-      else if (mid->addr < addr)
-	/* We don't eliminate mid itself here, since each transition
-	   covers all subsequent addresses until the next.  This is why
-	   we must round up in computing the midpoint.  */
-	bottom = mid;
-      else
-	top = mid - 1;
+      base = base[half].addr <= addr ? base + half : base;
+      n -= half;
     }
 
-  return bottom->value;
+  return base->value;
 }
 
 
@@ -711,6 +707,28 @@ test_addrmap ()
   CHECK_ADDRMAP_FIND (map, array, 13, 13, val2);
   CHECK_ADDRMAP_FIND (map, array, 14, 19, nullptr);
 
+  /* Check lookups in a fixed addrmap with many transitions, of both
+     odd and even counts.  */
+  for (unsigned count : { 31, 32 })
+    {
+      static char big_array[128];
+
+      struct addrmap *big = addrmap_create_mutable (&temp_obstack);
+      for (unsigned j = 0; j < count; ++j)
+	addrmap_set_empty (big, core_addr (&big_array[j * 4]),
+			   core_addr (&big_array[j * 4 + 1]), &big_array[j]);
+
+      struct addrmap *big_fixed = addrmap_create_fixed (big, &temp_obstack);
+      SELF_CHECK (addrmap_find (big_fixed, 0) == nullptr);
+      for (unsigned j = 0; j < count; ++j)
+	{
+	  CHECK_ADDRMAP_FIND (big_fixed, big_array, j * 4, j * 4 + 1,
+			      &big_array[j]);
+	  CHECK_ADDRMAP_FIND (big_fixed, big_array, j * 4 + 2, j * 4 + 3,
+			      nullptr);
+	}
+    }
+
   /* Cleanup.  */
   obstack_free (&temp_obstack, NULL);
 }
@@ -220,6 +220,8 @@ static void update_global_location_list_nothrow (enum ugll_insert_mode);
 
 static void insert_breakpoint_locations (void);
 
+static void update_target_software_watchpoints ();
+
 static void trace_pass_command (const char *, int);
 
 static void set_tracepoint_count (int num);
@@ -3014,6 +3016,106 @@ insert_breakpoints (void)
      auto-hw", so we need to call it even if we don't have new
      locations.  */
   update_global_location_list (UGLL_INSERT);
+
+  update_target_software_watchpoints ();
+}
+
+/* The software watchpoints update_target_software_watchpoints last
+   decided about, by number, and the process it decided for.  Numbers
+   are never reused, so this identifies the set of watchpoints the
+   target was asked to check, if any.  */
+
+struct target_software_watchpoints_key
+{
+  int pid = 0;
+  std::vector<int> numbers;
+
+  bool operator== (const target_software_watchpoints_key &other) const
+  {
+    return pid == other.pid && numbers == other.numbers;
+  }
+};
+
+static target_software_watchpoints_key target_software_watchpoints;
+
+/* Ask the target to check the values of the enabled software
+   watchpoints while the inferior runs, instead of GDB single-stepping
+   the inferior and checking them after each step.  This is only
+   worthwhile if the target can compute the values of all of them.
+
+   This is called on every resume, so it only compiles the watched
+   expressions and talks to the target when the set of enabled
+   software watchpoints changed since the last call.  Watchpoints
+   that depend on a frame are never handed over, whatever the frame,
+   so the frame does not matter.  */
+
+static void
+update_target_software_watchpoints ()
+{
+  std::vector<struct watchpoint *> watchpoints;
+
+  for (breakpoint *b : all_breakpoints ())
+    if (b->type == bp_watchpoint && breakpoint_enabled (b) && b->loc != NULL)
+      watchpoints.push_back ((struct watchpoint *) b);
+
+  if (watchpoints.empty () && target_software_watchpoints.numbers.empty ())
+    return;
+
+  /* The flags of the watchpoints must reflect what the target was
+     told, so only change them while we can tell the target.  */
+  if (!target_has_execution ()
+      || inferior_ptid == null_ptid
+      || inferior_thread ()->executing ())
+    return;
+
+  target_software_watchpoints_key key;
+  key.pid = inferior_ptid.pid ();
+  for (struct watchpoint *w : watchpoints)
+    key.numbers.push_back (w->number);
+
+  if (key == target_software_watchpoints)
+    return;
+
+  std::vector<agent_expr_up> exprs;
+  CORE_ADDR pc = regcache_read_pc (get_current_regcache ());
+
+  for (struct watchpoint *w : watchpoints)
+    {
+      /* The target computes the value wherever the inferior is, so
+	 the expression must not depend on a frame.  */
+      agent_expr_up aexpr;
+      if (w->exp_valid_block == NULL
+	  && w->loc->pspace == current_program_space)
+	aexpr = parse_cond_to_aexpr (pc, w->exp.get ());
+
+      if (aexpr == nullptr)
+	{
+	  exprs.clear ();
+	  break;
+	}
+      exprs.push_back (std::move (aexpr));
+    }
+
+  bool checked = target_set_software_watchpoints (exprs);
+
+  target_software_watchpoints = std::move (key);
+  for (struct watchpoint *w : watchpoints)
+    w->checked_by_target = checked;
+}
+
+/* Called when inferior INF exits or is detached from.  Whatever it
+   asked the target to check went with the process.  */
+
+static void
+forget_target_software_watchpoints (struct inferior *inf)
+{
+  if (inf->pid != target_software_watchpoints.pid)
+    return;
+
+  target_software_watchpoints = {};
+  for (breakpoint *b : all_breakpoints ())
+    if (b->type == bp_watchpoint)
+      ((struct watchpoint *) b)->checked_by_target = false;
 }
 
 /* This is used when we need to synch breakpoint conditions between GDB and the
@@ -5881,7 +5983,8 @@ bool
 bpstat_should_step ()
 {
   for (breakpoint *b : all_breakpoints ())
-    if (breakpoint_enabled (b) && b->type == bp_watchpoint && b->loc != NULL)
+    if (breakpoint_enabled (b) && b->type == bp_watchpoint && b->loc != NULL
+	&& !((struct watchpoint *) b)->checked_by_target)
       return true;
 
   return false;
@@ -12717,7 +12820,10 @@ update_breakpoint_locations (struct breakpoint *b,
     }
 
   /* If possible, carry over 'disable' status from existing
-     breakpoints.  */
+     breakpoints.  Whether a location is disabled by its condition
+     was found out above, by parsing the condition again; the old
+     status may be stale, e.g. if the condition refers to a symbol of
+     a library that just got loaded.  */
   {
     struct bp_location *e = existing_locations;
     /* If there are multiple breakpoints with the same function name,
@@ -12729,7 +12835,7 @@ update_breakpoint_locations (struct breakpoint *b,
 
     for (; e; e = e->next)
       {
-	if ((!e->enabled || e->disabled_by_cond) && e->function_name)
+	if (!e->enabled && e->function_name)
 	  {
 	    if (have_ambiguous_names)
 	      {
@@ -12745,7 +12851,6 @@ update_breakpoint_locations (struct breakpoint *b,
 		    if (breakpoint_locations_match (e, l, true))
 		      {
 			l->enabled = e->enabled;
-			l->disabled_by_cond = e->disabled_by_cond;
 			break;
 		      }
 		  }
@@ -12758,7 +12863,6 @@ update_breakpoint_locations (struct breakpoint *b,
 				 l->function_name.get ()) == 0)
 		    {
 		      l->enabled = e->enabled;
-		      l->disabled_by_cond = e->disabled_by_cond;
 		      break;
 		    }
 	      }
@@ -12930,11 +13034,115 @@ breakpoint_re_set_one (breakpoint *b)
   b->re_set ();
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* Return true if adding OBJFILES to the current program space may
+   change the locations of breakpoint B.  That can only be the case if
+   B's location names something in OBJFILES, which is much cheaper to
+   find out by decoding the location against OBJFILES only than by
+   re-setting B against all the objfiles of the program space.  */
 
-void
-breakpoint_re_set (void)
+static bool
+objfiles_may_change_breakpoint (breakpoint *b,
+				const std::vector<objfile *> &objfiles)
+{
+  /* Only check code breakpoints whose locations are found by decoding
+     a linespec or explicit location, the default way.  */
+  if ((!is_breakpoint (b) && !is_tracepoint (b))
+      || b->type == bp_static_tracepoint
+      || b->type == bp_static_marker_tracepoint
+      || breakpoint_event_location_empty_p (b)
+      || b->location_range_end != nullptr)
+    return true;
+
+  enum event_location_type type = event_location_type (b->location.get ());
+  if (type != LINESPEC_LOCATION && type != EXPLICIT_LOCATION)
+    return true;
+
+  input_radix = b->input_radix;
+  set_language (b->language);
+
+  try
+    {
+      struct linespec_result canonical;
+
+      decode_line_full (b->location.get (), DECODE_LINE_FUNFIRSTLINE,
+			current_program_space, NULL, 0, &canonical,
+			multiple_symbols_all, b->filter.get (), &objfiles);
+
+      for (const linespec_sals &lsal : canonical.lsals)
+	if (!lsal.sals.empty ())
+	  return true;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Anything but not finding the location at all is left to the
+	 re-set to report.  */
+      if (ex.error != NOT_FOUND_ERROR)
+	return true;
+    }
+
+  return false;
+}
+
+/* Parse the condition of breakpoint B again at each of its locations
+   in the current program space.  B's locations are unchanged, but its
+   condition may refer to symbols that just became available, for
+   instance in a newly loaded library, which can make locations
+   disabled by their condition valid again.  */
+
+static void
+reparse_breakpoint_conditions (breakpoint *b)
+{
+  if (b->cond_string == nullptr || is_watchpoint (b))
+    return;
+
+  bool changed = false;
+  int loc_num = 0;
+  for (bp_location *loc : b->locations ())
+    {
+      loc_num++;
+      if (loc->pspace != current_program_space)
+	continue;
+
+      if (!loc->disabled_by_cond)
+	{
+	  set_breakpoint_location_condition (b->cond_string.get (), loc,
+					     b->number, loc_num);
+	  if (loc->disabled_by_cond)
+	    changed = true;
+	}
+      else
+	{
+	  const char *s = b->cond_string.get ();
+
+	  try
+	    {
+	      loc->cond = parse_exp_1 (&s, loc->address,
+				       block_for_pc (loc->address), 0);
+	      if (loc->enabled)
+		gdb_printf (_("Breakpoint %d's condition is now valid at "
+			      "location %d, enabling.\n"),
+			    b->number, loc_num);
+	      loc->disabled_by_cond = false;
+	      changed = true;
+	    }
+	  catch (const gdb_exception_error &e)
+	    {
+	      /* Still invalid.  This was reported when the location got
+		 disabled, so stay quiet.  */
+	    }
+	}
+    }
+
+  mark_breakpoint_modified (b);
+  if (changed)
+    gdb::observers::breakpoint_modified.notify (b);
+}
+
+/* Re-set the locations of the breakpoints for which MAY_CHANGE
+   returns true, for the current program space.  */
+
+static void
+breakpoint_re_set_if (gdb::function_view<bool (breakpoint *)> may_change)
 {
   {
     scoped_restore_current_language save_language;
@@ -12963,7 +13171,8 @@ breakpoint_re_set (void)
       {
 	try
 	  {
-	    breakpoint_re_set_one (b);
+	    if (may_change (b))
+	      breakpoint_re_set_one (b);
 	  }
 	catch (const gdb_exception &ex)
 	  {
@@ -12984,6 +13193,43 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_if ([] (breakpoint *)
+    {
+      return true;
+    });
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (const std::vector<objfile *> &objfiles)
+{
+  /* The symbols of OBJFILES may be in their separate debug
+     objfiles.  */
+  std::vector<objfile *> searched;
+
+  for (objfile *objfile : objfiles)
+    for (struct objfile *iter : objfile->separate_debug_objfiles ())
+      searched.push_back (iter);
+
+  breakpoint_re_set_if ([&] (breakpoint *b)
+    {
+      if (objfiles_may_change_breakpoint (b, searched))
+	return true;
+
+      /* The locations stay, but the condition is parsed per location
+	 and may refer to symbols of OBJFILES.  */
+      reparse_breakpoint_conditions (b);
+      return false;
+    });
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -14883,4 +15129,6 @@ This is useful for formatted output in user-defined commands."));
 					   "breakpoint");
   gdb::observers::thread_exit.attach (remove_threaded_breakpoints,
 				      "breakpoint");
+  gdb::observers::inferior_exit.attach (forget_target_software_watchpoints,
+					"breakpoint");
 }
@@ -936,6 +936,11 @@ struct watchpoint : public breakpoint
 
   /* The mask address for a masked hardware watchpoint.  */
   CORE_ADDR hw_wp_mask;
+
+  /* True if this is a software watchpoint the target checks while the
+     inferior runs (see target_set_software_watchpoints), so that GDB
+     need not single-step the inferior for it.  */
+  bool checked_by_target = false;
 };
 
 /* Return true if BPT is either a software breakpoint or a hardware
@@ -1354,6 +1359,15 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Re-set breakpoint locations for the current program space, after
+   OBJFILES were added to it.  Unlike breakpoint_re_set, this leaves
+   alone the breakpoints whose locations can not be in OBJFILES, which
+   keeps loading shared libraries from costing as much as re-setting
+   every breakpoint against every objfile.  */
+
+extern void breakpoint_re_set_objfiles
+  (const std::vector<struct objfile *> &objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
@@ -83,8 +83,15 @@ build_id_to_debug_bfd_1 (const std::string &link, size_t build_id_len,
   /* lrealpath() is expensive even for the usually non-existent files.  */
   gdb::unique_xmalloc_ptr<char> filename_holder;
   const char *filename = nullptr;
+  const separate_debug_file_probe *probe
+    = find_separate_debug_file_probe (link);
   if (startswith (link, TARGET_SYSROOT_PREFIX))
     filename = link.c_str ();
+  else if (probe != nullptr)
+    {
+      if (probe->exists && !probe->real_path.empty ())
+	filename = probe->real_path.c_str ();
+    }
   else if (access (link.c_str (), F_OK) == 0)
     {
       filename_holder.reset (lrealpath (link.c_str ()));
@@ -125,14 +132,14 @@ build_id_to_debug_bfd_1 (const std::string &link, size_t build_id_len,
   return debug_bfd;
 }
 
-/* Common code for finding BFDs of a given build-id.  This function
-   works with both debuginfo files (SUFFIX == ".debug") and executable
-   files (SUFFIX == "").  */
+/* See build-id.h.  */
 
-static gdb_bfd_ref_ptr
-build_id_to_bfd_suffix (size_t build_id_len, const bfd_byte *build_id,
-			const char *suffix)
+std::vector<std::string>
+build_id_file_candidates (size_t build_id_len, const bfd_byte *build_id,
+			  const char *suffix)
 {
+  std::vector<std::string> candidates;
+
   /* Keep backward compatibility so that DEBUG_FILE_DIRECTORY being "" will
      cause "/.build-id/..." lookups.  */
 
@@ -162,22 +169,34 @@ build_id_to_bfd_suffix (size_t build_id_len, const bfd_byte *build_id,
 
       link += suffix;
 
-      gdb_bfd_ref_ptr debug_bfd
-	= build_id_to_debug_bfd_1 (link, build_id_len, build_id);
-      if (debug_bfd != NULL)
-	return debug_bfd;
+      candidates.push_back (link);
 
       /* Try to look under the sysroot as well.  If the sysroot is
 	 "/the/sysroot", it will give
 	 "/the/sysroot/usr/lib/debug/.build-id/ab/cdef.debug".  */
 
       if (!gdb_sysroot.empty ())
-	{
-	  link = gdb_sysroot + link;
-	  debug_bfd = build_id_to_debug_bfd_1 (link, build_id_len, build_id);
-	  if (debug_bfd != NULL)
-	    return debug_bfd;
-	}
+	candidates.push_back (gdb_sysroot + link);
+    }
+
+  return candidates;
+}
+
+/* Common code for finding BFDs of a given build-id.  This function
+   works with both debuginfo files (SUFFIX == ".debug") and executable
+   files (SUFFIX == "").  */
+
+static gdb_bfd_ref_ptr
+build_id_to_bfd_suffix (size_t build_id_len, const bfd_byte *build_id,
+			const char *suffix)
+{
+  for (const std::string &link
+	 : build_id_file_candidates (build_id_len, build_id, suffix))
+    {
+      gdb_bfd_ref_ptr debug_bfd
+	= build_id_to_debug_bfd_1 (link, build_id_len, build_id);
+      if (debug_bfd != NULL)
+	return debug_bfd;
     }
 
   return {};
@@ -34,6 +34,15 @@ extern int build_id_verify (bfd *abfd,
 			    size_t check_len, const bfd_byte *check);
 
 
+/* Return the names of the files which may be the file with the given
+   build-id, in the order in which they should be tried.  The files are
+   looked for in the ".build-id" subdirectory of the debug file
+   directories, and have suffix SUFFIX: ".debug" for debuginfo files,
+   or "" for executable files.  */
+
+extern std::vector<std::string> build_id_file_candidates
+  (size_t build_id_len, const bfd_byte *build_id, const char *suffix);
+
 /* Find and open a BFD for a debuginfo file  given a build-id.  If no BFD
    can be found, return NULL.  */
 
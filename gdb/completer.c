@@ -1607,6 +1607,15 @@ completion_tracker::remove_completion (const char *name)
     }
 }
 
+/* See completer.h.  */
+
+bool
+completion_tracker::have_completion (const char *name) const
+{
+  hashval_t hash = htab_hash_string (name);
+  return htab_find_with_hash (m_entries_hash.get (), name, hash) != NULL;
+}
+
 /* Helper for the make_completion_match_str overloads.  Returns NULL
    as an indication that we want MATCH_NAME exactly.  It is up to the
    caller to xstrdup that string if desired.  */
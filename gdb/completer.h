@@ -331,6 +331,9 @@ class completion_tracker
      if NAME is not already in the completion list.  */
   void remove_completion (const char *name);
 
+  /* Return true if NAME is already in the completion list.  */
+  bool have_completion (const char *name) const;
+
   /* Set the quote char to be appended after a unique completion is
      added to the input line.  Set to '\0' to clear.  See
      m_quote_char's description.  */
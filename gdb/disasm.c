@@ -32,6 +32,12 @@
 #include "gdbsupport/gdb_optional.h"
 #include "valprint.h"
 #include "cli/cli-style.h"
+#include "progspace.h"
+#include "objfiles.h"
+#include "inferior.h"
+#include "observable.h"
+#include "gdbsupport/byte-vector.h"
+#include <unordered_map>
 
 /* Disassemble functions.
    FIXME: We should get rid of all the duplicate code in gdb that does
@@ -837,12 +843,138 @@ gdb_disassembler::~gdb_disassembler ()
 
 bool gdb_disassembler::use_ext_lang_colorization_p = true;
 
+/* An instruction in the disassembly cache.  */
+
+struct disasm_cache_entry
+{
+  /* The architecture used to disassemble the instruction.  */
+  struct gdbarch *gdbarch;
+
+  /* The bytes of the instruction.  The entry is only used if memory
+     still holds them.  */
+  gdb::byte_vector bytes;
+
+  /* The disassembled instruction, as printed to the destination
+     stream.  */
+  std::string text;
+
+  /* The number of branch delay slot instructions.  */
+  int branch_delay_insns;
+};
+
+/* The instructions disassembled in a program space.  The same
+   instructions are often disassembled over and over, e.g. by the TUI
+   on each stop, or by "x/i $pc" or "record instruction-history".
+
+   Entries are keyed by address, and there is one map for the styled
+   and one for the unstyled output, indexed by whether the destination
+   stream can emit style escapes.  Symbolic addresses are part of the
+   text, so the cache is flushed when objfiles are added or removed.
+   It is also flushed when any setting changes, as many of them affect
+   the output, e.g. the disassembly flavor or the styling.  */
+
+struct disasm_cache
+{
+  std::unordered_map<CORE_ADDR, disasm_cache_entry> insns[2];
+};
+
+/* The maximum number of instructions in each map of a disasm_cache.
+   When a map is full, it is cleared.  */
+
+static const size_t disasm_cache_max_size = 65536;
+
+/* The per-program-space disassembly cache.  */
+
+static const program_space_key<disasm_cache> disasm_cache_key;
+
+/* Flush the disassembly cache of PSPACE.  */
+
+static void
+flush_disasm_cache (struct program_space *pspace)
+{
+  disasm_cache_key.clear (pspace);
+}
+
+/* Flush the disassembly cache of every program space.  */
+
+static void
+flush_all_disasm_caches ()
+{
+  for (struct program_space *pspace : program_spaces)
+    flush_disasm_cache (pspace);
+}
+
+/* Implement the "maint flush disassembly-cache" command.  */
+
+static void
+maintenance_flush_disasm_cache (const char *args, int from_tty)
+{
+  flush_all_disasm_caches ();
+}
+
+/* Observer for the memory_changed event.  Entries whose bytes were
+   overwritten would be found stale anyway, but there is no point in
+   keeping them.  */
+
+static void
+disasm_cache_memory_changed (struct inferior *inf, CORE_ADDR addr,
+			     ssize_t len, const bfd_byte *data)
+{
+  flush_disasm_cache (inf->pspace);
+}
+
+/* Observer for the new_objfile and free_objfile events.  */
+
+static void
+disasm_cache_objfile_changed (struct objfile *objfile)
+{
+  if (objfile == nullptr)
+    flush_disasm_cache (current_program_space);
+  else
+    flush_disasm_cache (objfile->pspace);
+}
+
+/* Observer for the command_param_changed event.  */
+
+static void
+disasm_cache_param_changed (const char *param, const char *value)
+{
+  flush_all_disasm_caches ();
+}
+
 /* See disasm.h.  */
 
 int
 gdb_disassembler::print_insn (CORE_ADDR memaddr,
 			      int *branch_delay_insns)
 {
+  /* Only instructions read from target memory can be cached.
+     Subclasses reading the instructions from elsewhere are not.  */
+  disasm_cache *cache = nullptr;
+  std::unordered_map<CORE_ADDR, disasm_cache_entry> *insns = nullptr;
+  if (m_di.read_memory_func == dis_asm_read_memory)
+    {
+      cache = disasm_cache_key.get (current_program_space);
+      if (cache == nullptr)
+	cache = disasm_cache_key.emplace (current_program_space);
+      insns = &cache->insns[m_dest->can_emit_style_escape ()];
+
+      auto it = insns->find (memaddr);
+      if (it != insns->end () && it->second.gdbarch == arch ())
+	{
+	  const disasm_cache_entry &entry = it->second;
+	  gdb::byte_vector bytes (entry.bytes.size ());
+	  if (target_read_code (memaddr, bytes.data (), bytes.size ()) == 0
+	      && bytes == entry.bytes)
+	    {
+	      m_di.fprintf_func (m_dest, "%s", entry.text.c_str ());
+	      if (branch_delay_insns != NULL)
+		*branch_delay_insns = entry.branch_delay_insns;
+	      return entry.bytes.size ();
+	    }
+	}
+    }
+
   m_err_memaddr.reset ();
   m_buffer.clear ();
 
@@ -900,13 +1032,28 @@ gdb_disassembler::print_insn (CORE_ADDR memaddr,
 	error (_("unknown disassembler error (error = %d)"), length);
     }
 
+  int delay_insns = m_di.insn_info_valid ? m_di.branch_delay_insns : 0;
   if (branch_delay_insns != NULL)
+    *branch_delay_insns = delay_insns;
+
+  /* Remember the instruction, if its bytes can be read back to validate
+     the cached entry later.  */
+  if (insns != nullptr && length > 0)
     {
-      if (m_di.insn_info_valid)
-	*branch_delay_insns = m_di.branch_delay_insns;
-      else
-	*branch_delay_insns = 0;
+      disasm_cache_entry entry;
+      entry.gdbarch = arch ();
+      entry.bytes.resize (length);
+      if (target_read_code (memaddr, entry.bytes.data (), length) == 0)
+	{
+	  if (insns->size () >= disasm_cache_max_size)
+	    insns->clear ();
+
+	  entry.text = m_buffer.string ();
+	  entry.branch_delay_insns = delay_insns;
+	  (*insns)[memaddr] = std::move (entry);
+	}
     }
+
   return length;
 }
 
@@ -1053,6 +1200,8 @@ get_disassembler_options (struct gdbarch *gdbarch)
 void
 set_disassembler_options (const char *prospective_options)
 {
+  flush_all_disasm_caches ();
+
   struct gdbarch *gdbarch = get_current_arch ();
   char **disassembler_options = gdbarch_disassembler_options (gdbarch);
   const disasm_options_and_args_t *valid_options_and_args;
@@ -1277,4 +1426,18 @@ Show the disassembler options."), NULL,
 					 show_disassembler_options_sfunc,
 					 &setlist, &showlist);
   set_cmd_completer (set_show_disas_opts.set, disassembler_options_completer);
+
+  add_cmd ("disassembly-cache", class_maintenance,
+	   maintenance_flush_disasm_cache,
+	   _("Flush the disassembly cache for each program space."),
+	   &maintenanceflushlist);
+
+  gdb::observers::memory_changed.attach (disasm_cache_memory_changed,
+					 "disasm");
+  gdb::observers::new_objfile.attach (disasm_cache_objfile_changed,
+				      "disasm");
+  gdb::observers::free_objfile.attach (disasm_cache_objfile_changed,
+				       "disasm");
+  gdb::observers::command_param_changed.attach (disasm_cache_param_changed,
+						"disasm");
 }
@@ -1081,6 +1081,21 @@ call_site_find_chain (struct gdbarch *gdbarch, CORE_ADDR caller_pc,
 {
   gdb::unique_xmalloc_ptr<call_site_chain> retval;
 
+  /* This is called for each frame being unwound, and most callers
+     have no call site information at all, e.g. code compiled without
+     optimization.  Check for that up front, rather than paying for
+     the formatting, throwing and catching of the NO_ENTRY_VALUE_ERROR
+     below.  */
+  if (!entry_values_debug)
+    {
+      /* -1 as tail call PC can be already after the compilation unit
+	 range, like in call_site_for_pc.  */
+      compunit_symtab *cust = find_pc_compunit_symtab (caller_pc - 1);
+
+      if (cust == nullptr || cust->find_call_site (caller_pc) == nullptr)
+	return NULL;
+    }
+
   try
     {
       retval = call_site_find_chain_1 (gdbarch, caller_pc, callee_pc);
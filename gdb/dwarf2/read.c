@@ -7070,6 +7070,16 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
        prompt, which looks weird.  */
     using result_type = std::pair<std::unique_ptr<cooked_index>,
 				  std::vector<gdb_exception>>;
+
+    /* The time needed to scan a CU is roughly proportional to its
+       size, and CU sizes vary wildly, so let the work be split by
+       size rather than by CU count.  */
+    auto task_size_ = [] (iter_type iter)
+      {
+	return (size_t) (*iter)->length;
+      };
+    gdb::function_view<size_t (iter_type)> task_size = task_size_;
+
     std::vector<result_type> results
       = gdb::parallel_for_each (1, per_bfd->all_comp_units.begin (),
 				per_bfd->all_comp_units.end (),
@@ -7091,7 +7101,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 	      }
 	  }
 	return result_type (thread_storage.release (), std::move (errors));
-      });
+      }, task_size);
 
     /* Only show a given exception a single time.  */
     std::unordered_set<gdb_exception> seen_exceptions;
@@ -18609,6 +18619,8 @@ cooked_index_functions::expand_symtabs_matching
       for (const cooked_index_entry *entry : table->find (name_vec.back (),
 							  completing))
 	{
+	  QUIT;
+
 	  /* No need to consider symbols from expanded CUs.  */
 	  if (per_objfile->symtab_set_p (entry->per_cu))
 	    continue;
@@ -18649,18 +18661,22 @@ cooked_index_functions::expand_symtabs_matching
 	    continue;
 
 	  /* Might have been looking for "a::b" and found
-	     "x::a::b".  */
-	  if (symbol_matcher == nullptr)
-	    {
-	      symbol_name_match_type match_type
-		= lookup_name_without_params.match_type ();
-	      if ((match_type == symbol_name_match_type::FULL
-		   || (lang != language_ada
-		       && match_type == symbol_name_match_type::EXPRESSION))
-		  && parent != nullptr)
-		continue;
-	    }
-	  else
+	     "x::a::b".  A search for any name, which leaves the
+	     matching to SYMBOL_MATCHER, is not restricted to outermost
+	     names, though.  Ada expressions match nested names, but
+	     only in Ada CUs.  */
+	  symbol_name_match_type match_type
+	    = lookup_name_without_params.match_type ();
+	  if ((match_type == symbol_name_match_type::FULL
+	       || (match_type == symbol_name_match_type::EXPRESSION
+		   && (lang != language_ada
+		       || entry->per_cu->lang != language_ada)))
+	      && parent != nullptr
+	      && (symbol_matcher == nullptr
+		  || !lookup_name_without_params.name ().empty ()))
+	    continue;
+
+	  if (symbol_matcher != nullptr)
 	    {
 	      auto_obstack temp_storage;
 	      const char *full_name = entry->full_name (&temp_storage);
@@ -42,7 +42,13 @@
 #include "floatformat.h"
 #include "f-lang.h"
 #include <algorithm>
+#include <unordered_map>
 #include "gmp-utils.h"
+#include "gdbsupport/byte-vector.h"
+#include "observable.h"
+#include "frame.h"
+#include "inferior.h"
+#include "infrun.h"
 
 /* The value of an invalid conversion badness.  */
 #define INVALID_CONVERSION 100
@@ -2895,6 +2901,187 @@ resolve_dynamic_type_internal (struct type *type,
   return resolved_type;
 }
 
+/* A key of the dynamic type cache.  */
+
+struct dynamic_type_cache_key
+{
+  /* The arguments of resolve_dynamic_type.  */
+  struct type *type;
+  gdb::byte_vector valaddr;
+  CORE_ADDR addr;
+
+  /* The context the dynamic properties are evaluated in: the selected
+     thread and frame, if any, and the current language, which the
+     Fortran hack in resolve_dynamic_type_internal depends on.  */
+  ptid_t ptid;
+  bool frame_p;
+  struct frame_id frame;
+  const struct language_defn *language;
+
+  bool operator== (const dynamic_type_cache_key &other) const
+  {
+    return (type == other.type
+	    && addr == other.addr
+	    && valaddr == other.valaddr
+	    && ptid == other.ptid
+	    && frame_p == other.frame_p
+	    && (!frame_p || frame_id_eq (frame, other.frame))
+	    && language == other.language);
+  }
+};
+
+/* Hash function for dynamic_type_cache_key.  */
+
+struct dynamic_type_cache_hash
+{
+  size_t operator() (const dynamic_type_cache_key &key) const
+  {
+    return htab_hash_pointer (key.type) ^ std::hash<CORE_ADDR> () (key.addr);
+  }
+};
+
+/* The types resolved by resolve_dynamic_type.  Evaluating the dynamic
+   properties of a type means evaluating DWARF expressions, which can
+   be expensive, and the same objects are often resolved over and
+   over, e.g. when printing them several times or when printing the
+   elements of an array.  The result also depends on the contents of
+   target memory and registers, so the cache is flushed whenever they
+   may have changed, and it is not used at all in non-stop mode, as
+   other threads may be running.  The types are owned by objfiles, so
+   the cache is flushed when objfiles are added or removed.  */
+
+static std::unordered_map<dynamic_type_cache_key, struct type *,
+			  dynamic_type_cache_hash> dynamic_type_cache;
+
+/* The maximum number of entries in the dynamic type cache.  When it is
+   full, it is cleared.  */
+
+static const size_t dynamic_type_cache_max_size = 4096;
+
+/* Objects whose contents are bigger than this are not cached, as
+   comparing the contents would become too costly.  */
+
+static const size_t dynamic_type_cache_max_valaddr = 1024;
+
+/* Flush the dynamic type cache.  */
+
+static void
+flush_dynamic_type_cache ()
+{
+  dynamic_type_cache.clear ();
+}
+
+/* The result of looking up the complete type of an opaque or stub
+   type in check_typedef.  */
+
+struct check_typedef_lookup
+{
+  /* The current language when the lookup was done.  */
+  const struct language_defn *language;
+
+  /* The complete type found, or NULL if there is none.  */
+  struct type *type;
+};
+
+/* Lookups done by check_typedef, keyed by the main_type of the opaque
+   or stub type.  */
+
+using check_typedef_lookup_map
+  = std::unordered_map<const struct main_type *, check_typedef_lookup>;
+
+/* The lookups done by check_typedef in a program space.
+
+   When the complete type is in the same objfile as the opaque or stub
+   type, check_typedef replaces the latter, so that it is only looked
+   up once.  But when it is in a different objfile, or when there is
+   none, the lookup would be done each time, e.g. for every element of
+   an array of pointers to an opaque struct.  The lookups only depend
+   on the objfiles of the program space, so the memo is flushed when
+   objfiles are added or removed.  */
+
+struct check_typedef_memo
+{
+  /* Lookups of opaque types, done with lookup_transparent_type.  */
+  check_typedef_lookup_map opaque;
+
+  /* Lookups of stub types, done with lookup_symbol.  */
+  check_typedef_lookup_map stub;
+};
+
+/* The per-program-space check_typedef memo.  */
+
+static const program_space_key<check_typedef_memo> check_typedef_memo_key;
+
+/* Flush the check_typedef memo of PSPACE.  */
+
+static void
+flush_check_typedef_memo (struct program_space *pspace)
+{
+  check_typedef_memo_key.clear (pspace);
+}
+
+/* Observer for the new_objfile and free_objfile events.  */
+
+static void
+gdbtypes_objfile_changed (struct objfile *objfile)
+{
+  if (objfile == nullptr)
+    flush_check_typedef_memo (current_program_space);
+  else
+    flush_check_typedef_memo (objfile->pspace);
+
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the memory_changed event.  */
+
+static void
+dynamic_type_cache_memory_changed (struct inferior *inf, CORE_ADDR addr,
+				   ssize_t len, const bfd_byte *data)
+{
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the register_changed event.  */
+
+static void
+dynamic_type_cache_register_changed (struct frame_info *frame, int regnum)
+{
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the target_resumed event.  */
+
+static void
+dynamic_type_cache_target_resumed (ptid_t ptid)
+{
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the target_changed event.  */
+
+static void
+dynamic_type_cache_target_changed (struct target_ops *target)
+{
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the traceframe_changed event.  */
+
+static void
+dynamic_type_cache_traceframe_changed (int tfnum, int tpnum)
+{
+  flush_dynamic_type_cache ();
+}
+
+/* Observer for the inferior_exit event.  */
+
+static void
+dynamic_type_cache_inferior_exit (struct inferior *inf)
+{
+  flush_dynamic_type_cache ();
+}
+
 /* See gdbtypes.h  */
 
 struct type *
@@ -2902,10 +3089,43 @@ resolve_dynamic_type (struct type *type,
 		      gdb::array_view<const gdb_byte> valaddr,
 		      CORE_ADDR addr)
 {
+  if (!is_dynamic_type (type))
+    return type;
+
+  gdb::optional<dynamic_type_cache_key> key;
+  if (!non_stop && valaddr.size () <= dynamic_type_cache_max_valaddr)
+    {
+      key.emplace ();
+      key->type = type;
+      key->valaddr.assign (valaddr.begin (), valaddr.end ());
+      key->addr = addr;
+      key->ptid = inferior_ptid;
+      /* Same as dwarf2_evaluate_property when it is not given a
+	 frame.  */
+      key->frame_p = has_stack_frames ();
+      if (key->frame_p)
+	key->frame = get_frame_id (get_selected_frame (nullptr));
+      key->language = current_language;
+
+      auto it = dynamic_type_cache.find (*key);
+      if (it != dynamic_type_cache.end ())
+	return it->second;
+    }
+
   struct property_addr_info pinfo
     = {check_typedef (type), valaddr, addr, NULL};
 
-  return resolve_dynamic_type_internal (type, &pinfo, 1);
+  struct type *resolved_type
+    = resolve_dynamic_type_internal (type, &pinfo, 1);
+
+  if (key.has_value ())
+    {
+      if (dynamic_type_cache.size () >= dynamic_type_cache_max_size)
+	flush_dynamic_type_cache ();
+      dynamic_type_cache[std::move (*key)] = resolved_type;
+    }
+
+  return resolved_type;
 }
 
 /* See gdbtypes.h  */
@@ -2973,6 +3193,51 @@ type::remove_dyn_prop (dynamic_prop_node_kind kind)
     }
 }
 
+/* Return the check_typedef lookups of the current program space, for
+   opaque types if OPAQUE is true, or else for stub types.  */
+
+static check_typedef_lookup_map &
+check_typedef_lookups (bool opaque)
+{
+  check_typedef_memo *memo
+    = check_typedef_memo_key.get (current_program_space);
+  if (memo == nullptr)
+    memo = check_typedef_memo_key.emplace (current_program_space);
+  return opaque ? memo->opaque : memo->stub;
+}
+
+/* Look up the complete type of TYPE, whose name is NAME.  TYPE is an
+   opaque type if OPAQUE is true, or else a stub type.  Returns NULL if
+   there is no complete type.  The lookups are memoized.  */
+
+static struct type *
+lookup_complete_type (struct type *type, const char *name, bool opaque)
+{
+  {
+    check_typedef_lookup_map &lookups = check_typedef_lookups (opaque);
+    auto it = lookups.find (type->main_type);
+    if (it != lookups.end () && it->second.language == current_language)
+      return it->second.type;
+  }
+
+  struct type *result;
+  if (opaque)
+    result = lookup_transparent_type (name);
+  else
+    {
+      /* FIXME: shouldn't we look in STRUCT_DOMAIN and/or VAR_DOMAIN
+	 as appropriate?  */
+      struct symbol *sym = lookup_symbol (name, 0, STRUCT_DOMAIN, 0).symbol;
+      result = sym != nullptr ? sym->type () : nullptr;
+    }
+
+  /* The lookup may have read symbols and flushed the memo, so get it
+     again.  */
+  check_typedef_lookups (opaque)[type->main_type]
+    = { current_language, result };
+  return result;
+}
+
 /* Find the real type of TYPE.  This function returns the real type,
    after removing all layers of typedefs, and completing opaque or stub
    types.  Completion changes the TYPE argument, but stripping of
@@ -2999,7 +3264,8 @@ type::remove_dyn_prop (dynamic_prop_node_kind kind)
    (but not any code) that if we don't find a full definition, we'd
    set a flag so we don't spend time in the future checking the same
    type.  That would be a mistake, though--we might load in more
-   symbols which contain a full definition for the type.  */
+   symbols which contain a full definition for the type.  Instead, the
+   lookups are memoized until objfiles are added or removed.  */
 
 struct type *
 check_typedef (struct type *type)
@@ -3088,7 +3354,7 @@ check_typedef (struct type *type)
 	  stub_noname_complaint ();
 	  return make_qualified_type (type, instance_flags, NULL);
 	}
-      newtype = lookup_transparent_type (name);
+      newtype = lookup_complete_type (type, name, true);
 
       if (newtype)
 	{
@@ -3101,7 +3367,8 @@ check_typedef (struct type *type)
 	     have different lifetimes.  Trying to copy NEWTYPE over to
 	     TYPE's objfile is pointless, too, since you'll have to
 	     move over any other types NEWTYPE refers to, which could
-	     be an unbounded amount of stuff.  */
+	     be an unbounded amount of stuff.  The lookup is memoized
+	     though, see check_typedef_memo.  */
 	  if (newtype->objfile_owner () == type->objfile_owner ())
 	    type = make_qualified_type (newtype, type->instance_flags (), type);
 	  else
@@ -3113,26 +3380,23 @@ check_typedef (struct type *type)
   else if (type->is_stub () && !currently_reading_symtab)
     {
       const char *name = type->name ();
-      /* FIXME: shouldn't we look in STRUCT_DOMAIN and/or VAR_DOMAIN
-	 as appropriate?  */
-      struct symbol *sym;
+      struct type *newtype;
 
       if (name == NULL)
 	{
 	  stub_noname_complaint ();
 	  return make_qualified_type (type, instance_flags, NULL);
 	}
-      sym = lookup_symbol (name, 0, STRUCT_DOMAIN, 0).symbol;
-      if (sym)
+      newtype = lookup_complete_type (type, name, false);
+      if (newtype)
 	{
 	  /* Same as above for opaque types, we can replace the stub
 	     with the complete type only if they are in the same
 	     objfile.  */
-	  if (sym->type ()->objfile_owner () == type->objfile_owner ())
-	    type = make_qualified_type (sym->type (),
-					type->instance_flags (), type);
+	  if (newtype->objfile_owner () == type->objfile_owner ())
+	    type = make_qualified_type (newtype, type->instance_flags (), type);
 	  else
-	    type = sym->type ();
+	    type = newtype;
 	}
     }
 
@@ -6456,6 +6720,21 @@ _initialize_gdbtypes ()
 {
   gdbtypes_data = gdbarch_data_register_post_init (gdbtypes_post_init);
 
+  gdb::observers::new_objfile.attach (gdbtypes_objfile_changed, "gdbtypes");
+  gdb::observers::free_objfile.attach (gdbtypes_objfile_changed, "gdbtypes");
+  gdb::observers::memory_changed.attach (dynamic_type_cache_memory_changed,
+					 "gdbtypes");
+  gdb::observers::register_changed.attach
+    (dynamic_type_cache_register_changed, "gdbtypes");
+  gdb::observers::target_resumed.attach (dynamic_type_cache_target_resumed,
+					 "gdbtypes");
+  gdb::observers::target_changed.attach (dynamic_type_cache_target_changed,
+					 "gdbtypes");
+  gdb::observers::traceframe_changed.attach
+    (dynamic_type_cache_traceframe_changed, "gdbtypes");
+  gdb::observers::inferior_exit.attach (dynamic_type_cache_inferior_exit,
+					"gdbtypes");
+
   add_setshow_zuinteger_cmd ("overload", no_class, &overload_debug,
 			     _("Set debugging of C++ overloading."),
 			     _("Show debugging of C++ overloading."),
@@ -190,14 +190,9 @@ server's cwd if remote debugging.\n"));
 }
 
 
-/* This function strips the '&' character (indicating background
-   execution) that is added as *the last* of the arguments ARGS of a
-   command.  A copy of the incoming ARGS without the '&' is returned,
-   unless the resulting string after stripping is empty, in which case
-   NULL is returned.  *BG_CHAR_P is an output boolean that indicates
-   whether the '&' character was found.  */
-
-static gdb::unique_xmalloc_ptr<char>
+/* See inferior.h.  */
+
+gdb::unique_xmalloc_ptr<char>
 strip_bg_char (const char *args, int *bg_char_p)
 {
   const char *p;
@@ -235,6 +235,16 @@ extern struct value *get_return_value (struct symbol *func_symbol,
 extern void prepare_execution_command (struct target_ops *target,
 				       int background);
 
+/* This function strips the '&' character (indicating background
+   execution) that is added as *the last* of the arguments ARGS of a
+   command.  A copy of the incoming ARGS without the '&' is returned,
+   unless the resulting string after stripping is empty, in which case
+   NULL is returned.  *BG_CHAR_P is an output boolean that indicates
+   whether the '&' character was found.  */
+
+extern gdb::unique_xmalloc_ptr<char> strip_bg_char (const char *args,
+						     int *bg_char_p);
+
 /* Nonzero if stopped due to completion of a stack dummy routine.  */
 
 extern enum stop_stack_kind stop_stack_dummy;
@@ -169,6 +169,34 @@ show_debug_infrun (struct ui_file *file, int from_tty,
   gdb_printf (file, _("Inferior debugging is %s.\n"), value);
 }
 
+/* See infrun.h.  */
+
+bool use_range_stepping = true;
+
+/* The "set/show range-stepping" show hook.  */
+
+static void
+show_range_stepping (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c,
+		     const char *value)
+{
+  gdb_printf (file,
+	      _("Debugger's willingness to use range stepping "
+		"is %s.\n"), value);
+}
+
+/* The "set/show range-stepping" set hook.  */
+
+static void
+set_range_stepping (const char *ignore_args, int from_tty,
+		    struct cmd_list_element *c)
+{
+  /* When enabling, check whether range stepping is actually supported
+     by the target, and warn if not.  */
+  if (use_range_stepping && !target_supports_range_stepping ())
+    warning (_("Range stepping is not supported by the current target"));
+}
+
 /* Support for disabling address space randomization.  */
 
 bool disable_randomization = true;
@@ -4662,6 +4690,65 @@ handle_syscall_event (struct execution_control_state *ecs)
   return true;
 }
 
+/* The line table lookups done while stepping tend to hit the same few
+   lines over and over, e.g. when stepping through a loop, or through
+   code where the instructions of inlined functions are interleaved.
+   This caches the last few results of find_pc_line, each of which
+   holds for any PC in [PC, END).  */
+
+static symtab_and_line step_sal_cache[16];
+
+/* The entry of step_sal_cache the next lookup replaces.  */
+
+static unsigned int step_sal_cache_next;
+
+/* Forget the lines in step_sal_cache, whenever the symbols they come
+   from may change.  */
+
+static void
+clear_step_sal_cache ()
+{
+  for (symtab_and_line &sal : step_sal_cache)
+    sal = {};
+  step_sal_cache_next = 0;
+}
+
+static void
+step_sal_cache_new_objfile (struct objfile *objfile)
+{
+  clear_step_sal_cache ();
+}
+
+static void
+step_sal_cache_free_objfile (struct objfile *objfile)
+{
+  clear_step_sal_cache ();
+}
+
+/* Like find_pc_line (PC, 0), but through step_sal_cache.  */
+
+static symtab_and_line
+find_step_pc_line (CORE_ADDR pc)
+{
+  /* With overlays, the same address may map to different code.  */
+  if (overlay_debugging)
+    return find_pc_line (pc, 0);
+
+  for (const symtab_and_line &sal : step_sal_cache)
+    if (sal.pspace == current_program_space
+	&& sal.pc <= pc && pc < sal.end)
+      return sal;
+
+  symtab_and_line sal = find_pc_line (pc, 0);
+  if (sal.line != 0 && sal.pc <= pc && pc < sal.end)
+    {
+      step_sal_cache[step_sal_cache_next] = sal;
+      step_sal_cache_next
+	= (step_sal_cache_next + 1) % ARRAY_SIZE (step_sal_cache);
+    }
+  return sal;
+}
+
 /* Lazily fill in the execution_control_state's stop_func_* fields.  */
 
 static void
@@ -5185,6 +5272,55 @@ stop_all_threads (const char *reason, inferior *inf)
     }
 }
 
+/* See infrun.h.  */
+
+bool
+pause_threads (inferior *inf, gdb::function_view<void ()> callback)
+{
+  gdb_assert (exists_non_stop_target ());
+
+  /* restart_threads would leave the threads stopped until an in-line
+     step-over finishes, and stopping a displaced step cancels it.  */
+  if (step_over_info_valid_p () || displaced_step_in_progress (inf))
+    return false;
+
+  INFRUN_SCOPED_DEBUG_START_END ("inf=%d", inf->num);
+
+  scoped_disable_commit_resumed disable_commit_resumed ("pausing threads");
+  scoped_restore_current_thread restore_thread;
+
+  stop_all_threads ("pausing threads", inf);
+
+  auto restart = [inf] ()
+    {
+      restart_threads (nullptr, inf);
+
+      /* Threads that reported an event as we stopped them are resumed
+	 again with that event pending.  Wake up the event loop to have
+	 it handled.  */
+      for (thread_info *tp : inf->non_exited_threads ())
+	if (tp->resumed () && tp->has_pending_waitstatus ())
+	  {
+	    mark_async_event_handler (infrun_async_inferior_event_token);
+	    break;
+	  }
+    };
+
+  try
+    {
+      callback ();
+    }
+  catch (const gdb_exception &)
+    {
+      restart ();
+      throw;
+    }
+
+  restart ();
+  disable_commit_resumed.reset_and_commit ();
+  return true;
+}
+
 /* Handle a TARGET_WAITKIND_NO_RESUMED event.  */
 
 static bool
@@ -5877,7 +6013,7 @@ handle_inferior_event (struct execution_control_state *ecs)
 
 /* Restart threads back to what they were trying to do back when we
    paused them (because of an in-line step-over or vfork, for example).
-   The EVENT_THREAD thread is ignored (not restarted).
+   The EVENT_THREAD thread, if not nullptr, is ignored (not restarted).
 
    If INF is non-nullptr, only resume threads from INF.  */
 
@@ -5885,7 +6021,9 @@ static void
 restart_threads (struct thread_info *event_thread, inferior *inf)
 {
   INFRUN_SCOPED_DEBUG_START_END ("event_thread=%s, inf=%d",
-				 event_thread->ptid.to_string ().c_str (),
+				 (event_thread != nullptr
+				  ? event_thread->ptid.to_string ().c_str ()
+				  : "none"),
 				 inf != nullptr ? inf->num : -1);
 
   gdb_assert (!step_over_info_valid_p ());
@@ -7251,7 +7389,7 @@ process_event_stop_test (struct execution_control_state *ecs)
      stack of inlined frames, even if GDB actually believes that it is in a
      more outer frame.  This is checked for below by calls to
      inline_skipped_frames.  */
-  stop_pc_sal = find_pc_line (ecs->event_thread->stop_pc (), 0);
+  stop_pc_sal = find_step_pc_line (ecs->event_thread->stop_pc ());
 
   /* NOTE: tausq/2004-05-24: This if block used to be done before all
      the trampoline processing logic, however, there are some trampolines 
@@ -7860,7 +7998,7 @@ handle_step_into_function_backward (struct gdbarch *gdbarch,
     ecs->stop_func_start
       = gdbarch_skip_prologue_noexcept (gdbarch, ecs->stop_func_start);
 
-  stop_func_sal = find_pc_line (ecs->event_thread->stop_pc (), 0);
+  stop_func_sal = find_step_pc_line (ecs->event_thread->stop_pc ());
 
   /* OK, we're just going to keep stepping here.  */
   if (stop_func_sal.pc == ecs->event_thread->stop_pc ())
@@ -9888,6 +10026,20 @@ enabled by default on some platforms."),
 			   &show_disable_randomization,
 			   &setlist, &showlist);
 
+  add_setshow_boolean_cmd ("range-stepping", class_run,
+			   &use_range_stepping, _("\
+Enable or disable range stepping."), _("\
+Show whether target-assisted range stepping is enabled."), _("\
+If on, and the target supports it, when stepping a source line, GDB\n\
+tells the target to step the corresponding range of addresses itself instead\n\
+of issuing multiple single-steps.  This speeds up source level\n\
+stepping.  If off, GDB always issues single-steps, even if range\n\
+stepping is supported by the target.  The default is on."),
+			   set_range_stepping,
+			   show_range_stepping,
+			   &setlist,
+			   &showlist);
+
   /* ptid initializations */
   inferior_ptid = null_ptid;
   target_last_wait_ptid = minus_one_ptid;
@@ -9899,6 +10051,9 @@ enabled by default on some platforms."),
   gdb::observers::thread_exit.attach (infrun_thread_thread_exit, "infrun");
   gdb::observers::inferior_exit.attach (infrun_inferior_exit, "infrun");
   gdb::observers::inferior_execd.attach (infrun_inferior_execd, "infrun");
+  gdb::observers::new_objfile.attach (step_sal_cache_new_objfile, "infrun");
+  gdb::observers::free_objfile.attach (step_sal_cache_free_objfile,
+				       "infrun");
 
   /* Explicitly create without lookup, since that tries to create a
      value with a void typed value, and when we get here, gdbarch
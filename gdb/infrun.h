@@ -21,6 +21,7 @@
 #include "gdbthread.h"
 #include "symtab.h"
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/function-view.h"
 #include "gdbsupport/intrusive_list.h"
 
 struct target_waitstatus;
@@ -100,6 +101,10 @@ extern bool non_stop;
    starting an inferior.  */
 extern bool disable_randomization;
 
+/* When set (default), a target that can step a range of addresses
+   itself (see thread_control_state::may_range_step) is allowed to.  */
+extern bool use_range_stepping;
+
 /* Returns a unique identifier for the current stop.  This can be used
    to tell whether a command has proceeded the inferior past the
    current location.  */
@@ -173,6 +178,16 @@ extern void nullify_last_target_wait_ptid ();
    all threads of all inferiors.  */
 extern void stop_all_threads (const char *reason, inferior *inf = nullptr);
 
+/* Stop the running threads of INF, call CALLBACK, and set them
+   running again, as if they had never stopped.  Events the threads
+   report while they are being stopped are left pending, to be handled
+   as usual afterwards.  Return false without stopping anything if a
+   thread is stepping over a breakpoint, as that must finish first.
+
+   This requires INF's target to be non-stop.  */
+extern bool pause_threads (inferior *inf,
+			   gdb::function_view<void ()> callback);
+
 extern void prepare_for_detach (void);
 
 extern void fetch_inferior_event ();
@@ -42,6 +42,7 @@
 #include "readline/tilde.h"
 #include "completer.h"
 #include <forward_list>
+#include <unordered_map>
 
 static std::string jit_reader_dir;
 
@@ -233,6 +234,27 @@ get_jiter_objfile_data (objfile *objf)
   return objf->jiter_data.get ();
 }
 
+/* Map from the inferior address of a struct jit_code_entry to the
+   objfile created for it, or to nullptr if its symbol file could not be
+   read.  Keeping this per program space means that registering and
+   unregistering code does not have to walk all the objfiles, which
+   matters for JITs that register many thousands of small entries.  */
+
+using jit_entry_map = std::unordered_map<CORE_ADDR, objfile *>;
+
+static const program_space_key<jit_entry_map> jit_entry_map_key;
+
+/* Fetch the jit_entry_map of PSPACE, creating it if needed.  */
+
+static jit_entry_map &
+get_jit_entry_map (program_space *pspace)
+{
+  jit_entry_map *map = jit_entry_map_key.get (pspace);
+  if (map == nullptr)
+    map = jit_entry_map_key.emplace (pspace);
+  return *map;
+}
+
 /* Remember OBJFILE has been created for struct jit_code_entry located
    at inferior address ENTRY.  */
 
@@ -244,6 +266,25 @@ add_objfile_entry (struct objfile *objfile, CORE_ADDR entry,
 
   objfile->jited_data.reset (new jited_objfile_data (entry, symfile_addr,
 						     symfile_size));
+  get_jit_entry_map (objfile->pspace)[entry] = objfile;
+}
+
+/* Called when OBJFILE is about to be freed.  Forget about its code
+   entry.  */
+
+static void
+jit_free_objfile (struct objfile *objfile)
+{
+  if (objfile->jited_data == nullptr)
+    return;
+
+  jit_entry_map *map = jit_entry_map_key.get (objfile->pspace);
+  if (map == nullptr)
+    return;
+
+  auto it = map->find (objfile->jited_data->addr);
+  if (it != map->end () && it->second == objfile)
+    map->erase (it);
 }
 
 /* Helper function for reading the global JIT descriptor from remote
@@ -747,7 +788,8 @@ jit_reader_try_read_symtab (gdbarch *gdbarch, jit_code_entry *code_entry,
 static void
 jit_bfd_try_read_symtab (struct jit_code_entry *code_entry,
 			 CORE_ADDR entry_addr,
-			 struct gdbarch *gdbarch)
+			 struct gdbarch *gdbarch,
+			 symfile_add_flags add_flags)
 {
   struct bfd_section *sec;
   struct objfile *objfile;
@@ -799,8 +841,8 @@ JITed symbol file is not an object file, ignoring it.\n"));
 
   /* This call does not take ownership of SAI.  */
   objfile = symbol_file_add_from_bfd (nbfd.get (),
-				      bfd_get_filename (nbfd.get ()), 0,
-				      &sai,
+				      bfd_get_filename (nbfd.get ()),
+				      add_flags, &sai,
 				      OBJF_SHARED | OBJF_NOT_FILENAME, NULL);
 
   add_objfile_entry (objfile, entry_addr, code_entry->symfile_addr,
@@ -810,11 +852,14 @@ JITed symbol file is not an object file, ignoring it.\n"));
 /* This function registers code associated with a JIT code entry.  It uses the
    pointer and size pair in the entry to read the symbol file from the remote
    and then calls symbol_file_add_from_local_memory to add it as though it were
-   a symbol file added by the user.  */
+   a symbol file added by the user.  ADD_FLAGS are passed on to the symbol
+   reader; pass SYMFILE_DEFER_BP_RESET when registering a batch of entries,
+   and re-set the breakpoints once afterwards.  */
 
 static void
 jit_register_code (struct gdbarch *gdbarch,
-		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry)
+		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry,
+		   symfile_add_flags add_flags)
 {
   int success;
 
@@ -825,21 +870,80 @@ jit_register_code (struct gdbarch *gdbarch,
   success = jit_reader_try_read_symtab (gdbarch, code_entry, entry_addr);
 
   if (!success)
-    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch);
+    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch, add_flags);
 }
 
 /* Look up the objfile with this code entry address.  */
 
 static struct objfile *
-jit_find_objf_with_entry_addr (CORE_ADDR entry_addr)
+jit_find_objf_with_entry_addr (program_space *pspace, CORE_ADDR entry_addr)
+{
+  jit_entry_map *map = jit_entry_map_key.get (pspace);
+  if (map == nullptr)
+    return nullptr;
+
+  auto it = map->find (entry_addr);
+  if (it == map->end ())
+    return nullptr;
+
+  return it->second;
+}
+
+/* Register CODE_ENTRY, located at ENTRY_ADDR in PSPACE, unless it has
+   been seen already.  Breakpoints are not re-set.  Return true if the
+   entry was new.  */
+
+static bool
+jit_register_new_entry (gdbarch *gdbarch, program_space *pspace,
+			CORE_ADDR entry_addr, jit_code_entry *code_entry)
+{
+  jit_entry_map &map = get_jit_entry_map (pspace);
+  if (map.find (entry_addr) != map.end ())
+    return false;
+
+  jit_register_code (gdbarch, entry_addr, code_entry,
+		     SYMFILE_DEFER_BP_RESET);
+
+  /* Also remember entries whose symbol file could not be read, so that
+     they are not retried, and the failure reported, on every event.  */
+  map.emplace (entry_addr, nullptr);
+  return true;
+}
+
+/* Register the new code entries found by following the list of PSPACE
+   from ENTRY_ADDR, through the next_entry links if NEXT_P is true and
+   through the prev_entry links otherwise.  Stop at the end of the list
+   or at the first entry that was seen already.  Return the number of
+   entries registered.  */
+
+static int
+jit_register_new_entries (gdbarch *gdbarch, program_space *pspace,
+			  CORE_ADDR entry_addr, bool next_p)
 {
-  for (objfile *objf : current_program_space->objfiles ())
+  int count = 0;
+
+  while (entry_addr != 0)
     {
-      if (objf->jited_data != nullptr && objf->jited_data->addr == entry_addr)
-	return objf;
+      jit_code_entry code_entry;
+
+      try
+	{
+	  jit_read_code_entry (gdbarch, entry_addr, &code_entry);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  exception_print (gdb_stderr, ex);
+	  break;
+	}
+
+      if (!jit_register_new_entry (gdbarch, pspace, entry_addr, &code_entry))
+	break;
+
+      ++count;
+      entry_addr = next_p ? code_entry.next_entry : code_entry.prev_entry;
     }
 
-  return NULL;
+  return count;
 }
 
 /* This is called when a breakpoint is deleted.  It updates the
@@ -1157,6 +1261,7 @@ jit_inferior_init (inferior *inf)
   CORE_ADDR cur_entry_addr;
   struct gdbarch *gdbarch = inf->gdbarch;
   program_space *pspace = inf->pspace;
+  int registered = 0;
 
   jit_debug_printf ("called");
 
@@ -1191,16 +1296,28 @@ jit_inferior_init (inferior *inf)
 	   cur_entry_addr != 0;
 	   cur_entry_addr = cur_entry.next_entry)
 	{
-	  jit_read_code_entry (gdbarch, cur_entry_addr, &cur_entry);
+	  try
+	    {
+	      jit_read_code_entry (gdbarch, cur_entry_addr, &cur_entry);
+	    }
+	  catch (const gdb_exception_error &ex)
+	    {
+	      exception_print (gdb_stderr, ex);
+	      break;
+	    }
 
 	  /* This hook may be called many times during setup, so make sure
 	     we don't add the same symbol file twice.  */
-	  if (jit_find_objf_with_entry_addr (cur_entry_addr) != NULL)
-	    continue;
-
-	  jit_register_code (gdbarch, cur_entry_addr, &cur_entry);
+	  if (jit_register_new_entry (gdbarch, pspace, cur_entry_addr,
+				      &cur_entry))
+	    ++registered;
 	}
     }
+
+  /* The entries were read without re-setting the breakpoints, do it
+     once for all of them.  */
+  if (registered > 0)
+    breakpoint_re_set ();
 }
 
 /* Looks for the descriptor and registration symbols and breakpoints
@@ -1235,6 +1352,11 @@ jit_inferior_exit_hook (struct inferior *inf)
       if (objf->jited_data != nullptr && objf->jited_data->addr != 0)
 	objf->unlink ();
     }
+
+  /* Forget about the entries that had no objfile too.  */
+  jit_entry_map *map = jit_entry_map_key.get (current_program_space);
+  if (map != nullptr)
+    map->clear ();
 }
 
 void
@@ -1259,15 +1381,42 @@ jit_event_handler (gdbarch *gdbarch, objfile *jiter)
 
     case JIT_REGISTER:
       {
+	program_space *pspace = current_program_space;
 	jit_code_entry code_entry;
+	int registered = 0;
+
 	jit_read_code_entry (gdbarch, entry_addr, &code_entry);
-	jit_register_code (gdbarch, entry_addr, &code_entry);
+	if (jit_register_new_entry (gdbarch, pspace, entry_addr, &code_entry))
+	  ++registered;
+
+	/* Also pick up the new entries linked next to the relevant one.
+	   This lets a JIT link a whole run of entries, at the head or at
+	   the tail of the list, and announce them with a single event.
+	   Entries that were registered already stop the walk, so a JIT
+	   that announces every entry on its own pays nothing extra.  */
+	registered += jit_register_new_entries (gdbarch, pspace,
+						code_entry.next_entry, true);
+	registered += jit_register_new_entries (gdbarch, pspace,
+						code_entry.prev_entry, false);
+
+	jit_debug_printf ("registered %d code entries", registered);
+
+	if (registered > 0)
+	  breakpoint_re_set ();
 	break;
       }
 
     case JIT_UNREGISTER:
       {
-	objfile *jited = jit_find_objf_with_entry_addr (entry_addr);
+	program_space *pspace = current_program_space;
+	objfile *jited = jit_find_objf_with_entry_addr (pspace, entry_addr);
+
+	/* Entries whose symbol file could not be read have no objfile,
+	   but are remembered all the same.  */
+	jit_entry_map *map = jit_entry_map_key.get (pspace);
+	if (map != nullptr)
+	  map->erase (entry_addr);
+
 	if (jited == nullptr)
 	  gdb_printf (gdb_stderr,
 		      _("Unable to find JITed code "
@@ -1321,6 +1470,7 @@ _initialize_jit ()
   gdb::observers::inferior_execd.attach (jit_inferior_created_hook, "jit");
   gdb::observers::inferior_exit.attach (jit_inferior_exit_hook, "jit");
   gdb::observers::breakpoint_deleted.attach (jit_breakpoint_deleted, "jit");
+  gdb::observers::free_objfile.attach (jit_free_objfile, "jit");
 
   jit_gdbarch_data = gdbarch_data_register_pre_init (jit_gdbarch_data_init);
   if (is_dl_available ())
@@ -150,6 +150,9 @@ struct linespec_state
      space.  */
   struct program_space *search_pspace;
 
+  /* If not NULL, the search is restricted to just these objfiles.  */
+  const std::vector<objfile *> *search_objfiles;
+
   /* The default symtab to use, if no other symtab is specified.  */
   struct symtab *default_symtab;
 
@@ -363,7 +366,8 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct program_space *pspace,
+   const std::vector<objfile *> *search_objfiles);
 
 static std::vector<block_symbol> find_label_symbols
   (struct linespec_state *self,
@@ -397,7 +401,8 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct program_space *pspace,
+				 const std::vector<objfile *> *search_objfiles);
 
 static std::vector<symtab_and_line> decode_digits_ordinary
   (struct linespec_state *self,
@@ -1150,6 +1155,18 @@ maybe_add_address (htab_t set, struct program_space *pspace, CORE_ADDR addr)
    space.  If INCLUDE_INLINE is true then symbols representing
    inlined instances of functions will be included in the result.  */
 
+/* Return true if a search restricted to SEARCH_OBJFILES, or not
+   restricted if NULL, covers OBJFILE.  */
+
+static bool
+objfile_searched_p (const std::vector<objfile *> *search_objfiles,
+		    objfile *objfile)
+{
+  return (search_objfiles == nullptr
+	  || std::find (search_objfiles->begin (), search_objfiles->end (),
+			objfile) != search_objfiles->end ());
+}
+
 static void
 iterate_over_all_matching_symtabs
   (struct linespec_state *state,
@@ -1170,6 +1187,9 @@ iterate_over_all_matching_symtabs
 
       for (objfile *objfile : current_program_space->objfiles ())
 	{
+	  if (!objfile_searched_p (state->search_objfiles, objfile))
+	    continue;
+
 	  objfile->expand_symtabs_matching (NULL, &lookup_name, NULL, NULL,
 					    (SEARCH_GLOBAL_BLOCK
 					     | SEARCH_STATIC_BLOCK),
@@ -2047,7 +2067,8 @@ create_sals_line_offset (struct linespec_state *self,
       initialize_defaults (&self->default_symtab, &self->default_line);
       ls->file_symtabs
 	= collect_symtabs_from_filename (self->default_symtab->filename,
-					 self->search_pspace);
+					 self->search_pspace,
+					 self->search_objfiles);
       use_default = 1;
     }
 
@@ -2328,7 +2349,8 @@ convert_explicit_location_to_linespec (struct linespec_state *self,
       try
 	{
 	  result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self->search_pspace,
+				     self->search_objfiles);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2554,7 +2576,8 @@ parse_linespec (linespec_parser *parser, const char *arg,
 	{
 	  PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser)->search_pspace,
+				     PARSER_STATE (parser)->search_objfiles);
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3136,7 +3159,8 @@ decode_line_full (struct event_location *location, int flags,
 		  struct symtab *default_symtab,
 		  int default_line, struct linespec_result *canonical,
 		  const char *select_mode,
-		  const char *filter)
+		  const char *filter,
+		  const std::vector<objfile *> *search_objfiles)
 {
   std::vector<const char *> filters;
   struct linespec_state *state;
@@ -3153,6 +3177,7 @@ decode_line_full (struct event_location *location, int flags,
   linespec_parser parser (flags, current_language,
 			  search_pspace, default_symtab,
 			  default_line, canonical);
+  PARSER_STATE (&parser)->search_objfiles = search_objfiles;
 
   scoped_restore_current_program_space restore_pspace;
 
@@ -3697,11 +3722,13 @@ symtab_collector::operator () (struct symtab *symtab)
 
 /* Given a file name, return a list of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   program space.  If SEARCH_OBJFILES is not NULL, the search is
+   restricted to just these objfiles.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct program_space *search_pspace,
+			       const std::vector<objfile *> *search_objfiles)
 {
   symtab_collector collector;
 
@@ -3723,18 +3750,35 @@ collect_symtabs_from_filename (const char *file,
       iterate_over_symtabs (file, collector);
     }
 
-  return collector.release_symtabs ();
+  std::vector<symtab *> result = collector.release_symtabs ();
+
+  if (search_objfiles != nullptr)
+    result.erase (std::remove_if (result.begin (), result.end (),
+				  [=] (symtab *symtab)
+				  {
+				    objfile *objfile
+				      = symtab->compunit ()->objfile ();
+				    return !objfile_searched_p (search_objfiles,
+								objfile);
+				  }),
+		  result.end ());
+
+  return result;
 }
 
 /* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+   not NULL, the search is restricted to just that program space.  If
+   SEARCH_OBJFILES is not NULL, the search is restricted to just these
+   objfiles.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct program_space *search_pspace,
+		       const std::vector<objfile *> *search_objfiles)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, search_pspace,
+				     search_objfiles);
 
   if (result.empty ())
     {
@@ -4232,6 +4276,9 @@ search_minsyms_for_name (struct collect_info *info,
 
 	  for (objfile *objfile : current_program_space->objfiles ())
 	    {
+	      if (!objfile_searched_p (info->state->search_objfiles, objfile))
+		continue;
+
 	      iterate_over_minimal_symbols (objfile, name,
 					    [&] (struct minimal_symbol *msym)
 					    {
@@ -93,7 +93,9 @@ extern std::vector<symtab_and_line>
    valid for this function.
 
    If SEARCH_PSPACE is not NULL, symbol search is restricted to just
-   that program space.
+   that program space.  If SEARCH_OBJFILES is not NULL, it is
+   restricted to just these objfiles, which must include the separate
+   debug objfiles of interest.
 
    DEFAULT_SYMTAB and DEFAULT_LINE describe the default location.
    DEFAULT_SYMTAB can be NULL, in which case the current symtab and
@@ -129,7 +131,9 @@ extern void decode_line_full (struct event_location *location, int flags,
 			      struct symtab *default_symtab, int default_line,
 			      struct linespec_result *canonical,
 			      const char *select_mode,
-			      const char *filter);
+			      const char *filter,
+			      const std::vector<objfile *> *search_objfiles
+				= nullptr);
 
 /* Given a string, return the line specified by it, using the current
    source symtab and line as defaults.
@@ -846,6 +846,21 @@ struct lwp_info *
 iterate_over_lwps (ptid_t filter,
 		   gdb::function_view<iterate_over_lwps_ftype> callback)
 {
+  /* If FILTER designates a single LWP, look it up directly instead of
+     walking the whole LWP list.  The core often stops or resumes
+     threads one at a time (e.g., stop_all_threads calls target_stop
+     for each thread), which would otherwise be quadratic in the
+     number of LWPs.  */
+  if (filter.lwp_p ())
+    {
+      lwp_info *lp = find_lwp_pid (filter);
+
+      if (lp != NULL && lp->ptid.matches (filter) && callback (lp) != 0)
+	return lp;
+
+      return NULL;
+    }
+
   for (lwp_info *lp : all_lwps_safe ())
     {
       if (lp->ptid.matches (filter))
@@ -1616,6 +1631,21 @@ linux_nat_target::resume (ptid_t scope_ptid, int step, enum gdb_signal signo)
   /* Remember if we're stepping.  */
   lp->last_resume_kind = step ? resume_step : resume_continue;
 
+  /* And whether we may keep stepping without reporting to the core
+     while the thread stays in the line it is stepping through.  */
+  thread_info *tp = find_thread_ptid (this, lp->ptid);
+  if (step && use_range_stepping
+      && tp != nullptr && tp->control.may_range_step)
+    {
+      lp->step_range_start = tp->control.step_range_start;
+      lp->step_range_end = tp->control.step_range_end;
+    }
+  else
+    {
+      lp->step_range_start = 0;
+      lp->step_range_end = 0;
+    }
+
   /* If we have a pending wait status for this thread, there is no
      point in resuming the process.  But first make sure that
      linux_nat_wait won't preemptively handle the event - we
@@ -2464,20 +2494,6 @@ status_callback (struct lwp_info *lp)
   return 1;
 }
 
-/* Count the LWP's that have had events.  */
-
-static int
-count_events_callback (struct lwp_info *lp, int *count)
-{
-  gdb_assert (count != NULL);
-
-  /* Select only resumed LWPs that have an event pending.  */
-  if (lp->resumed && lwp_status_pending_p (lp))
-    (*count)++;
-
-  return 0;
-}
-
 /* Select the LWP (if any) that is currently being single-stepped.  */
 
 static int
@@ -2501,21 +2517,6 @@ lwp_status_pending_p (struct lwp_info *lp)
   return lp->status != 0 || lp->waitstatus.kind () != TARGET_WAITKIND_IGNORE;
 }
 
-/* Select the Nth LWP that has had an event.  */
-
-static int
-select_event_lwp_callback (struct lwp_info *lp, int *selector)
-{
-  gdb_assert (selector != NULL);
-
-  /* Select only resumed LWPs that have an event pending.  */
-  if (lp->resumed && lwp_status_pending_p (lp))
-    if ((*selector)-- == 0)
-      return 1;
-
-  return 0;
-}
-
 /* Called when the LWP stopped for a signal/trap.  If it stopped for a
    trap check what caused it (breakpoint, watchpoint, trace, etc.),
    and save the result in the LWP's stop_reason field.  If it stopped
@@ -2706,33 +2707,35 @@ select_event_lwp (ptid_t filter, struct lwp_info **orig_lp, int *status)
 
   if (event_lp == NULL)
     {
-      /* Pick one at random, out of those which have had events.  */
-
-      /* First see how many events we have.  */
+      /* Pick one at random, out of those which have had events.  We
+	 get here once per reported event, so do it in a single pass
+	 over the LWP list, by replacing the selected LWP by the Nth
+	 LWP with an event with probability 1/N.  This matters when
+	 there are thousands of LWPs.  */
       iterate_over_lwps (filter,
 			 [&] (struct lwp_info *info)
 			 {
-			   return count_events_callback (info, &num_events);
+			   /* Select only resumed LWPs that have an event
+			      pending.  */
+			   if (info->resumed && lwp_status_pending_p (info))
+			     {
+			       num_events++;
+
+			       random_selector = (int)
+				 ((num_events * (double) rand ())
+				  / (RAND_MAX + 1.0));
+			       if (random_selector == 0)
+				 event_lp = info;
+			     }
+
+			   return 0;
 			 });
       gdb_assert (num_events > 0);
 
-      /* Now randomly pick a LWP out of those that have had
-	 events.  */
-      random_selector = (int)
-	((num_events * (double) rand ()) / (RAND_MAX + 1.0));
-
       if (num_events > 1)
-	linux_nat_debug_printf ("Found %d events, selecting #%d",
-				num_events, random_selector);
-
-      event_lp
-	= (iterate_over_lwps
-	   (filter,
-	    [&] (struct lwp_info *info)
-	    {
-	      return select_event_lwp_callback (info,
-						&random_selector);
-	    }));
+	linux_nat_debug_printf ("Found %d events, selected %s",
+				num_events,
+				event_lp->ptid.to_string ().c_str ());
     }
 
   if (event_lp != NULL)
@@ -2754,6 +2757,50 @@ resumed_callback (struct lwp_info *lp)
   return lp->resumed;
 }
 
+/* Return true if LP, which was range stepping (see
+   lwp_info::step_range_start), stopped after a plain single-step that
+   left it in its step range, with nothing else the core must hear
+   about.  */
+
+static bool
+lwp_stepped_in_range_p (struct lwp_info *lp)
+{
+  if (!lp->step
+      || lp->step_range_end == 0
+      || lp->last_resume_kind != resume_step
+      /* We're trying to stop it.  */
+      || lp->signalled)
+    return false;
+
+  if (!WIFSTOPPED (lp->status)
+      || WSTOPSIG (lp->status) != SIGTRAP
+      || linux_is_extended_waitstatus (lp->status)
+      || lp->waitstatus.kind () != TARGET_WAITKIND_IGNORE
+      /* Breakpoints and watchpoints are for the core to handle.  */
+      || lp->stop_reason != TARGET_STOPPED_BY_NO_REASON)
+    return false;
+
+#if USE_SIGTRAP_SIGINFO
+  /* Don't swallow a SIGTRAP the program sent itself.  */
+  siginfo_t siginfo;
+
+  if (!linux_nat_get_siginfo (lp->ptid, &siginfo)
+      || siginfo.si_signo != SIGTRAP
+      || siginfo.si_code != TRAP_TRACE)
+    return false;
+#endif
+
+  if (lp->stop_pc < lp->step_range_start
+      || lp->stop_pc >= lp->step_range_end)
+    return false;
+
+  /* The core reports a breakpoint the thread steps onto as hit, even
+     before the thread executes it.  */
+  struct regcache *regcache = get_thread_regcache (linux_target, lp->ptid);
+
+  return !breakpoint_inserted_here_p (regcache->aspace (), lp->stop_pc);
+}
+
 /* Check if we should go on and pass this event to common code.
 
    If so, save the status to the lwp_info structure associated to LWPID.  */
@@ -3001,6 +3048,23 @@ linux_nat_filter_event (int lwpid, int status)
   gdb_assert (lp);
   lp->status = status;
   save_stop_reason (lp);
+
+  /* But if the LWP is range stepping and still within its range, step
+     it again right away, which saves the core from handling one event
+     per instruction of a source line.  */
+  if (lwp_stepped_in_range_p (lp))
+    {
+      linux_nat_debug_printf
+	("%s stepped to %s, in range [%s, %s), PTRACE_SINGLESTEP again",
+	 lp->ptid.to_string ().c_str (),
+	 paddress (target_gdbarch (), lp->stop_pc),
+	 paddress (target_gdbarch (), lp->step_range_start),
+	 paddress (target_gdbarch (), lp->step_range_end));
+
+      lp->status = 0;
+      linux_resume_one_lwp (lp, 1, GDB_SIGNAL_0);
+      gdb_assert (lp->resumed);
+    }
 }
 
 /* Detect zombie thread group leaders, and "exit" them.  We can't reap
@@ -3732,16 +3796,11 @@ linux_nat_target::update_thread_list ()
      thread list.  */
   delete_exited_threads ();
 
-  /* Update the processor core that each lwp/thread was last seen
-     running on.  */
-  for (lwp_info *lwp : all_lwps ())
-    {
-      /* Avoid accessing /proc if the thread hasn't run since we last
-	 time we fetched the thread's core.  Accessing /proc becomes
-	 noticeably expensive when we have thousands of LWPs.  */
-      if (lwp->core == -1)
-	lwp->core = linux_common_core_of_thread (lwp->ptid);
-    }
+  /* Note that we don't refresh the processor core of each LWP here.
+     That requires accessing /proc, which becomes noticeably expensive
+     when we have thousands of LWPs and the thread list is updated on
+     every stop.  The core is instead fetched on demand, see
+     core_of_thread.  */
 }
 
 std::string
@@ -4106,6 +4165,17 @@ linux_nat_target::supports_disable_randomization ()
   return true;
 }
 
+/* We range step threads by single-stepping them again for as long as
+   they stay in their step range (see linux_nat_filter_event).  That
+   takes hardware single-step: with software single-step, the core
+   never asks us to step.  */
+
+bool
+linux_nat_target::supports_range_stepping ()
+{
+  return !gdbarch_software_single_step_p (target_gdbarch ());
+}
+
 /* SIGCHLD handler that serves two purposes: In non-stop/async mode,
    so we notice when any child changes state, and notify the
    event-loop; it allows us to use sigsuspend in linux_nat_wait_1
@@ -4245,16 +4315,25 @@ linux_nat_target::thread_address_space (ptid_t ptid)
   return inf->aspace;
 }
 
-/* Return the cached value of the processor core for thread PTID.  */
+/* Return the processor core for thread PTID.  The core is cached
+   while the LWP is stopped, so that /proc is only accessed once per
+   LWP stop, and only for the LWPs the core asks about.  */
 
 int
 linux_nat_target::core_of_thread (ptid_t ptid)
 {
   struct lwp_info *info = find_lwp_pid (ptid);
 
-  if (info)
-    return info->core;
-  return -1;
+  if (info == NULL)
+    return -1;
+
+  /* A running LWP may have migrated since we last looked.  */
+  if (!info->stopped)
+    return linux_common_core_of_thread (info->ptid);
+
+  if (info->core == -1)
+    info->core = linux_common_core_of_thread (info->ptid);
+  return info->core;
 }
 
 /* Implementation of to_filesystem_is_local.  */
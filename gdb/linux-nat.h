@@ -95,6 +95,8 @@ class linux_nat_target : public inf_ptrace_target
 
   bool supports_disable_randomization () override;
 
+  bool supports_range_stepping () override;
+
   int core_of_thread (ptid_t ptid) override;
 
   bool filesystem_is_local () override;
@@ -245,6 +247,13 @@ struct lwp_info : intrusive_list_node<lwp_info>
   /* Non-zero if we were stepping this LWP.  */
   int step = 0;
 
+  /* If STEP is set, the range of addresses, [STEP_RANGE_START,
+     STEP_RANGE_END), the core lets this LWP keep stepping through
+     without reporting each instruction (range stepping).  Both are 0
+     if every step is to be reported.  */
+  CORE_ADDR step_range_start = 0;
+  CORE_ADDR step_range_end = 0;
+
   /* The reason the LWP last stopped, if we need to track it
      (breakpoint, watchpoint, etc.).  */
   target_stop_reason stop_reason = TARGET_STOPPED_BY_NO_REASON;
@@ -272,7 +281,8 @@ struct lwp_info : intrusive_list_node<lwp_info>
      - TARGET_WAITKIND_SYSCALL_RETURN */
   enum target_waitkind syscall_state;
 
-  /* The processor core this LWP was last seen on.  */
+  /* The processor core this LWP was last seen on, or -1 if it hasn't
+     been fetched since the LWP last ran.  */
   int core = -1;
 
   /* Arch-specific additions.  */
@@ -35,7 +35,7 @@
 
 static void varobj_update_one (struct varobj *var,
 			       enum print_values print_values,
-			       bool is_explicit);
+			       bool compact, bool is_explicit);
 
 static int mi_print_value_p (struct varobj *var,
 			     enum print_values print_values);
@@ -589,7 +589,7 @@ mi_cmd_var_assign (const char *command, char **argv, int argc)
 
 static void
 mi_cmd_var_update_iter (struct varobj *var, bool only_floating,
-			enum print_values print_values)
+			enum print_values print_values, bool compact)
 {
   bool thread_stopped;
 
@@ -610,7 +610,7 @@ mi_cmd_var_update_iter (struct varobj *var, bool only_floating,
 
   if (thread_stopped
       && (!only_floating || varobj_floating_p (var)))
-    varobj_update_one (var, print_values, false /* implicit */);
+    varobj_update_one (var, print_values, compact, false /* implicit */);
 }
 
 void
@@ -619,9 +619,17 @@ mi_cmd_var_update (const char *command, char **argv, int argc)
   struct ui_out *uiout = current_uiout;
   char *name;
   enum print_values print_values;
+  bool compact = false;
+
+  if (argc > 0 && strcmp (argv[0], "--compact") == 0)
+    {
+      compact = true;
+      argv++;
+      argc--;
+    }
 
   if (argc != 1 && argc != 2)
-    error (_("-var-update: Usage: [PRINT_VALUES] NAME."));
+    error (_("-var-update: Usage: [--compact] [PRINT_VALUES] NAME."));
 
   if (argc == 1)
     name = argv[0];
@@ -654,7 +662,7 @@ mi_cmd_var_update (const char *command, char **argv, int argc)
 
       all_root_varobjs ([=] (varobj *var)
         {
-	  mi_cmd_var_update_iter (var, *name == '0', print_values);
+	  mi_cmd_var_update_iter (var, *name == '0', print_values, compact);
 	});
     }
   else
@@ -662,15 +670,16 @@ mi_cmd_var_update (const char *command, char **argv, int argc)
       /* Get varobj handle, if a valid var obj name was specified.  */
       struct varobj *var = varobj_get_handle (name);
 
-      varobj_update_one (var, print_values, true /* explicit */);
+      varobj_update_one (var, print_values, compact, true /* explicit */);
     }
 }
 
-/* Helper for mi_cmd_var_update().  */
+/* Helper for mi_cmd_var_update().  If COMPACT is true, the fields
+   holding the values most varobjs have are omitted.  */
 
 static void
 varobj_update_one (struct varobj *var, enum print_values print_values,
-		   bool is_explicit)
+		   bool compact, bool is_explicit)
 {
   struct ui_out *uiout = current_uiout;
 
@@ -694,7 +703,8 @@ varobj_update_one (struct varobj *var, enum print_values print_values,
 
 	      uiout->field_string ("value", val);
 	    }
-	  uiout->field_string ("in_scope", "true");
+	  if (!compact)
+	    uiout->field_string ("in_scope", "true");
 	  break;
 	case VAROBJ_NOT_IN_SCOPE:
 	  uiout->field_string ("in_scope", "false");
@@ -708,7 +718,7 @@ varobj_update_one (struct varobj *var, enum print_values print_values,
 	{
 	  if (r.type_changed)
 	    uiout->field_string ("type_changed", "true");
-	  else
+	  else if (!compact)
 	    uiout->field_string ("type_changed", "false");
 	}
 
@@ -732,7 +742,9 @@ varobj_update_one (struct varobj *var, enum print_values print_values,
 	uiout->field_signed ("dynamic", 1);
 
       varobj_get_child_range (r.varobj, &from, &to);
-      uiout->field_signed ("has_more", varobj_has_more (r.varobj, to));
+      bool has_more = varobj_has_more (r.varobj, to);
+      if (has_more || !compact)
+	uiout->field_signed ("has_more", has_more);
 
       if (!r.newobj.empty ())
 	{
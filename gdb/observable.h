@@ -242,7 +242,9 @@ extern observable<user_selected_what /* selection */>
     user_selected_context_changed;
 
 /* This is notified when a styling setting has changed, content may need
-   to be updated based on the new settings.  */
+   to be updated based on the new settings.  It is also notified when
+   source code that was highlighted in the background becomes
+   available.  */
 extern observable<> styling_changed;
 
 /* The CLI's notion of the current source has changed.  This differs
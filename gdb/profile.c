@@ -0,0 +1,821 @@
+/* Sampling profiler for GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The "profile" command continues the program, samples the stacks of
+   its running threads at a fixed rate, and once the program stops,
+   writes the samples out, symbolized.
+
+   GDB takes each sample by stopping the running threads with
+   pause_threads, unwinding them with the usual unwinders, and
+   recording only the address of each frame.  Nothing is symbolized
+   until the end, when each distinct address is looked up once.  With
+   -frame-pointers, the target takes the samples on its own instead,
+   by following the chain of saved frame pointers of each thread.
+   That spares stopping the threads and the round trips to GDB, but
+   only gives whole stacks for code that keeps a frame pointer.  */
+
+#include "defs.h"
+#include "profile.h"
+#include "block.h"
+#include "cli/cli-option.h"
+#include "cli/cli-style.h"
+#include "command.h"
+#include "completer.h"
+#include "frame.h"
+#include "gdbcmd.h"
+#include "gdbthread.h"
+#include "inferior.h"
+#include "infrun.h"
+#include "minsyms.h"
+#include "objfiles.h"
+#include "observable.h"
+#include "progspace.h"
+#include "target.h"
+#include "gdbsupport/event-loop.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_tilde_expand.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+/* The highest sampling frequency, in samples per second, and the
+   deepest stack sampled, in frames.  gdbserver has the same
+   limits.  */
+
+#define PROFILE_MAX_FREQUENCY 1000
+#define PROFILE_MAX_DEPTH 1024
+
+/* The longest profiling run with "-duration", in seconds, so that it
+   fits the event loop's millisecond timers.  */
+
+#define PROFILE_MAX_DURATION (24 * 60 * 60)
+
+/* The output formats of "profile".  */
+
+static const char profile_format_collapsed[] = "collapsed";
+static const char profile_format_perf[] = "perf";
+
+static const char *const profile_format_enums[] = {
+  profile_format_collapsed,
+  profile_format_perf,
+  nullptr
+};
+
+/* The options of the "profile" command.  */
+
+struct profile_opts
+{
+  /* For "-frequency".  */
+  unsigned int frequency = 99;
+
+  /* For "-depth".  */
+  unsigned int depth = 64;
+
+  /* For "-duration", in seconds.  UINT_MAX means until the program
+     stops.  */
+  unsigned int duration = UINT_MAX;
+
+  /* For "-format".  */
+  const char *format = profile_format_collapsed;
+
+  /* For "-frame-pointers".  */
+  bool frame_pointers = false;
+};
+
+static const gdb::option::option_def profile_option_defs[] = {
+
+  gdb::option::uinteger_option_def<profile_opts> {
+    "frequency",
+    [] (profile_opts *opts) { return &opts->frequency; },
+    nullptr, /* show_cmd_cb */
+    N_("How many samples to take per second, up to 1000.  Default 99."),
+  },
+
+  gdb::option::uinteger_option_def<profile_opts> {
+    "depth",
+    [] (profile_opts *opts) { return &opts->depth; },
+    nullptr, /* show_cmd_cb */
+    N_("How many frames of each stack to sample, up to 1024.  Default 64."),
+  },
+
+  gdb::option::uinteger_option_def<profile_opts> {
+    "duration",
+    [] (profile_opts *opts) { return &opts->duration; },
+    nullptr, /* show_cmd_cb */
+    N_("How many seconds to profile for, up to 86400, after which the\n\
+program is stopped.  By default, profile until the program stops on\n\
+its own."),
+  },
+
+  gdb::option::enum_option_def<profile_opts> {
+    "format",
+    profile_format_enums,
+    [] (profile_opts *opts) { return &opts->format; },
+    nullptr, /* show_cmd_cb */
+    N_("The format of FILE.  \"collapsed\" gives each distinct stack, from\n\
+the outermost function in, followed by how many samples had it, as\n\
+flame graph tools expect.  \"perf\" gives each sample, in the format\n\
+of \"perf script\"."),
+  },
+
+  gdb::option::flag_option_def<profile_opts> {
+    "frame-pointers",
+    [] (profile_opts *opts) { return &opts->frame_pointers; },
+    N_("Have the target sample the stacks on its own, by following the\n\
+chain of saved frame pointers, rather than stop the threads so that GDB\n\
+can unwind them.  This is much cheaper, but only gives whole stacks\n\
+for code that keeps a frame pointer."),
+  },
+
+};
+
+/* Create an option_def_group for the "profile" options, with OPTS as
+   context.  */
+
+static inline gdb::option::option_def_group
+make_profile_options_def_group (profile_opts *opts)
+{
+  return {{profile_option_defs}, opts};
+}
+
+/* What a sampled address is shown as.  */
+
+struct profile_location
+{
+  /* The functions the address is in, the innermost inlined one
+     first.  */
+  std::vector<std::string> functions;
+
+  /* The address where the outermost of FUNCTIONS starts, or 0 if
+     unknown.  */
+  CORE_ADDR start = 0;
+
+  /* The name of the objfile the address is in.  */
+  std::string objfile;
+};
+
+/* Look up what to show PC as, in the current program space.  */
+
+static profile_location
+symbolize_profile_address (CORE_ADDR pc)
+{
+  profile_location loc;
+
+  for (const block *b = block_for_pc (pc); b != nullptr; b = b->superblock ())
+    {
+      if (b->function () == nullptr)
+	continue;
+
+      loc.functions.emplace_back (b->function ()->print_name ());
+      if (!block_inlined_p (b))
+	{
+	  loc.start = b->entry_pc ();
+	  break;
+	}
+    }
+
+  if (loc.functions.empty ())
+    {
+      bound_minimal_symbol msymbol = lookup_minimal_symbol_by_pc (pc);
+
+      if (msymbol.minsym != nullptr)
+	{
+	  loc.functions.emplace_back (msymbol.minsym->print_name ());
+	  loc.start = msymbol.value_address ();
+	}
+    }
+
+  struct obj_section *section = find_pc_section (pc);
+
+  if (section != nullptr)
+    loc.objfile = objfile_name (section->objfile);
+  else
+    loc.objfile = "[unknown]";
+
+  /* Code with no symbols at all is at least attributed to its
+     objfile.  */
+  if (loc.functions.empty ())
+    {
+      if (section != nullptr)
+	loc.functions.push_back (string_printf ("[%s]",
+						lbasename (loc.objfile.c_str ())));
+      else
+	loc.functions.emplace_back ("[unknown]");
+    }
+
+  return loc;
+}
+
+/* A run of the "profile" command.  */
+
+class profiler
+{
+public:
+  profiler (inferior *inf, const profile_opts &opts,
+	    std::string &&filename, gdb_file_up &&file)
+    : m_inf (inf), m_opts (opts), m_filename (std::move (filename)),
+      m_file (std::move (file))
+  {}
+
+  ~profiler ();
+
+  DISABLE_COPY_AND_ASSIGN (profiler);
+
+  /* Start sampling the threads of the inferior, which the caller then
+     sets running.  */
+  void start ();
+
+  /* Stop sampling, and write out the samples taken.  */
+  void finish ();
+
+  /* The inferior being profiled.  */
+  inferior *inf () const
+  { return m_inf; }
+
+private:
+  /* Sample the running threads, if the period is up.  */
+  void take_samples ();
+
+  /* Return a sample of the current thread, taken at TIME.  */
+  profile_sample sample_current_thread (ULONGEST time);
+
+  /* Arm the timer for the next sample.  */
+  void schedule_sample ();
+
+  /* Stop the program, which ends profiling.  */
+  void stop_program ();
+
+  /* Write out the samples, in either format.  */
+  void write_collapsed ();
+  void write_perf ();
+
+  /* Return the symbolized location of PC.  */
+  const profile_location &location (CORE_ADDR pc);
+
+  /* Return the command name of the thread PTID, for the perf
+     format.  */
+  const std::string &thread_command (ptid_t ptid);
+
+  static void sample_timer_handler (gdb_client_data client_data);
+  static void duration_timer_handler (gdb_client_data client_data);
+
+  inferior *m_inf;
+  profile_opts m_opts;
+  std::string m_filename;
+  gdb_file_up m_file;
+
+  /* Whether the target takes the samples.  */
+  bool m_target_sampling = false;
+
+  /* The timers that take the next sample and stop the program, or
+     -1.  */
+  int m_sample_timer = -1;
+  int m_duration_timer = -1;
+
+  /* When profiling started, and when the next sample is due.  */
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_next;
+
+  /* The samples taken so far, by GDB.  */
+  std::vector<profile_sample> m_samples;
+
+  /* The locations of the addresses sampled, and the command names of
+     the threads, looked up as the samples are written out.  */
+  std::unordered_map<CORE_ADDR, profile_location> m_locations;
+  std::unordered_map<ptid_t, std::string, hash_ptid> m_thread_commands;
+};
+
+/* The current run of "profile", if any.  */
+
+static std::unique_ptr<profiler> current_profiler;
+
+profiler::~profiler ()
+{
+  if (m_sample_timer != -1)
+    delete_timer (m_sample_timer);
+  if (m_duration_timer != -1)
+    delete_timer (m_duration_timer);
+}
+
+void
+profiler::start ()
+{
+  if (m_opts.frame_pointers)
+    {
+      if (!target_start_profiling (m_opts.frequency, m_opts.depth))
+	error (_("The target can not sample stacks by following "
+		 "frame pointers."));
+      m_target_sampling = true;
+    }
+
+  m_start = m_next = std::chrono::steady_clock::now ();
+
+  if (!m_target_sampling)
+    schedule_sample ();
+
+  if (m_opts.duration != UINT_MAX)
+    m_duration_timer = create_timer (m_opts.duration * 1000,
+				     duration_timer_handler, this);
+}
+
+void
+profiler::schedule_sample ()
+{
+  using namespace std::chrono;
+
+  microseconds period (1000000 / m_opts.frequency);
+  steady_clock::time_point now = steady_clock::now ();
+
+  m_next += period;
+
+  /* If sampling takes longer than the period, skip the samples that
+     are overdue rather than take them in a burst.  */
+  if (m_next < now)
+    m_next += ((now - m_next) / period + 1) * period;
+
+  microseconds delay = duration_cast<microseconds> (m_next - now);
+  m_sample_timer = create_timer ((delay.count () + 999) / 1000,
+				 sample_timer_handler, this);
+}
+
+void
+profiler::sample_timer_handler (gdb_client_data client_data)
+{
+  profiler *self = (profiler *) client_data;
+
+  self->m_sample_timer = -1;
+
+  try
+    {
+      self->take_samples ();
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      exception_print (gdb_stderr, ex);
+    }
+
+  self->schedule_sample ();
+}
+
+void
+profiler::duration_timer_handler (gdb_client_data client_data)
+{
+  profiler *self = (profiler *) client_data;
+
+  self->m_duration_timer = -1;
+
+  try
+    {
+      self->stop_program ();
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      exception_print (gdb_stderr, ex);
+    }
+}
+
+void
+profiler::take_samples ()
+{
+  bool running = false;
+
+  for (thread_info *tp : m_inf->non_exited_threads ())
+    if (tp->state == THREAD_RUNNING)
+      {
+	running = true;
+	break;
+      }
+
+  if (!running)
+    return;
+
+  ULONGEST time = (std::chrono::duration_cast<std::chrono::microseconds>
+		   (std::chrono::steady_clock::now () - m_start)).count ();
+
+  pause_threads (m_inf, [&] ()
+    {
+      for (thread_info *tp : m_inf->non_exited_threads ())
+	{
+	  /* Threads the user keeps stopped aren't running the
+	     program.  */
+	  if (tp->state != THREAD_RUNNING)
+	    continue;
+
+	  switch_to_thread (tp);
+	  m_samples.push_back (sample_current_thread (time));
+	}
+    });
+}
+
+profile_sample
+profiler::sample_current_thread (ULONGEST time)
+{
+  profile_sample sample;
+
+  sample.ptid = inferior_ptid;
+  sample.time = time;
+
+  try
+    {
+      for (frame_info *frame = get_current_frame ();
+	   frame != nullptr && sample.pcs.size () < m_opts.depth;
+	   frame = get_prev_frame (frame))
+	{
+	  /* The functions inlined in a frame are found again from the
+	     address of the frame, when symbolizing.  */
+	  if (get_frame_type (frame) == INLINE_FRAME)
+	    continue;
+
+	  sample.pcs.push_back (get_frame_address_in_block (frame));
+	}
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Keep the frames that could be unwound.  */
+    }
+
+  return sample;
+}
+
+void
+profiler::stop_program ()
+{
+  /* Don't sample while the threads are being stopped: pausing them
+     would take their stops and resume them again.  */
+  if (m_sample_timer != -1)
+    {
+      delete_timer (m_sample_timer);
+      m_sample_timer = -1;
+    }
+
+  scoped_restore_current_thread restore_thread;
+  scoped_disable_commit_resumed disable_commit_resumed ("profile -duration");
+  ptid_t ptid (m_inf->pid);
+
+  switch_to_inferior_no_thread (m_inf);
+
+  /* As with "interrupt" in non-stop mode, the threads report a
+     GDB_SIGNAL_0 stop, rather than the SIGINT a Ctrl-C would
+     cause.  */
+  set_stop_requested (m_inf->process_target (), ptid, true);
+  target_stop (ptid);
+}
+
+const profile_location &
+profiler::location (CORE_ADDR pc)
+{
+  auto it = m_locations.find (pc);
+
+  if (it == m_locations.end ())
+    it = m_locations.emplace (pc, symbolize_profile_address (pc)).first;
+
+  return it->second;
+}
+
+const std::string &
+profiler::thread_command (ptid_t ptid)
+{
+  auto it = m_thread_commands.find (ptid);
+
+  if (it != m_thread_commands.end ())
+    return it->second;
+
+  const char *name = nullptr;
+  thread_info *tp = find_thread_ptid (m_inf, ptid);
+
+  if (tp != nullptr)
+    {
+      try
+	{
+	  name = thread_name (tp);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	}
+    }
+
+  if (name == nullptr && m_inf->pspace->exec_filename != nullptr)
+    name = lbasename (m_inf->pspace->exec_filename.get ());
+
+  if (name == nullptr)
+    name = "[unknown]";
+
+  return m_thread_commands.emplace (ptid, name).first->second;
+}
+
+void
+profiler::write_collapsed ()
+{
+  std::map<std::string, ULONGEST> stacks;
+
+  for (const profile_sample &sample : m_samples)
+    {
+      if (sample.pcs.empty ())
+	continue;
+
+      std::string stack;
+
+      for (auto pc = sample.pcs.rbegin (); pc != sample.pcs.rend (); ++pc)
+	{
+	  const profile_location &loc = location (*pc);
+
+	  for (auto f = loc.functions.rbegin ();
+	       f != loc.functions.rend ();
+	       ++f)
+	    {
+	      if (!stack.empty ())
+		stack += ';';
+	      stack += *f;
+	    }
+	}
+
+      stacks[stack]++;
+    }
+
+  for (const auto &stack : stacks)
+    fprintf (m_file.get (), "%s %s\n", stack.first.c_str (),
+	     pulongest (stack.second));
+}
+
+void
+profiler::write_perf ()
+{
+  for (const profile_sample &sample : m_samples)
+    {
+      long tid = sample.ptid.lwp ();
+
+      if (tid == 0)
+	tid = sample.ptid.tid ();
+      if (tid == 0)
+	tid = sample.ptid.pid ();
+
+      fprintf (m_file.get (), "%s %d/%ld %s.%06u: 1 cpu-clock:\n",
+	       thread_command (sample.ptid).c_str (), sample.ptid.pid (), tid,
+	       pulongest (sample.time / 1000000),
+	       (unsigned) (sample.time % 1000000));
+
+      for (CORE_ADDR pc : sample.pcs)
+	{
+	  const profile_location &loc = location (pc);
+	  const char *addr = phex_nz (pc, sizeof (pc));
+
+	  for (size_t i = 0; i < loc.functions.size (); i++)
+	    {
+	      const std::string &function = loc.functions[i];
+
+	      /* The functions inlined at PC don't start before it.  */
+	      if (i + 1 < loc.functions.size () || loc.start == 0)
+		fprintf (m_file.get (), "\t%16s %s (%s)\n", addr,
+			 function.c_str (), loc.objfile.c_str ());
+	      else
+		fprintf (m_file.get (), "\t%16s %s+0x%s (%s)\n", addr,
+			 function.c_str (), phex_nz (pc - loc.start, 0),
+			 loc.objfile.c_str ());
+	    }
+	}
+
+      fputc ('\n', m_file.get ());
+    }
+}
+
+void
+profiler::finish ()
+{
+  if (m_sample_timer != -1)
+    {
+      delete_timer (m_sample_timer);
+      m_sample_timer = -1;
+    }
+  if (m_duration_timer != -1)
+    {
+      delete_timer (m_duration_timer);
+      m_duration_timer = -1;
+    }
+
+  scoped_restore_current_thread restore_thread;
+
+  switch_to_inferior_no_thread (m_inf);
+
+  if (m_target_sampling)
+    {
+      try
+	{
+	  m_samples = target_stop_profiling ();
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  exception_fprintf (gdb_stderr, ex,
+			     _("Could not read the samples "
+			       "taken by the target: "));
+	}
+    }
+
+  if (m_opts.format == profile_format_perf)
+    write_perf ();
+  else
+    write_collapsed ();
+
+  if (fclose (m_file.release ()) != 0)
+    perror_with_name (m_filename.c_str ());
+
+  gdb_printf (_("Wrote %s samples to \"%ps\".\n"),
+	      pulongest (m_samples.size ()),
+	      styled_string (file_name_style.style (), m_filename.c_str ()));
+}
+
+/* Write out the samples of the current run of "profile", if any,
+   because the program stopped or went away.  */
+
+static void
+finish_profiling ()
+{
+  std::unique_ptr<profiler> p = std::move (current_profiler);
+
+  try
+    {
+      p->finish ();
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      exception_print (gdb_stderr, ex);
+    }
+}
+
+/* Observer for the normal_stop notification.  Profiling ends when a
+   thread of the profiled inferior stops, or when the inferior has no
+   thread left running, as after an all-stop stop of some other
+   inferior.  Stops of other inferiors in non-stop mode are
+   ignored.  */
+
+static void
+profile_normal_stop (struct bpstat *bs, int print_frame)
+{
+  if (current_profiler == nullptr)
+    return;
+
+  inferior *inf = current_profiler->inf ();
+
+  if (inferior_ptid != null_ptid && current_inferior () == inf)
+    {
+      finish_profiling ();
+      return;
+    }
+
+  for (thread_info *tp : inf->non_exited_threads ())
+    if (tp->executing ())
+      return;
+
+  finish_profiling ();
+}
+
+/* Observer for the inferior_exit notification.  */
+
+static void
+profile_inferior_exit (struct inferior *inf)
+{
+  if (current_profiler != nullptr && current_profiler->inf () == inf)
+    finish_profiling ();
+}
+
+/* The "profile" command.  */
+
+static void
+profile_command (const char *args, int from_tty)
+{
+  int async_exec;
+  profile_opts opts;
+
+  gdb::unique_xmalloc_ptr<char> stripped = strip_bg_char (args, &async_exec);
+  args = stripped.get ();
+
+  auto grp = make_profile_options_def_group (&opts);
+  gdb::option::process_options
+    (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, grp);
+
+  if (args == nullptr || *args == '\0')
+    error (_("Missing output file name."));
+  if (opts.frequency == 0 || opts.frequency > PROFILE_MAX_FREQUENCY)
+    error (_("The sampling frequency must be between 1 and %d."),
+	   PROFILE_MAX_FREQUENCY);
+  if (opts.depth == 0 || opts.depth > PROFILE_MAX_DEPTH)
+    error (_("The sampling depth must be between 1 and %d."),
+	   PROFILE_MAX_DEPTH);
+  if (opts.duration != UINT_MAX && opts.duration > PROFILE_MAX_DURATION)
+    error (_("The profiling duration must be between 1 and %d seconds."),
+	   PROFILE_MAX_DURATION);
+
+  if (current_profiler != nullptr)
+    error (_("The program is already being profiled."));
+
+  if (!target_has_execution ())
+    error (_("The program is not being run."));
+
+  if (!target_is_non_stop_p ())
+    error (_("Profiling requires a target that can stop threads "
+	     "individually.\nTry \"maintenance set target-non-stop on\" "
+	     "before starting or connecting to the program."));
+
+  std::string filename = gdb_tilde_expand (args);
+  gdb_file_up file = gdb_fopen_cloexec (filename, "w");
+  if (file == nullptr)
+    perror_with_name (filename.c_str ());
+
+  /* Don't leave an empty file behind if profiling can't start.  */
+  gdb::unlinker unlink_file (filename.c_str ());
+
+  std::unique_ptr<profiler> p
+    (new profiler (current_inferior (), opts, std::string (filename),
+		   std::move (file)));
+
+  p->start ();
+
+  prepare_execution_command (current_inferior ()->top_target (), async_exec);
+
+  if (from_tty)
+    gdb_printf (_("Continuing, taking %u samples per second.\n"),
+		opts.frequency);
+
+  current_profiler = std::move (p);
+
+  try
+    {
+      continue_1 (0);
+    }
+  catch (const gdb_exception &ex)
+    {
+      p = std::move (current_profiler);
+
+      if (p != nullptr && opts.frame_pointers)
+	{
+	  try
+	    {
+	      target_stop_profiling ();
+	    }
+	  catch (const gdb_exception_error &stop_ex)
+	    {
+	    }
+	}
+
+      throw;
+    }
+
+  unlink_file.keep ();
+}
+
+/* Completer for the "profile" command.  */
+
+static void
+profile_command_completer (struct cmd_list_element *ignore,
+			   completion_tracker &tracker,
+			   const char *text, const char *word)
+{
+  const auto grp = make_profile_options_def_group (nullptr);
+
+  if (gdb::option::complete_options
+      (tracker, &text, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, grp))
+    return;
+
+  word = advance_to_filename_complete_word_point (tracker, text);
+  filename_completer (ignore, tracker, text, word);
+}
+
+void _initialize_profile ();
+void
+_initialize_profile ()
+{
+  const auto profile_opts = make_profile_options_def_group (nullptr);
+
+  static std::string profile_help
+    = gdb::option::build_help (_("\
+Continue the program, sampling the stacks of its threads.\n\
+Usage: profile [OPTION]... FILE\n\
+Samples are taken until the program stops, and then written to FILE.\n\
+\n\
+Options:\n\
+%OPTIONS%"),
+			       profile_opts);
+
+  cmd_list_element *c = add_com ("profile", class_run, profile_command,
+				 profile_help.c_str ());
+  set_cmd_completer_handle_brkchars (c, profile_command_completer);
+
+  gdb::observers::normal_stop.attach (profile_normal_stop, "profile");
+  gdb::observers::inferior_exit.attach (profile_inferior_exit, "profile");
+}
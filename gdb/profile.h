@@ -0,0 +1,44 @@
+/* Sampling profiler for GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "gdbsupport/ptid.h"
+
+/* A sample of the stack of a thread, taken by the "profile"
+   command.  */
+
+struct profile_sample
+{
+  /* The thread sampled.  */
+  ptid_t ptid;
+
+  /* When the sample was taken, in microseconds since profiling
+     started.  */
+  ULONGEST time;
+
+  /* An address in the code each frame was executing, from the
+     innermost frame out.  For the frames that called another, this
+     is the address of the call rather than the return address, so
+     that it lies in the same function and line.  */
+  std::vector<CORE_ADDR> pcs;
+};
+
+#endif /* PROFILE_H */
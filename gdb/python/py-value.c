@@ -23,6 +23,7 @@
 #include "language.h"
 #include "target-float.h"
 #include "valprint.h"
+#include "typeprint.h"
 #include "infcall.h"
 #include "expression.h"
 #include "cp-abi.h"
@@ -1239,6 +1240,192 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Helper for valpy_unpack.  Convert the object of type TYPE found
+   BIT_OFFSET bits into the contents of VALUE to Python objects.  If
+   BITSIZE is not zero, the object is a bitfield of that many bits.
+   Returns NULL with a Python exception set on failure.  */
+
+static gdbpy_ref<>
+unpack_value_contents (struct value *value, struct type *type,
+		       LONGEST bit_offset, LONGEST bitsize)
+{
+  type = check_typedef (type);
+
+  switch (type->code ())
+    {
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      {
+	gdbpy_ref<> dict (PyDict_New ());
+	if (dict == nullptr)
+	  return nullptr;
+
+	for (int i = 0; i < type->num_fields (); ++i)
+	  {
+	    if (field_is_static (&type->field (i)))
+	      continue;
+
+	    if (BASETYPE_VIA_VIRTUAL (type, i))
+	      {
+		PyErr_SetString (PyExc_TypeError,
+				 _("Cannot unpack virtual base classes."));
+		return nullptr;
+	      }
+
+	    struct type *field_type = type->field (i).type ();
+	    gdbpy_ref<> item
+	      = unpack_value_contents (value, field_type,
+				       bit_offset + type->field (i).loc_bitpos (),
+				       TYPE_FIELD_BITSIZE (type, i));
+	    if (item == nullptr)
+	      return nullptr;
+
+	    /* The members of anonymous structs and unions are accessed
+	       as if they were members of the enclosing object.  */
+	    const char *name = type->field (i).name ();
+	    if (name == nullptr || *name == '\0')
+	      {
+		if (PyDict_Check (item.get ()))
+		  {
+		    if (PyDict_Update (dict.get (), item.get ()) < 0)
+		      return nullptr;
+		  }
+		continue;
+	      }
+
+	    if (PyDict_SetItemString (dict.get (), name, item.get ()) < 0)
+	      return nullptr;
+	  }
+
+	return dict;
+      }
+
+    case TYPE_CODE_ARRAY:
+      {
+	LONGEST low, high;
+
+	if (type->is_vector () || !get_array_bounds (type, &low, &high))
+	  break;
+
+	struct type *elt_type = TYPE_TARGET_TYPE (type);
+	LONGEST elt_bitsize = TYPE_LENGTH (check_typedef (elt_type)) * 8;
+	LONGEST stride = type->bit_stride ();
+	if (stride == 0)
+	  stride = elt_bitsize;
+
+	LONGEST count = high >= low ? high - low + 1 : 0;
+	gdbpy_ref<> list (PyList_New (count));
+	if (list == nullptr)
+	  return nullptr;
+
+	for (LONGEST i = 0; i < count; ++i)
+	  {
+	    gdbpy_ref<> item
+	      = unpack_value_contents (value, elt_type,
+				       bit_offset + i * stride,
+				       stride != elt_bitsize ? stride : 0);
+	    if (item == nullptr)
+	      return nullptr;
+	    PyList_SET_ITEM (list.get (), i, item.release ());
+	  }
+
+	return list;
+      }
+
+    case TYPE_CODE_INT:
+    case TYPE_CODE_CHAR:
+    case TYPE_CODE_ENUM:
+    case TYPE_CODE_FLAGS:
+    case TYPE_CODE_BOOL:
+    case TYPE_CODE_RANGE:
+    case TYPE_CODE_PTR:
+    case TYPE_CODE_REF:
+    case TYPE_CODE_RVALUE_REF:
+    case TYPE_CODE_MEMBERPTR:
+    case TYPE_CODE_FLT:
+    case TYPE_CODE_COMPLEX:
+      {
+	LONGEST length = (bitsize != 0
+			  ? bitsize
+			  : TYPE_LENGTH (type) * TARGET_CHAR_BIT);
+
+	if (value_bits_any_optimized_out (value, bit_offset, length)
+	    || !value_bits_available (value, bit_offset, length))
+	  return gdbpy_ref<>::new_reference (Py_None);
+
+	const gdb_byte *valaddr
+	  = value_contents_for_printing (value).data ();
+
+	if (type->code () == TYPE_CODE_FLT)
+	  return gdbpy_ref<> (PyFloat_FromDouble
+			      (target_float_to_host_double
+			       (valaddr + bit_offset / TARGET_CHAR_BIT, type)));
+
+	if (type->code () == TYPE_CODE_COMPLEX)
+	  {
+	    struct type *part_type = check_typedef (TYPE_TARGET_TYPE (type));
+	    const gdb_byte *real = valaddr + bit_offset / TARGET_CHAR_BIT;
+	    const gdb_byte *imag = real + TYPE_LENGTH (part_type);
+
+	    if (part_type->code () != TYPE_CODE_FLT)
+	      break;
+	    return gdbpy_ref<> (PyComplex_FromDoubles
+				(target_float_to_host_double (real, part_type),
+				 target_float_to_host_double (imag,
+							      part_type)));
+	  }
+
+	LONGEST l;
+	if (bitsize != 0)
+	  l = unpack_bits_as_long (type, valaddr, bit_offset, bitsize);
+	else
+	  l = unpack_long (type, valaddr + bit_offset / TARGET_CHAR_BIT);
+
+	if (type->code () == TYPE_CODE_BOOL)
+	  return gdbpy_ref<> (PyBool_FromLong (l != 0));
+	if (type->is_unsigned ())
+	  return gdb_py_object_from_ulongest (l);
+	return gdb_py_object_from_longest (l);
+      }
+
+    default:
+      break;
+    }
+
+  PyErr_Format (PyExc_TypeError, _("Cannot unpack a value of type %s."),
+		type_to_string (type).c_str ());
+  return nullptr;
+}
+
+/* Implements gdb.Value.unpack ().  */
+static PyObject *
+valpy_unpack (PyObject *self, PyObject *args)
+{
+  struct value *value = ((value_object *) self)->value;
+  gdbpy_ref<> result;
+
+  try
+    {
+      scoped_value_mark free_values;
+
+      value = coerce_ref (value);
+      if (value_lazy (value))
+	value_fetch_lazy (value);
+
+      /* A bitfield value already holds the extracted bits.  */
+      result = unpack_value_contents (value, value_type (value),
+				      (value_embedded_offset (value)
+				       * TARGET_CHAR_BIT),
+				      0);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  return result.release ();
+}
+
 /* Calculate and return the address of the PyObject as the value of
    the builtin __hash__ call.  */
 static Py_hash_t
@@ -2119,6 +2306,10 @@ Return Unicode string representation of the value." },
     "format_string (...) -> string\n\
 Return a string representation of the value using the specified\n\
 formatting options" },
+  { "unpack", valpy_unpack, METH_NOARGS,
+    "unpack () -> object\n\
+Return the contents of the value as Python integers, floats, lists\n\
+and dictionaries." },
   {NULL}  /* Sentinel */
 };
 
@@ -1069,6 +1069,10 @@ record_full_target::resume (ptid_t ptid, int step, enum gdb_signal signal)
 
       record_full_message (get_current_regcache (), signal);
 
+      /* We record one instruction per stop, so the target beneath
+	 must report every step.  */
+      inferior_thread ()->control.may_range_step = 0;
+
       if (!step)
 	{
 	  /* This is not hard single step.  */
@@ -80,6 +80,7 @@
 #include <unordered_map>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -252,6 +253,13 @@ class remote_state
      about the remote side's threads, relocating symbols, etc.).  */
   bool starting_up = false;
 
+  /* The expedited registers of all stopped threads, as last read with
+     qXfer:expedited-registers:read, indexed by thread.  Each value is
+     the "N:VALUE;N:VALUE;..." part of the thread's line.  Reset
+     whenever threads resume or stop, or the thread list changes.  */
+  gdb::optional<std::unordered_map<ptid_t, std::string, hash_ptid>>
+    expedited_registers;
+
   /* If we negotiated packet size explicitly (and thus can bypass
      heuristics for the largest packet size that will not overflow
      a buffer in the stub), this will be set to that packet size.
@@ -314,6 +322,11 @@ class remote_state
      the target know about program signals list changes.  */
   char *last_program_signals_packet = nullptr;
 
+  /* True if the last QSoftwareWatchpoints packet we sent asked the
+     target to check some software watchpoints.  We only need to tell
+     the target when there are none left in that case.  */
+  bool software_watchpoints_set = false;
+
   gdb_signal last_sent_signal = GDB_SIGNAL_0;
 
   bool last_sent_step = false;
@@ -555,6 +568,8 @@ class remote_target : public process_stratum_target
 
   bool supports_disable_randomization () override;
 
+  bool supports_range_stepping () override;
+
   bool filesystem_is_local () override;
 
 
@@ -589,6 +604,9 @@ class remote_target : public process_stratum_target
 
   bool can_run_breakpoint_commands () override;
 
+  bool set_software_watchpoints (gdb::array_view<const agent_expr_up> exprs)
+    override;
+
   void trace_init () override;
 
   void download_tracepoint (struct bp_location *location) override;
@@ -625,6 +643,8 @@ class remote_target : public process_stratum_target
 
   LONGEST get_raw_trace_data (gdb_byte *buf, ULONGEST offset, LONGEST len) override;
 
+  bool get_trace_buffer (trace_buffer_ftype func) override;
+
   int get_min_fast_tracepoint_insn_len () override;
 
   void set_disconnected_tracing (int val) override;
@@ -658,6 +678,9 @@ class remote_target : public process_stratum_target
   bool use_agent (bool use) override;
   bool can_use_agent () override;
 
+  bool start_profiling (int frequency, int depth) override;
+  std::vector<profile_sample> stop_profiling () override;
+
   struct btrace_target_info *
     enable_btrace (thread_info *tp, const struct btrace_config *conf) override;
 
@@ -852,6 +875,8 @@ class remote_target : public process_stratum_target
   int send_g_packet ();
   void process_g_packet (struct regcache *regcache);
   void fetch_registers_using_g (struct regcache *regcache);
+  void fetch_expedited_registers ();
+  void supply_expedited_registers (struct regcache *regcache);
   int store_register_using_P (const struct regcache *regcache,
 			      packet_reg *reg);
   void store_registers_using_G (const struct regcache *regcache);
@@ -944,8 +969,6 @@ class remote_target : public process_stratum_target
 
   void push_stop_reply (struct stop_reply *new_event);
 
-  bool vcont_r_supported ();
-
 private:
 
   bool start_remote_1 (int from_tty, int extended_p);
@@ -1089,10 +1112,6 @@ static struct cmd_list_element *remote_cmdlist;
 static struct cmd_list_element *remote_set_cmdlist;
 static struct cmd_list_element *remote_show_cmdlist;
 
-/* Controls whether GDB is willing to use range stepping.  */
-
-static bool use_range_stepping = true;
-
 /* From the remote target's point of view, each thread is in one of these three
    states.  */
 enum class resume_state
@@ -2096,8 +2115,11 @@ enum {
   PACKET_qXfer_memory_map,
   PACKET_qXfer_osdata,
   PACKET_qXfer_threads,
+  PACKET_qXfer_expedited_registers,
   PACKET_qXfer_statictrace_read,
   PACKET_qXfer_traceframe_info,
+  PACKET_qXfer_trace_buffer,
+  PACKET_qXfer_profile,
   PACKET_qXfer_uib,
   PACKET_qGetTIBAddr,
   PACKET_qGetTLSAddr,
@@ -2105,6 +2127,7 @@ enum {
   PACKET_qTStatus,
   PACKET_QPassSignals,
   PACKET_QCatchSyscalls,
+  PACKET_QSoftwareWatchpoints,
   PACKET_QProgramSignals,
   PACKET_QSetWorkingDir,
   PACKET_QStartupWithShell,
@@ -2147,6 +2170,7 @@ enum {
   PACKET_qXfer_fdpic,
   PACKET_QDisableRandomization,
   PACKET_QAgent,
+  PACKET_QProfile,
   PACKET_QTBuffer_size,
   PACKET_Qbtrace_off,
   PACKET_Qbtrace_bts,
@@ -2169,6 +2193,9 @@ enum {
   /* Support for collecting strings using the tracenz bytecode.  */
   PACKET_tracenz_feature,
 
+  /* Support for the "zlib" annex of qXfer:trace-buffer:read.  */
+  PACKET_TraceBufferZlib,
+
   /* Support for continuing to run a trace experiment while GDB is
      disconnected.  */
   PACKET_DisconnectedTracing_feature,
@@ -2563,6 +2590,8 @@ remote_target::remote_add_thread (ptid_t ptid, bool running, bool executing,
   struct remote_state *rs = get_remote_state ();
   struct thread_info *thread;
 
+  rs->expedited_registers.reset ();
+
   /* GDB historically didn't pull threads in the initial connection
      setup.  If the remote target doesn't even have a concept of
      threads (e.g., a bare-metal target), even if internally we
@@ -2830,6 +2859,51 @@ remote_target::set_syscall_catchpoint (int pid, bool needed, int any_count,
     return -1;
 }
 
+/* If 'QSoftwareWatchpoints' is supported, ask the remote stub to
+   single-step the current inferior itself, and to only report a stop
+   when the value of one of EXPRS changes.  */
+
+bool
+remote_target::set_software_watchpoints
+  (gdb::array_view<const agent_expr_up> exprs)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (packet_support (PACKET_QSoftwareWatchpoints) == PACKET_DISABLE)
+    return false;
+
+  std::string packet = "QSoftwareWatchpoints:1";
+  for (const agent_expr_up &aexpr : exprs)
+    {
+      string_appendf (packet, ";X%x,", aexpr->len);
+      packet += bin2hex (aexpr->buf, aexpr->len);
+    }
+
+  /* If the expressions don't fit in a packet, GDB has to single-step
+     and check the values itself.  */
+  bool enable = (!exprs.empty ()
+		 && packet.size () <= get_remote_packet_size ());
+  if (!enable)
+    {
+      if (!rs->software_watchpoints_set)
+	return false;
+      packet = "QSoftwareWatchpoints:0";
+    }
+
+  set_general_process ();
+  putpkt (packet.c_str ());
+  getpkt (&rs->buf, 0);
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_QSoftwareWatchpoints])
+      != PACKET_OK)
+    {
+      rs->software_watchpoints_set = false;
+      return false;
+    }
+
+  rs->software_watchpoints_set = enable;
+  return enable;
+}
+
 /* If 'QProgramSignals' is supported, tell the remote stub what
    signals it should pass through to the inferior when detaching.  */
 
@@ -3935,6 +4009,8 @@ remote_target::update_thread_list ()
   struct threads_listing_context context;
   int got_list = 0;
 
+  get_remote_state ()->expedited_registers.reset ();
+
   /* We have a few different mechanisms to fetch the thread list.  Try
      them all, starting with the most preferred one first, falling
      back to older methods.  */
@@ -5326,12 +5402,20 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_qXfer_osdata },
   { "qXfer:threads:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_threads },
+  { "qXfer:expedited-registers:read", PACKET_DISABLE,
+    remote_supported_packet, PACKET_qXfer_expedited_registers },
   { "qXfer:traceframe-info:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_traceframe_info },
+  { "qXfer:trace-buffer:read", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qXfer_trace_buffer },
+  { "qXfer:profile:read", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qXfer_profile },
   { "QPassSignals", PACKET_DISABLE, remote_supported_packet,
     PACKET_QPassSignals },
   { "QCatchSyscalls", PACKET_DISABLE, remote_supported_packet,
     PACKET_QCatchSyscalls },
+  { "QSoftwareWatchpoints", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QSoftwareWatchpoints },
   { "QProgramSignals", PACKET_DISABLE, remote_supported_packet,
     PACKET_QProgramSignals },
   { "QSetWorkingDir", PACKET_DISABLE, remote_supported_packet,
@@ -5384,9 +5468,12 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "QDisableRandomization", PACKET_DISABLE, remote_supported_packet,
     PACKET_QDisableRandomization },
   { "QAgent", PACKET_DISABLE, remote_supported_packet, PACKET_QAgent},
+  { "QProfile", PACKET_DISABLE, remote_supported_packet, PACKET_QProfile },
   { "QTBuffer:size", PACKET_DISABLE,
     remote_supported_packet, PACKET_QTBuffer_size},
   { "tracenz", PACKET_DISABLE, remote_supported_packet, PACKET_tracenz_feature },
+  { "TraceBufferZlib", PACKET_DISABLE, remote_supported_packet,
+    PACKET_TraceBufferZlib },
   { "Qbtrace:off", PACKET_DISABLE, remote_supported_packet, PACKET_Qbtrace_off },
   { "Qbtrace:bts", PACKET_DISABLE, remote_supported_packet, PACKET_Qbtrace_bts },
   { "Qbtrace:pt", PACKET_DISABLE, remote_supported_packet, PACKET_Qbtrace_pt },
@@ -6523,6 +6610,8 @@ remote_target::resume (ptid_t scope_ptid, int step, enum gdb_signal siggnal)
 {
   struct remote_state *rs = get_remote_state ();
 
+  rs->expedited_registers.reset ();
+
   /* When connected in non-stop mode, the core resumes threads
      individually.  Resuming remote threads directly in target_resume
      would thus result in sending one packet per thread.  Instead, to
@@ -8043,6 +8132,10 @@ remote_target::process_stop_reply (struct stop_reply *stop_reply,
   *status = stop_reply->ws;
   ptid_t ptid = stop_reply->ptid;
 
+  /* Some threads ran, so the expedited registers we may have fetched
+     for them are stale.  */
+  get_remote_state ()->expedited_registers.reset ();
+
   /* If no thread/process was reported by the stub then select a suitable
      thread/process.  */
   if (ptid == null_ptid)
@@ -8563,6 +8656,85 @@ remote_target::fetch_registers_using_g (struct regcache *regcache)
   process_g_packet (regcache);
 }
 
+/* Fetch the expedited registers (usually the PC, stack pointer and
+   frame pointer) of all the stopped threads with a single
+   qXfer:expedited-registers:read request, and record them in the
+   remote state, to be supplied to the threads' register caches by
+   supply_expedited_registers.  */
+
+void
+remote_target::fetch_expedited_registers ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  rs->expedited_registers.emplace ();
+
+  gdb::optional<gdb::char_vector> text
+    = target_read_stralloc (this, TARGET_OBJECT_EXPEDITED_REGISTERS, NULL);
+  if (!text)
+    return;
+
+  /* The reply has one line per thread, each of the form
+     "THREAD-ID;N:VALUE;N:VALUE;...".  */
+  const char *p = text->data ();
+  while (*p != '\0')
+    {
+      const char *eol = strchrnul (p, '\n');
+      ptid_t ptid = read_ptid (p, &p);
+
+      if (*p == ';')
+	p++;
+      if (p < eol)
+	(*rs->expedited_registers)[ptid] = std::string (p, eol);
+
+      p = *eol == '\n' ? eol + 1 : eol;
+    }
+}
+
+/* Supply the expedited registers of REGCACHE's thread recorded by
+   fetch_expedited_registers to REGCACHE.  Registers already in
+   REGCACHE are left alone.  This is what's needed to start unwinding
+   the stack of the thread, so e.g. "thread apply all bt" doesn't need
+   to select each thread with Hg and fetch its whole register set.  */
+
+void
+remote_target::supply_expedited_registers (struct regcache *regcache)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  auto it = rs->expedited_registers->find (regcache->ptid ());
+  if (it == rs->expedited_registers->end ())
+    return;
+
+  struct gdbarch *gdbarch = regcache->arch ();
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+  const char *p = it->second.c_str ();
+
+  while (*p != '\0')
+    {
+      ULONGEST pnum;
+      const char *p1 = unpack_varlen_hex (p, &pnum);
+      const char *end = strchrnul (p1, ';');
+
+      if (*p1 != ':')
+	break;
+      p1++;
+
+      packet_reg *reg = packet_reg_from_pnum (gdbarch, rsa, pnum);
+      if (reg != nullptr
+	  && end - p1 == 2 * register_size (gdbarch, reg->regnum)
+	  && regcache->get_register_status (reg->regnum) == REG_UNKNOWN)
+	{
+	  gdb::byte_vector data ((end - p1) / 2);
+
+	  hex2bin (p1, data.data (), (end - p1) / 2);
+	  regcache->raw_supply (reg->regnum, data.data ());
+	}
+
+      p = *end == ';' ? end + 1 : end;
+    }
+}
+
 /* Make the remote selected traceframe match GDB's selected
    traceframe.  */
 
@@ -8595,6 +8767,27 @@ remote_target::fetch_registers (struct regcache *regcache, int regnum)
   int i;
 
   set_remote_traceframe ();
+
+  /* If we know nothing about this thread's registers yet, the core is
+     likely walking the stacks of several threads, e.g. for "thread
+     apply all bt".  Fetch the expedited registers of all stopped
+     threads at once, unless already done since they last stopped,
+     which may be all we need.  */
+  int pc_regnum = gdbarch_pc_regnum (gdbarch);
+  if (regnum >= 0
+      && pc_regnum >= 0
+      && pc_regnum < gdbarch_num_regs (gdbarch)
+      && regcache->get_register_status (pc_regnum) == REG_UNKNOWN
+      && get_traceframe_number () == -1
+      && packet_support (PACKET_qXfer_expedited_registers) == PACKET_ENABLE)
+    {
+      if (!rs->expedited_registers.has_value ())
+	fetch_expedited_registers ();
+      supply_expedited_registers (regcache);
+      if (regcache->get_register_status (regnum) != REG_UNKNOWN)
+	return;
+    }
+
   set_general_thread (regcache->ptid ());
 
   if (regnum >= 0)
@@ -8754,6 +8947,11 @@ remote_target::store_registers (struct regcache *regcache, int regnum)
   set_remote_traceframe ();
   set_general_thread (regcache->ptid ());
 
+  /* The recorded expedited registers of this thread no longer reflect
+     its registers.  */
+  if (rs->expedited_registers.has_value ())
+    rs->expedited_registers->erase (regcache->ptid ());
+
   if (regnum >= 0)
     {
       packet_reg *reg = packet_reg_from_regnum (gdbarch, rsa, regnum);
@@ -11325,12 +11523,23 @@ remote_target::xfer_partial (enum target_object object,
 				xfered_len,
 				&remote_protocol_packets[PACKET_qXfer_threads]);
 
+    case TARGET_OBJECT_EXPEDITED_REGISTERS:
+      return remote_read_qxfer
+	("expedited-registers", annex, readbuf, offset, len, xfered_len,
+	 &remote_protocol_packets[PACKET_qXfer_expedited_registers]);
+
     case TARGET_OBJECT_TRACEFRAME_INFO:
       gdb_assert (annex == NULL);
       return remote_read_qxfer
 	("traceframe-info", annex, readbuf, offset, len, xfered_len,
 	 &remote_protocol_packets[PACKET_qXfer_traceframe_info]);
 
+    case TARGET_OBJECT_PROFILE:
+      gdb_assert (annex == NULL);
+      return remote_read_qxfer
+	("profile", annex, readbuf, offset, len, xfered_len,
+	 &remote_protocol_packets[PACKET_qXfer_profile]);
+
     case TARGET_OBJECT_FDPIC:
       return remote_read_qxfer ("fdpic", annex, readbuf, offset, len,
 				xfered_len,
@@ -13816,6 +14025,143 @@ remote_target::get_raw_trace_data (gdb_byte *buf, ULONGEST offset, LONGEST len)
   return -1;
 }
 
+/* How many qXfer:trace-buffer:read requests get_trace_buffer keeps in
+   flight, to hide the latency of the connection.  */
+
+#define TRACE_BUFFER_REQUESTS 8
+
+/* Read the trace buffer with qXfer:trace-buffer:read, compressed if
+   the target supports it, sending the requests for the next parts
+   before the replies to the previous ones arrive.  */
+
+bool
+remote_target::get_trace_buffer (trace_buffer_ftype func)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct packet_config *packet
+    = &remote_protocol_packets[PACKET_qXfer_trace_buffer];
+
+  if (packet_support (PACKET_qXfer_trace_buffer) != PACKET_ENABLE)
+    return false;
+
+  bool compressed = packet_support (PACKET_TraceBufferZlib) == PACKET_ENABLE;
+
+  /* Ask for no more than fits in a reply even if every byte needs to
+     be escaped, so that the target returns all we ask for unless it
+     reached the end, and we know where the next requests start before
+     their predecessors' replies arrive.  */
+  ULONGEST chunk = (get_remote_packet_size () - 5) / 2;
+
+  /* With acks, the target would take a request sent before it replied
+     to the previous one for a lost ack.  */
+  int window = rs->noack_mode ? TRACE_BUFFER_REQUESTS : 1;
+
+  gdb::byte_vector data (chunk);
+  gdb::byte_vector out (compressed ? 65536 : 0);
+  z_stream zs {};
+  bool stream_end = !compressed;
+
+  if (compressed && inflateInit (&zs) != Z_OK)
+    error (_("Could not initialize zlib: %s"), zs.msg);
+  SCOPE_EXIT
+    {
+      if (compressed)
+	inflateEnd (&zs);
+    };
+
+  ULONGEST offset = 0, next = 0;
+  int pending = 0;
+
+  /* Read the replies to the requests still in flight, so that they
+     aren't taken for replies to later packets.  */
+  auto drain = [&] ()
+    {
+      for (; pending > 0; pending--)
+	getpkt_sane (&rs->buf, 0);
+    };
+
+  try
+    {
+      bool done = false;
+
+      while (!done)
+	{
+	  for (; pending < window; pending++)
+	    {
+	      xsnprintf (rs->buf.data (), get_remote_packet_size (),
+			 "qXfer:trace-buffer:read:%s:%s,%s",
+			 compressed ? "zlib" : "",
+			 phex_nz (next, sizeof next),
+			 phex_nz (chunk, sizeof chunk));
+	      if (putpkt (rs->buf) < 0)
+		error (_("Failure to get requested trace buffer data"));
+	      next += chunk;
+	    }
+
+	  int packet_len = getpkt_sane (&rs->buf, 0);
+	  pending--;
+	  if (packet_len < 1
+	      || packet_ok (rs->buf, packet) != PACKET_OK
+	      || (rs->buf[0] != 'l' && rs->buf[0] != 'm'))
+	    error (_("Failure to get requested trace buffer data"));
+
+	  ULONGEST n = remote_unescape_input ((gdb_byte *) rs->buf.data () + 1,
+					      packet_len - 1, data.data (),
+					      chunk);
+	  done = rs->buf[0] == 'l';
+	  if (!done && n == 0)
+	    error (_("Remote qXfer reply contained no data."));
+
+	  /* If the target sent less than we asked for, the requests
+	     in flight are for the wrong offsets; ask again.  */
+	  if (!done && n < chunk)
+	    {
+	      drain ();
+	      next = offset + n;
+	    }
+	  offset += n;
+
+	  if (!compressed)
+	    {
+	      if (n > 0)
+		func (data.data (), n);
+	      continue;
+	    }
+
+	  zs.next_in = data.data ();
+	  zs.avail_in = n;
+	  do
+	    {
+	      zs.next_out = out.data ();
+	      zs.avail_out = out.size ();
+
+	      int ret = inflate (&zs, Z_NO_FLUSH);
+	      if (ret == Z_STREAM_END)
+		stream_end = true;
+	      else if (ret != Z_OK && ret != Z_BUF_ERROR)
+		error (_("Corrupt compressed trace buffer data"));
+
+	      if (zs.avail_out < out.size ())
+		func (out.data (), out.size () - zs.avail_out);
+	    }
+	  while (zs.avail_out == 0 && !stream_end);
+	}
+
+      drain ();
+    }
+  catch (const gdb_exception &ex)
+    {
+      if (ex.error != TARGET_CLOSE_ERROR)
+	drain ();
+      throw;
+    }
+
+  if (!stream_end)
+    error (_("Truncated compressed trace buffer data"));
+
+  return true;
+}
+
 void
 remote_target::set_disconnected_tracing (int val)
 {
@@ -14017,6 +14363,85 @@ remote_target::can_use_agent ()
   return (packet_support (PACKET_QAgent) != PACKET_DISABLE);
 }
 
+/* Have the target sample stacks on its own with QProfile:start, if
+   it supports that.  */
+
+bool
+remote_target::start_profiling (int frequency, int depth)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (packet_support (PACKET_QProfile) != PACKET_ENABLE
+      || packet_support (PACKET_qXfer_profile) != PACKET_ENABLE)
+    return false;
+
+  xsnprintf (rs->buf.data (), get_remote_packet_size (),
+	     "QProfile:start:%x,%x", frequency, depth);
+  putpkt (rs->buf);
+  getpkt (&rs->buf, 0);
+
+  if (rs->buf[0] == 'E' && rs->buf[1] == '.')
+    error (_("Target can not sample stacks: %s"), rs->buf.data () + 2);
+  if (strcmp (rs->buf.data (), "OK") != 0)
+    error (_("Bogus reply from target: %s"), rs->buf.data ());
+
+  return true;
+}
+
+/* Stop the sampling with QProfile:stop, and read the samples with
+   qXfer:profile:read.  */
+
+std::vector<profile_sample>
+remote_target::stop_profiling ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  putpkt ("QProfile:stop");
+  getpkt (&rs->buf, 0);
+  if (strcmp (rs->buf.data (), "OK") != 0)
+    error (_("Bogus reply from target: %s"), rs->buf.data ());
+
+  gdb::optional<gdb::char_vector> text
+    = target_read_stralloc (current_inferior ()->top_target (),
+			    TARGET_OBJECT_PROFILE, NULL);
+  if (!text)
+    error (_("Could not read the samples taken by the target."));
+
+  /* Each line holds a sample: its time, its thread, and the addresses
+     of its frames, the PC and then the return addresses.  */
+  std::vector<profile_sample> samples;
+  const char *p = text->data ();
+
+  while (*p != '\0')
+    {
+      profile_sample sample;
+      ULONGEST addr;
+
+      p = unpack_varlen_hex (p, &sample.time);
+      if (*p++ != ';')
+	error (_("Invalid profile sample from target."));
+      sample.ptid = read_ptid (p, &p);
+      if (*p++ != ';')
+	error (_("Invalid profile sample from target."));
+
+      while (true)
+	{
+	  p = unpack_varlen_hex (p, &addr);
+	  sample.pcs.push_back (sample.pcs.empty () ? addr : addr - 1);
+	  if (*p != ',')
+	    break;
+	  p++;
+	}
+
+      if (*p++ != '\n')
+	error (_("Invalid profile sample from target."));
+
+      samples.push_back (std::move (sample));
+    }
+
+  return samples;
+}
+
 struct btrace_target_info
 {
   /* The ptid of the traced thread.  */
@@ -14646,23 +15071,11 @@ remote_target::upload_trace_state_variables (struct uploaded_tsv **utsvp)
   return 0;
 }
 
-/* The "set/show range-stepping" show hook.  */
-
-static void
-show_range_stepping (struct ui_file *file, int from_tty,
-		     struct cmd_list_element *c,
-		     const char *value)
-{
-  gdb_printf (file,
-	      _("Debugger's willingness to use range stepping "
-		"is %s.\n"), value);
-}
-
 /* Return true if the vCont;r action is supported by the remote
    stub.  */
 
 bool
-remote_target::vcont_r_supported ()
+remote_target::supports_range_stepping ()
 {
   if (packet_support (PACKET_vCont) == PACKET_SUPPORT_UNKNOWN)
     remote_vcont_probe ();
@@ -14671,23 +15084,6 @@ remote_target::vcont_r_supported ()
 	  && get_remote_state ()->supports_vCont.r);
 }
 
-/* The "set/show range-stepping" set hook.  */
-
-static void
-set_range_stepping (const char *ignore_args, int from_tty,
-		    struct cmd_list_element *c)
-{
-  /* When enabling, check whether range stepping is actually supported
-     by the target, and warn if not.  */
-  if (use_range_stepping)
-    {
-      remote_target *remote = get_current_remote_target ();
-      if (remote == NULL
-	  || !remote->vcont_r_supported ())
-	warning (_("Range stepping is not supported by the current target"));
-    }
-}
-
 static void
 show_remote_debug (struct ui_file *file, int from_tty,
 		   struct cmd_list_element *c, const char *value)
@@ -15062,6 +15458,10 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_QCatchSyscalls],
 			 "QCatchSyscalls", "catch-syscalls", 0);
 
+  add_packet_config_cmd
+    (&remote_protocol_packets[PACKET_QSoftwareWatchpoints],
+     "QSoftwareWatchpoints", "software-watchpoints", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_QProgramSignals],
 			 "QProgramSignals", "program-signals", 0);
 
@@ -15132,6 +15532,10 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_qXfer_threads],
 			 "qXfer:threads:read", "threads", 0);
 
+  add_packet_config_cmd
+    (&remote_protocol_packets[PACKET_qXfer_expedited_registers],
+     "qXfer:expedited-registers:read", "expedited-registers", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_qXfer_siginfo_read],
 			 "qXfer:siginfo:read", "read-siginfo-object", 0);
 
@@ -15249,6 +15653,18 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_QTBuffer_size],
 			 "QTBuffer:size", "trace-buffer-size", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qXfer_trace_buffer],
+			 "qXfer:trace-buffer:read", "read-trace-buffer", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_TraceBufferZlib],
+			 "TraceBufferZlib", "trace-buffer-zlib", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QProfile],
+			 "QProfile", "profile", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qXfer_profile],
+			 "qXfer:profile:read", "read-profile-samples", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_Qbtrace_off],
        "Qbtrace:off", "disable-btrace", 0);
 
@@ -15380,20 +15796,6 @@ Show the remote pathname for \"run\"."), NULL,
 				   &remote_set_cmdlist,
 				   &remote_show_cmdlist);
 
-  add_setshow_boolean_cmd ("range-stepping", class_run,
-			   &use_range_stepping, _("\
-Enable or disable range stepping."), _("\
-Show whether target-assisted range stepping is enabled."), _("\
-If on, and the target supports it, when stepping a source line, GDB\n\
-tells the target to step the corresponding range of addresses itself instead\n\
-of issuing multiple single-steps.  This speeds up source level\n\
-stepping.  If off, GDB always issues single-steps, even if range\n\
-stepping is supported by the target.  The default is on."),
-			   set_range_stepping,
-			   show_range_stepping,
-			   &setlist,
-			   &showlist);
-
   add_setshow_zinteger_cmd ("watchdog", class_maintenance, &watchdog, _("\
 Set watchdog timer."), _("\
 Show watchdog timer."), _("\
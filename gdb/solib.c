@@ -1047,11 +1047,27 @@ solib_add (const char *pattern, int from_tty, int readsyms)
   {
     bool any_matches = false;
     bool loaded_any_symbols = false;
+    std::vector<objfile *> loaded_objfiles;
     symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
 
     if (from_tty)
 	add_flags |= SYMFILE_VERBOSE;
 
+    /* Look for the separate debug files of all the libraries whose
+       symbols are about to be read at once, rather than one library at
+       a time.  */
+    std::vector<bfd *> abfds;
+    for (struct so_list *gdb : current_program_space->solibs ())
+      if ((! pattern || re_exec (gdb->so_name))
+	  && (readsyms || libpthread_solib_p (gdb))
+	  && !gdb->symbols_loaded
+	  && gdb->abfd != nullptr)
+	abfds.push_back (gdb->abfd);
+
+    gdb::optional<scoped_separate_debug_file_prefetch> prefetch;
+    if (abfds.size () > 1)
+      prefetch.emplace (abfds);
+
     for (struct so_list *gdb : current_program_space->solibs ())
       if (! pattern || re_exec (gdb->so_name))
 	{
@@ -1075,12 +1091,18 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 				gdb->so_name);
 		}
 	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+		{
+		  loaded_any_symbols = true;
+		  if (gdb->objfile != nullptr)
+		    loaded_objfiles.push_back (gdb->objfile);
+		}
 	    }
 	}
 
+    /* Only the breakpoints that can have locations in the libraries
+       just loaded need re-setting.  */
     if (loaded_any_symbols)
-      breakpoint_re_set ();
+      breakpoint_re_set_objfiles (loaded_objfiles);
 
     if (from_tty && pattern && ! any_matches)
       gdb_printf
@@ -26,6 +26,13 @@
 #include "objfiles.h"
 #include "exec.h"
 #include "cli/cli-cmds.h"
+#include "observable.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/thread-pool.h"
+#include "stat-time.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
 /* If Gnulib redirects 'open' and 'close' to its replacements
@@ -43,6 +50,12 @@
 
 #define MAX_ENTRIES 5
 
+/* Files at least this big are highlighted on a worker thread.  Smaller
+   files are highlighted quickly enough that showing them
+   un-highlighted first would only be a distraction.  */
+
+#define BACKGROUND_HIGHLIGHT_SIZE (256 * 1024)
+
 /* See source-cache.h.  */
 
 source_cache g_source_cache;
@@ -84,6 +97,7 @@ set_use_gnu_source_highlight_enabled (const char *ignore_args,
   /* We (might) have just changed how we style source code, discard any
      previously cached contents.  */
   forget_cached_source_info ();
+  g_source_cache.clear ();
 #endif
 }
 
@@ -91,7 +105,8 @@ set_use_gnu_source_highlight_enabled (const char *ignore_args,
 
 std::string
 source_cache::get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname)
+				      const std::string &fullname,
+				      struct timespec *file_mtime)
 {
   scoped_fd desc (open_source_file (s));
   if (desc.get () < 0)
@@ -115,6 +130,7 @@ source_cache::get_plain_source_lines (struct symtab *s,
 
   if (mtime && mtime < st.st_mtime)
     warning (_("Source file is more recent than executable."));
+  *file_mtime = get_stat_mtime (&st);
 
   std::vector<off_t> offsets;
   offsets.push_back (0);
@@ -131,7 +147,7 @@ source_cache::get_plain_source_lines (struct symtab *s,
     }
 
   offsets.shrink_to_fit ();
-  m_offset_cache.emplace (fullname, std::move (offsets));
+  m_offset_cache[fullname] = std::move (offsets);
 
   return lines;
 }
@@ -189,10 +205,175 @@ get_language_name (enum language lang)
   return nullptr;
 }
 
+/* Highlight CONTENTS, the contents of the file FULLNAME in language
+   LANG_NAME, using HIGHLIGHTER.  Returns the highlighted text, or an
+   empty optional if highlighting failed.  */
+
+static gdb::optional<std::string>
+highlight_source (srchilite::SourceHighlight *highlighter,
+		  const std::string &contents, const char *lang_name,
+		  const std::string &fullname)
+{
+  try
+    {
+      std::istringstream input (contents);
+      std::ostringstream output;
+      highlighter->highlight (input, output, lang_name, fullname);
+      return output.str ();
+    }
+  catch (...)
+    {
+      /* Source Highlight will throw an exception if highlighting
+	 fails.  One possible reason it can fail is if the language is
+	 unknown -- which matters to gdb because Rust support wasn't
+	 added until after 3.1.8.  Ignore exceptions here and fall back
+	 to un-highlighted text.  */
+      return {};
+    }
+}
+
+/* Return the global source highlight object, constructing it if
+   needed.  Returns NULL if it can't be constructed.  This is a global
+   rather than a member of the class so that we don't need to include
+   anything or do conditional compilation in source-cache.h.  */
+
+static srchilite::SourceHighlight *
+get_highlighter ()
+{
+  static srchilite::SourceHighlight *highlighter;
+
+  if (highlighter == nullptr)
+    {
+      try
+	{
+	  highlighter = new srchilite::SourceHighlight ("esc.outlang");
+	  highlighter->setStyleFile ("esc.style");
+	}
+      catch (...)
+	{
+	  delete highlighter;
+	  highlighter = nullptr;
+	}
+    }
+
+  return highlighter;
+}
+
+#if CXX_STD_THREAD
+/* Source Highlight objects are not thread-safe, so this serializes
+   all uses of the global one.  */
+
+static std::mutex highlighter_mutex;
+#endif
+
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 
 /* See source-cache.h.  */
 
+bool
+source_cache::highlight (source_text &text, const char *lang_name)
+{
+#ifdef HAVE_SOURCE_HIGHLIGHT
+#if CXX_STD_THREAD
+  /* Highlight large files on a worker thread.  Also do so rather than
+     waiting when a worker thread is using the highlighter.  */
+  std::unique_lock<std::mutex> lock (highlighter_mutex, std::try_to_lock);
+  if (gdb::thread_pool::g_thread_pool->thread_count () > 0
+      && (!lock.owns_lock ()
+	  || text.contents.size () >= BACKGROUND_HIGHLIGHT_SIZE))
+    {
+      if (lock.owns_lock ())
+	lock.unlock ();
+
+      text.highlight_id = ++m_last_highlight_id;
+      if (text.highlight_id == 0)
+	text.highlight_id = ++m_last_highlight_id;
+
+      /* The worker thread gets its own copy of everything it needs, as
+	 the cache entry may go away before it is done.  */
+      unsigned id = text.highlight_id;
+      std::string fullname = text.fullname;
+      std::string contents = text.contents;
+      gdb::thread_pool::g_thread_pool->post_task
+	([id, fullname, contents, lang_name] ()
+	 {
+	   gdb::optional<std::string> highlighted;
+	   {
+	     std::lock_guard<std::mutex> guard (highlighter_mutex);
+	     srchilite::SourceHighlight *highlighter = get_highlighter ();
+	     if (highlighter != nullptr)
+	       highlighted = highlight_source (highlighter, contents,
+					       lang_name, fullname);
+	   }
+
+	   /* run_on_main_thread needs a copyable function, so the
+	      result is handed over through a shared pointer.  */
+	   auto result = std::make_shared<gdb::optional<std::string>>
+	     (std::move (highlighted));
+	   run_on_main_thread ([id, fullname, result] ()
+	     {
+	       g_source_cache.highlighting_done (fullname, id,
+						 std::move (*result));
+	     });
+	 }, gdb::thread_pool::priority::background);
+
+      return true;
+    }
+
+  if (!lock.owns_lock ())
+    lock.lock ();
+#endif
+
+  srchilite::SourceHighlight *highlighter = get_highlighter ();
+  if (highlighter == nullptr)
+    return false;
+
+  gdb::optional<std::string> highlighted
+    = highlight_source (highlighter, text.contents, lang_name,
+			text.fullname);
+  if (!highlighted.has_value ())
+    return false;
+
+  text.contents = std::move (*highlighted);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::highlighting_done (const std::string &fullname, unsigned id,
+				 gdb::optional<std::string> &&contents)
+{
+  for (source_text &text : m_source_map)
+    if (text.fullname == fullname && text.highlight_id == id)
+      {
+	text.highlight_id = 0;
+
+	/* Like in ensure, fall back to the extension languages.  */
+	if (!contents.has_value ())
+	  contents = ext_lang_colorize (fullname, text.contents);
+	if (contents.has_value ())
+	  {
+	    text.contents = std::move (*contents);
+	    gdb::observers::styling_changed.notify ();
+	  }
+	break;
+      }
+}
+
+/* Return true if the modification times A and B are the same.  */
+
+static bool
+same_mtime_p (const struct timespec &a, const struct timespec &b)
+{
+  return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+/* See source-cache.h.  */
+
 bool
 source_cache::ensure (struct symtab *s)
 {
@@ -203,6 +384,23 @@ source_cache::ensure (struct symtab *s)
     {
       if (m_source_map[i].fullname == fullname)
 	{
+	  /* If the cache was forgotten since the file was read, only
+	     keep the entry if the file is unchanged.  */
+	  if (m_source_map[i].stale)
+	    {
+	      struct stat st;
+	      if (stat (fullname.c_str (), &st) < 0
+		  || !same_mtime_p (get_stat_mtime (&st),
+				    m_source_map[i].mtime)
+		  || st.st_size != m_source_map[i].size)
+		{
+		  m_offset_cache.erase (fullname);
+		  m_source_map.erase (m_source_map.begin () + i);
+		  break;
+		}
+	      m_source_map[i].stale = false;
+	    }
+
 	  /* This should always hold, because we create the file offsets
 	     when reading the file.  */
 	  gdb_assert (m_offset_cache.find (fullname)
@@ -217,10 +415,10 @@ source_cache::ensure (struct symtab *s)
 	}
     }
 
-  std::string contents;
+  source_text result;
   try
     {
-      contents = get_plain_source_lines (s, fullname);
+      result.contents = get_plain_source_lines (s, fullname, &result.mtime);
     }
   catch (const gdb_exception_error &e)
     {
@@ -228,55 +426,27 @@ source_cache::ensure (struct symtab *s)
       return false;
     }
 
+  result.fullname = std::move (fullname);
+  result.size = result.contents.size ();
+  result.stale = false;
+  result.highlight_id = 0;
+
   if (source_styling && gdb_stdout->can_emit_style_escape ())
     {
 #ifdef HAVE_SOURCE_HIGHLIGHT
-      bool already_styled = false;
       const char *lang_name = get_language_name (s->language ());
-      if (lang_name != nullptr && use_gnu_source_highlight)
-	{
-	  /* The global source highlight object, or null if one was
-	     never constructed.  This is stored here rather than in
-	     the class so that we don't need to include anything or do
-	     conditional compilation in source-cache.h.  */
-	  static srchilite::SourceHighlight *highlighter;
-
-	  try
-	    {
-	      if (highlighter == nullptr)
-		{
-		  highlighter = new srchilite::SourceHighlight ("esc.outlang");
-		  highlighter->setStyleFile ("esc.style");
-		}
-
-	      std::istringstream input (contents);
-	      std::ostringstream output;
-	      highlighter->highlight (input, output, lang_name, fullname);
-	      contents = output.str ();
-	      already_styled = true;
-	    }
-	  catch (...)
-	    {
-	      /* Source Highlight will throw an exception if
-		 highlighting fails.  One possible reason it can fail
-		 is if the language is unknown -- which matters to gdb
-		 because Rust support wasn't added until after 3.1.8.
-		 Ignore exceptions here and fall back to
-		 un-highlighted text. */
-	    }
-	}
-
+      bool already_styled = (lang_name != nullptr && use_gnu_source_highlight
+			     && highlight (result, lang_name));
       if (!already_styled)
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 	{
 	  gdb::optional<std::string> ext_contents;
-	  ext_contents = ext_lang_colorize (fullname, contents);
+	  ext_contents = ext_lang_colorize (result.fullname, result.contents);
 	  if (ext_contents.has_value ())
-	    contents = std::move (*ext_contents);
+	    result.contents = std::move (*ext_contents);
 	}
     }
 
-  source_text result = { std::move (fullname), std::move (contents) };
   m_source_map.push_back (std::move (result));
 
   if (m_source_map.size () > MAX_ENTRIES)
@@ -297,15 +467,14 @@ source_cache::get_line_charpos (struct symtab *s,
 {
   std::string fullname = symtab_to_fullname (s);
 
+  /* This also checks that the file is unchanged if the cache was
+     forgotten.  */
+  if (!ensure (s))
+    return false;
+
   auto iter = m_offset_cache.find (fullname);
-  if (iter == m_offset_cache.end ())
-    {
-      if (!ensure (s))
-	return false;
-      iter = m_offset_cache.find (fullname);
-      /* cache_source_text ensured this was entered.  */
-      gdb_assert (iter != m_offset_cache.end ());
-    }
+  /* ensure entered this.  */
+  gdb_assert (iter != m_offset_cache.end ());
 
   *offsets = &iter->second;
   return true;
@@ -374,6 +543,7 @@ static void
 source_cache_flush_command (const char *command, int from_tty)
 {
   forget_cached_source_info ();
+  g_source_cache.clear ();
   gdb_printf (_("Source cache flushed.\n"));
 }
 
@@ -25,14 +25,21 @@
 /* This caches two things related to source files.
 
    First, it caches highlighted source text, keyed by the source
-   file's full name.  A size-limited LRU cache is used.
+   file's full name.  A size-limited LRU cache is used.  Each entry
+   remembers the modification time and size of the file, so that
+   entries for unchanged files can be kept when the cache is
+   forgotten.
 
    Highlighting depends on the GNU Source Highlight library.  When not
    available or when highlighting fails for some reason, this cache
-   will instead store the un-highlighted source text.
+   will instead store the un-highlighted source text.  Large files are
+   highlighted on a worker thread.  Until that is done, the cache
+   stores the un-highlighted source text, and the styling_changed
+   observers are notified when the highlighted text replaces it.
 
    Second, this will cache the file offsets corresponding to the start
-   of each line of a source file.  This cache is not size-limited.  */
+   of each line of a source file.  This cache is size-limited along
+   with the source text.  */
 class source_cache
 {
 public:
@@ -68,6 +75,15 @@ class source_cache
     m_offset_cache.clear ();
   }
 
+  /* Forget what is known about the files in the source cache.  The
+     items are kept, but the next time a file is needed it is read
+     again unless its modification time and size are unchanged.  */
+  void forget ()
+  {
+    for (source_text &text : m_source_map)
+      text.stale = true;
+  }
+
 private:
 
   /* One element in the cache.  */
@@ -75,20 +91,48 @@ class source_cache
   {
     /* The full name of the file.  */
     std::string fullname;
+    /* The modification time and size of the file when it was
+       read.  The time has the resolution of the file system, as a
+       file is often edited several times in a second.  */
+    struct timespec mtime;
+    off_t size;
+    /* True if the file may have changed since it was read.  */
+    bool stale;
+    /* If non-zero, the contents are being highlighted on a worker
+       thread, and this identifies the request.  */
+    unsigned highlight_id;
     /* The contents of the file.  */
     std::string contents;
   };
 
   /* A helper function for get_source_lines reads a source file.
      Returns the contents of the file; or throws an exception on
-     error.  This also updates m_offset_cache.  */
+     error.  This also updates m_offset_cache, and sets *MTIME to the
+     modification time of the file.  */
   std::string get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname);
+				      const std::string &fullname,
+				      struct timespec *mtime);
 
   /* A helper function that the data for the given symtab is entered
      into both caches.  Returns false on error.  */
   bool ensure (struct symtab *s);
 
+  /* Highlight the contents of TEXT, a file in language LANG_NAME,
+     using the GNU Source Highlight library.  Large files are
+     highlighted on a worker thread, see highlighting_done.  Returns
+     false if highlighting failed, or if the library is not available;
+     in which case the contents are left untouched.  */
+  bool highlight (source_text &text, const char *lang_name);
+
+  /* Called on the main thread when the worker thread started by
+     highlight for FULLNAME and request ID is done.
+     CONTENTS is the highlighted text, if highlighting succeeded.  */
+  void highlighting_done (const std::string &fullname, unsigned id,
+			  gdb::optional<std::string> &&contents);
+
+  /* The last request identifier used by highlight.  */
+  unsigned m_last_highlight_id = 0;
+
   /* The contents of the source text cache.  */
   std::vector<source_text> m_source_map;
 
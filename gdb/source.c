@@ -448,7 +448,7 @@ forget_cached_source_info (void)
 	forget_cached_source_info_for_objfile (objfile);
       }
 
-  g_source_cache.clear ();
+  g_source_cache.forget ();
   last_source_visited = NULL;
 }
 
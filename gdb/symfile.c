@@ -62,6 +62,9 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/forward-scope-exit.h"
 #include "gdbsupport/buildargv.h"
+#include "gdbsupport/parallel-for.h"
+#include "gdbsupport/filestuff.h"
+#include "build-id.h"
 
 #include <sys/types.h>
 #include <fcntl.h>
@@ -69,6 +72,8 @@
 #include <ctype.h>
 #include <chrono>
 #include <algorithm>
+#include <unordered_set>
+#include <dirent.h>
 
 int (*deprecated_ui_load_progress_hook) (const char *section,
 					 unsigned long num);
@@ -1266,6 +1271,16 @@ separate_debug_file_exists (const std::string &name, unsigned long crc,
       gdb_flush (gdb_stdlog);
     }
 
+  const separate_debug_file_probe *probe
+    = find_separate_debug_file_probe (name);
+  if (probe != nullptr && !probe->exists)
+    {
+      if (separate_debug_file_debug)
+	gdb_printf (gdb_stdlog, _(" no, unable to open.\n"));
+
+      return 0;
+    }
+
   gdb_bfd_ref_ptr abfd (gdb_bfd_open (name.c_str (), gnutarget));
 
   if (abfd == NULL)
@@ -1305,7 +1320,13 @@ separate_debug_file_exists (const std::string &name, unsigned long crc,
   else
     verified_as_different = 0;
 
-  file_crc_p = gdb_bfd_crc (abfd.get (), &file_crc);
+  if (probe != nullptr && probe->crc_p)
+    {
+      file_crc = probe->crc;
+      file_crc_p = 1;
+    }
+  else
+    file_crc_p = gdb_bfd_crc (abfd.get (), &file_crc);
 
   if (!file_crc_p)
     {
@@ -1367,31 +1388,23 @@ show_debug_file_directory (struct ui_file *file, int from_tty,
 #define DEBUG_SUBDIRECTORY ".debug"
 #endif
 
-/* Find a separate debuginfo file for OBJFILE, using DIR as the directory
-   where the original file resides (may not be the same as
-   dirname(objfile->name) due to symlinks), and DEBUGLINK as the file we are
-   looking for.  CANON_DIR is the "realpath" form of DIR.
-   DIR must contain a trailing '/'.
-   Returns the path of the file with separate debug info, or an empty
-   string.  */
+/* Return the names of the files which may be the separate debuginfo
+   file named DEBUGLINK of a file residing in DIR, in the order in which
+   they should be tried.  DIR may not be the same as the directory of
+   the file's name due to symlinks.  CANON_DIR is the "realpath" form
+   of DIR.  DIR must contain a trailing '/'.  */
 
-static std::string
-find_separate_debug_file (const char *dir,
-			  const char *canon_dir,
-			  const char *debuglink,
-			  unsigned long crc32, struct objfile *objfile)
+static std::vector<std::string>
+debuglink_file_candidates (const char *dir, const char *canon_dir,
+			   const char *debuglink)
 {
-  if (separate_debug_file_debug)
-    gdb_printf (gdb_stdlog,
-		_("\nLooking for separate debug info (debug link) for "
-		  "%s\n"), objfile_name (objfile));
+  std::vector<std::string> candidates;
 
   /* First try in the same directory as the original file.  */
   std::string debugfile = dir;
   debugfile += debuglink;
 
-  if (separate_debug_file_exists (debugfile, crc32, objfile))
-    return debugfile;
+  candidates.push_back (debugfile);
 
   /* Then try in the subdirectory named DEBUG_SUBDIRECTORY.  */
   debugfile = dir;
@@ -1399,8 +1412,7 @@ find_separate_debug_file (const char *dir,
   debugfile += "/";
   debugfile += debuglink;
 
-  if (separate_debug_file_exists (debugfile, crc32, objfile))
-    return debugfile;
+  candidates.push_back (debugfile);
 
   /* Then try in the global debugfile directories.
 
@@ -1444,8 +1456,7 @@ find_separate_debug_file (const char *dir,
       debugfile += dir_notarget;
       debugfile += debuglink;
 
-      if (separate_debug_file_exists (debugfile, crc32, objfile))
-	return debugfile;
+      candidates.push_back (debugfile);
 
       const char *base_path = NULL;
       if (canon_dir != NULL)
@@ -1466,8 +1477,7 @@ find_separate_debug_file (const char *dir,
 	  debugfile += "/";
 	  debugfile += debuglink;
 
-	  if (separate_debug_file_exists (debugfile, crc32, objfile))
-	    return debugfile;
+	  candidates.push_back (debugfile);
 
 	  /* If the file is in the sysroot, try using its base path in
 	     the sysroot's global debugfile directory.  */
@@ -1479,12 +1489,38 @@ find_separate_debug_file (const char *dir,
 	  debugfile += "/";
 	  debugfile += debuglink;
 
-	  if (separate_debug_file_exists (debugfile, crc32, objfile))
-	    return debugfile;
+	  candidates.push_back (debugfile);
 	}
 
     }
 
+  return candidates;
+}
+
+/* Find a separate debuginfo file for OBJFILE, using DIR as the directory
+   where the original file resides (may not be the same as
+   dirname(objfile->name) due to symlinks), and DEBUGLINK as the file we are
+   looking for.  CANON_DIR is the "realpath" form of DIR.
+   DIR must contain a trailing '/'.
+   Returns the path of the file with separate debug info, or an empty
+   string.  */
+
+static std::string
+find_separate_debug_file (const char *dir,
+			  const char *canon_dir,
+			  const char *debuglink,
+			  unsigned long crc32, struct objfile *objfile)
+{
+  if (separate_debug_file_debug)
+    gdb_printf (gdb_stdlog,
+		_("\nLooking for separate debug info (debug link) for "
+		  "%s\n"), objfile_name (objfile));
+
+  for (const std::string &debugfile
+	 : debuglink_file_candidates (dir, canon_dir, debuglink))
+    if (separate_debug_file_exists (debugfile, crc32, objfile))
+      return debugfile;
+
   return std::string ();
 }
 
@@ -1564,6 +1600,269 @@ find_separate_debug_file_by_debuglink (struct objfile *objfile)
   return debugfile;
 }
 
+/* The current separate debug file prefetch, or NULL.  */
+
+static scoped_separate_debug_file_prefetch *current_debug_file_prefetch;
+
+/* Compute the CRC of the file NAME the way gdb_bfd_crc does, but
+   without BFD, so that it can be done in a worker thread.  Return true
+   and set *CRC if successful.  */
+
+static bool
+get_file_crc_no_bfd (const std::string &name, unsigned long *crc)
+{
+  scoped_fd fd = gdb_open_cloexec (name, O_RDONLY | O_BINARY, 0);
+  if (fd.get () < 0)
+    return false;
+
+  unsigned long file_crc = 0;
+  for (;;)
+    {
+      gdb_byte buffer[8 * 1024];
+      ssize_t count = read (fd.get (), buffer, sizeof (buffer));
+      if (count < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      if (count == 0)
+	break;
+      file_crc = bfd_calc_gnu_debuglink_crc32 (file_crc, buffer, count);
+    }
+
+  *crc = file_crc;
+  return true;
+}
+
+/* See symfile.h.  */
+
+scoped_separate_debug_file_prefetch::scoped_separate_debug_file_prefetch
+  (const std::vector<bfd *> &abfds)
+  : m_prev (current_debug_file_prefetch)
+{
+  /* The files which may be the separate debug file of a BFD, found by
+     build-id and by debug link, as indexes into NAMES.  */
+  struct candidate_files
+  {
+    std::vector<size_t> build_id;
+    std::vector<size_t> debuglink;
+  };
+
+  /* The candidate files, and the directories holding them.  */
+  std::vector<std::string> names;
+  std::vector<size_t> name_dirs;
+  std::unordered_map<std::string, size_t> name_indexes;
+  std::vector<std::string> dirs;
+  std::unordered_map<std::string, size_t> dir_indexes;
+
+  auto add_names = [&] (const std::vector<std::string> &candidates,
+			std::vector<size_t> &indexes)
+    {
+      for (const std::string &name : candidates)
+	{
+	  /* Only local files can be looked for directly.  */
+	  if (!IS_ABSOLUTE_PATH (name.c_str ()))
+	    continue;
+
+	  auto inserted = name_indexes.emplace (name, names.size ());
+	  if (inserted.second)
+	    {
+	      std::string dir (name, 0, lbasename (name.c_str ())
+				       - name.c_str ());
+	      auto dir_inserted = dir_indexes.emplace (dir, dirs.size ());
+	      if (dir_inserted.second)
+		dirs.push_back (std::move (dir));
+	      names.push_back (name);
+	      name_dirs.push_back (dir_inserted.first->second);
+	    }
+	  indexes.push_back (inserted.first->second);
+	}
+    };
+
+  std::vector<candidate_files> files (abfds.size ());
+  for (size_t i = 0; i < abfds.size (); ++i)
+    {
+      bfd *abfd = abfds[i];
+
+      /* Files with debug info are not looked for.  */
+      if (bfd_get_section_by_name (abfd, ".debug_info") != nullptr)
+	continue;
+
+      const struct bfd_build_id *build_id = build_id_bfd_get (abfd);
+      if (build_id != nullptr)
+	add_names (build_id_file_candidates (build_id->size, build_id->data,
+					     ".debug"),
+		   files[i].build_id);
+
+      unsigned long crc32;
+      gdb::unique_xmalloc_ptr<char> debuglink
+	(bfd_get_debug_link_info (abfd, &crc32));
+      if (debuglink == nullptr)
+	continue;
+
+      /* Like find_separate_debug_file_by_debuglink.  */
+      std::string dir = bfd_get_filename (abfd);
+      terminate_after_last_dir_separator (&dir[0]);
+      gdb::unique_xmalloc_ptr<char> canon_dir (lrealpath (dir.c_str ()));
+      add_names (debuglink_file_candidates (dir.c_str (), canon_dir.get (),
+					    debuglink.get ()),
+		 files[i].debuglink);
+
+      struct stat st_buf;
+      if (lstat (bfd_get_filename (abfd), &st_buf) == 0
+	  && S_ISLNK (st_buf.st_mode))
+	{
+	  gdb::unique_xmalloc_ptr<char> symlink_dir
+	    (lrealpath (bfd_get_filename (abfd)));
+	  if (symlink_dir != NULL)
+	    {
+	      terminate_after_last_dir_separator (symlink_dir.get ());
+	      if (dir != symlink_dir.get ())
+		add_names (debuglink_file_candidates (symlink_dir.get (),
+						      symlink_dir.get (),
+						      debuglink.get ()),
+			   files[i].debuglink);
+	    }
+	}
+    }
+
+  /* Read each directory once, rather than checking for each file in
+     turn.  Most of the files usually do not exist.  */
+  struct dir_listing
+  {
+    /* Whether ENTRIES is known.  */
+    bool known = false;
+    std::unordered_set<std::string> entries;
+  };
+
+  std::vector<dir_listing> listings (dirs.size ());
+  gdb::parallel_for_each (1, listings.begin (), listings.end (),
+    [&] (std::vector<dir_listing>::iterator start,
+	 std::vector<dir_listing>::iterator end)
+    {
+      for (auto it = start; it < end; ++it)
+	{
+	  const std::string &dir = dirs[it - listings.begin ()];
+	  gdb_dir_up d (opendir (dir.c_str ()));
+	  if (d == nullptr)
+	    {
+	      it->known = errno == ENOENT || errno == ENOTDIR;
+	      continue;
+	    }
+
+	  while (struct dirent *ent = readdir (d.get ()))
+	    it->entries.insert (ent->d_name);
+	  it->known = true;
+	}
+    });
+
+  struct name_probe
+  {
+    /* Whether PROBE is known.  */
+    bool known = false;
+    separate_debug_file_probe probe;
+  };
+
+  std::vector<name_probe> probes (names.size ());
+  gdb::parallel_for_each (1, probes.begin (), probes.end (),
+    [&] (std::vector<name_probe>::iterator start,
+	 std::vector<name_probe>::iterator end)
+    {
+      for (auto it = start; it < end; ++it)
+	{
+	  size_t idx = it - probes.begin ();
+	  const std::string &name = names[idx];
+	  const dir_listing &listing = listings[name_dirs[idx]];
+	  if (!listing.known)
+	    continue;
+
+	  if (listing.entries.find (lbasename (name.c_str ()))
+	      == listing.entries.end ())
+	    it->known = true;
+	  else if (access (name.c_str (), F_OK) == 0)
+	    {
+	      it->known = true;
+	      it->probe.exists = true;
+	      gdb::unique_xmalloc_ptr<char> real_path
+		(lrealpath (name.c_str ()));
+	      if (real_path != nullptr)
+		it->probe.real_path = real_path.get ();
+	    }
+	  else
+	    it->known = errno == ENOENT || errno == ENOTDIR;
+	}
+    });
+
+  /* Computing the CRC of a debug link file means reading all of it, so
+     do this in parallel too, but only for the first file which exists,
+     and only if no file was found by build-id.  */
+  std::vector<size_t> crc_names;
+  std::unordered_set<size_t> crc_names_seen;
+  for (const candidate_files &f : files)
+    {
+      if (std::any_of (f.build_id.begin (), f.build_id.end (),
+		       [&] (size_t idx)
+		       {
+			 return !probes[idx].known || probes[idx].probe.exists;
+		       }))
+	continue;
+
+      for (size_t idx : f.debuglink)
+	if (probes[idx].known && probes[idx].probe.exists)
+	  {
+	    if (crc_names_seen.insert (idx).second)
+	      crc_names.push_back (idx);
+	    break;
+	  }
+    }
+
+  gdb::parallel_for_each (1, crc_names.begin (), crc_names.end (),
+    [&] (std::vector<size_t>::iterator start,
+	 std::vector<size_t>::iterator end)
+    {
+      for (auto it = start; it < end; ++it)
+	{
+	  separate_debug_file_probe &probe = probes[*it].probe;
+	  probe.crc_p = get_file_crc_no_bfd (names[*it], &probe.crc);
+	}
+    });
+
+  for (size_t i = 0; i < names.size (); ++i)
+    if (probes[i].known)
+      m_probes.emplace (std::move (names[i]), std::move (probes[i].probe));
+
+  current_debug_file_prefetch = this;
+}
+
+/* See symfile.h.  */
+
+scoped_separate_debug_file_prefetch::~scoped_separate_debug_file_prefetch ()
+{
+  current_debug_file_prefetch = m_prev;
+}
+
+/* See symfile.h.  */
+
+const separate_debug_file_probe *
+scoped_separate_debug_file_prefetch::find (const std::string &name) const
+{
+  auto it = m_probes.find (name);
+  if (it == m_probes.end ())
+    return nullptr;
+  return &it->second;
+}
+
+/* See symfile.h.  */
+
+const separate_debug_file_probe *
+find_separate_debug_file_probe (const std::string &name)
+{
+  if (current_debug_file_prefetch == nullptr)
+    return nullptr;
+  return current_debug_file_prefetch->find (name);
+}
+
 /* Make sure that OBJF_{READNOW,READNEVER} are not set
    simultaneously.  */
 
@@ -29,6 +29,7 @@
 #include "gdbsupport/function-view.h"
 #include "target-section.h"
 #include "quick-symbol.h"
+#include <unordered_map>
 
 /* Opaque declarations.  */
 struct target_section;
@@ -233,6 +234,61 @@ extern void symbol_file_add_separate (bfd *, const char *, symfile_add_flags,
 
 extern std::string find_separate_debug_file_by_debuglink (struct objfile *);
 
+/* What is known about a file which may be a separate debug file.  */
+
+struct separate_debug_file_probe
+{
+  /* Whether the file exists.  */
+  bool exists = false;
+
+  /* If the file exists, its real path, or empty if it could not be
+     computed.  */
+  std::string real_path;
+
+  /* Whether CRC holds the CRC of the file, as used by the
+     .gnu_debuglink section.  */
+  bool crc_p = false;
+  unsigned long crc = 0;
+};
+
+/* While an object of this type exists, the lookups of separate debug
+   files use what the constructor found out about the files which may
+   be the separate debug files of ABFDS.  This is meant to be used when
+   reading the symbols of many objfiles at once, e.g. of the shared
+   libraries of a process GDB attaches to.  The files are looked for in
+   parallel, and each directory is only read once instead of checking
+   for each file in turn.  Opening the files with BFD is still left to
+   the lookups.  */
+
+class scoped_separate_debug_file_prefetch
+{
+public:
+
+  explicit scoped_separate_debug_file_prefetch
+    (const std::vector<bfd *> &abfds);
+  ~scoped_separate_debug_file_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_separate_debug_file_prefetch);
+
+  /* Return what is known about the file NAME, or NULL if nothing is
+     known about it.  */
+  const separate_debug_file_probe *find (const std::string &name) const;
+
+private:
+
+  /* What is known about the files, keyed by file name.  */
+  std::unordered_map<std::string, separate_debug_file_probe> m_probes;
+
+  /* The previous prefetch, restored by the destructor.  */
+  scoped_separate_debug_file_prefetch *m_prev;
+};
+
+/* Return what the current scoped_separate_debug_file_prefetch, if any,
+   knows about the file NAME, or NULL if nothing is known about it.  */
+
+extern const separate_debug_file_probe *find_separate_debug_file_probe
+  (const std::string &name);
+
 /* Build (allocate and populate) a section_addr_info struct from an
    existing section table.  */
 
@@ -69,6 +69,7 @@
 #include "filename-seen-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
+#include <set>
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
@@ -77,7 +78,7 @@
 
 static void rbreak_command (const char *, int);
 
-static int find_line_common (struct linetable *, int, int *, int);
+static int find_line_common (struct symtab *, int, int *, int);
 
 static struct block_symbol
   lookup_symbol_aux (const char *name,
@@ -3133,6 +3134,334 @@ find_symbol_at_address (CORE_ADDR address)
 
 
 
+/* Helper for find_pc_sect_line.  Find the best line table entry for
+   PC by searching the line table of each filetab of CUST in turn.  See
+   find_pc_sect_line for the meaning of the BEST, BEST_END, BEST_SYMTAB
+   and ALT results.  */
+
+static void
+find_pc_line_in_filetabs (struct compunit_symtab *cust, CORE_ADDR pc,
+			  struct linetable_entry **bestp,
+			  CORE_ADDR *best_endp, struct symtab **best_symtabp,
+			  struct linetable_entry **altp)
+{
+  struct linetable *l;
+  int len;
+  struct linetable_entry *item;
+  struct linetable_entry *best = NULL;
+  CORE_ADDR best_end = 0;
+  struct symtab *best_symtab = 0;
+  struct linetable_entry *alt = NULL;
+
+  /* Info on best line seen in this file.  */
+
+  struct linetable_entry *prev;
+
+  for (symtab *iter_s : cust->filetabs ())
+    {
+      /* Find the best line in this symtab.  */
+      l = iter_s->linetable ();
+      if (!l)
+	continue;
+      len = l->nitems;
+      if (len <= 0)
+	{
+	  /* I think len can be zero if the symtab lacks line numbers
+	     (e.g. gcc -g1).  (Either that or the LINETABLE is NULL;
+	     I'm not sure which, and maybe it depends on the symbol
+	     reader).  */
+	  continue;
+	}
+
+      prev = NULL;
+      item = l->item;		/* Get first line info.  */
+
+      /* Is this file's first line closer than the first lines of other files?
+	 If so, record this file, and its first line, as best alternate.  */
+      if (item->pc > pc && (!alt || item->pc < alt->pc))
+	alt = item;
+
+      auto pc_compare = [](const CORE_ADDR & comp_pc,
+			   const struct linetable_entry & lhs)->bool
+      {
+	return comp_pc < lhs.pc;
+      };
+
+      struct linetable_entry *first = item;
+      struct linetable_entry *last = item + len;
+      item = std::upper_bound (first, last, pc, pc_compare);
+      if (item != first)
+	prev = item - 1;		/* Found a matching item.  */
+
+      /* At this point, prev points at the line whose start addr is <= pc, and
+	 item points at the next line.  If we ran off the end of the linetable
+	 (pc >= start of the last line), then prev == item.  If pc < start of
+	 the first line, prev will not be set.  */
+
+      /* Is this file's best line closer than the best in the other files?
+	 If so, record this file, and its best line, as best so far.  Don't
+	 save prev if it represents the end of a function (i.e. line number
+	 0) instead of a real line.  */
+
+      if (prev && prev->line && (!best || prev->pc > best->pc))
+	{
+	  best = prev;
+	  best_symtab = iter_s;
+
+	  /* If during the binary search we land on a non-statement entry,
+	     scan backward through entries at the same address to see if
+	     there is an entry marked as is-statement.  In theory this
+	     duplication should have been removed from the line table
+	     during construction, this is just a double check.  If the line
+	     table has had the duplication removed then this should be
+	     pretty cheap.  */
+	  if (!best->is_stmt)
+	    {
+	      struct linetable_entry *tmp = best;
+	      while (tmp > first && (tmp - 1)->pc == tmp->pc
+		     && (tmp - 1)->line != 0 && !tmp->is_stmt)
+		--tmp;
+	      if (tmp->is_stmt)
+		best = tmp;
+	    }
+
+	  /* Discard BEST_END if it's before the PC of the current BEST.  */
+	  if (best_end <= best->pc)
+	    best_end = 0;
+	}
+
+      /* If another line (denoted by ITEM) is in the linetable and its
+	 PC is after BEST's PC, but before the current BEST_END, then
+	 use ITEM's PC as the new best_end.  */
+      if (best && item < last && item->pc > best->pc
+	  && (best_end == 0 || best_end > item->pc))
+	best_end = item->pc;
+    }
+
+
+  *bestp = best;
+  *best_endp = best_end;
+  *best_symtabp = best_symtab;
+  *altp = alt;
+}
+
+/* An entry of a pc_line_index.  */
+
+struct pc_line_index_entry
+{
+  /* The line table entry.  Its address is read through this pointer,
+     so that the index stays valid when the objfile is relocated.  */
+  struct linetable_entry *item;
+
+  /* The position of the filetab containing ITEM in the FILES array of
+     the index.  */
+  int file;
+
+  /* The result of the search of all the line tables for an address
+     between the address of ITEM and the address of the next entry.
+     BEST is the position in the ENTRIES array of the index of the best
+     entry, or -1 if there is none.  FIRST_VALID is the position of the
+     first file with an entry for such an address, ignoring the entries
+     with no line number.  */
+  int best;
+  int first_valid;
+};
+
+/* An index of the line tables of all the filetabs of a compunit symtab,
+   sorted by address.  Compunits often have many filetabs (one per
+   included header), and this avoids searching each of their line
+   tables when looking up a PC.  */
+
+struct pc_line_index
+{
+  /* The filetabs with a non-empty line table, in filetab order.  */
+  int num_files;
+  struct symtab **files;
+
+  /* The entries of all the line tables, sorted by address, then file
+     position, then position in the line table.  */
+  int num_entries;
+  pc_line_index_entry *entries;
+
+  /* The first entry of each line table, sorted by address and then
+     file position.  */
+  pc_line_index_entry *firsts;
+};
+
+/* Return the pc_line_index of CUST, building it if needed.  Return
+   NULL if CUST has less than two non-empty line tables, in which case
+   an index wouldn't help.  */
+
+static pc_line_index *
+get_pc_line_index (struct compunit_symtab *cust)
+{
+  if (cust->m_pc_line_index != nullptr)
+    return cust->m_pc_line_index;
+
+  int num_files = 0;
+  int num_entries = 0;
+  for (symtab *s : cust->filetabs ())
+    if (s->linetable () != nullptr && s->linetable ()->nitems > 0)
+      {
+	++num_files;
+	num_entries += s->linetable ()->nitems;
+      }
+
+  if (num_files < 2)
+    return nullptr;
+
+  struct obstack *obstack = &cust->objfile ()->objfile_obstack;
+  pc_line_index *index = XOBNEW (obstack, pc_line_index);
+  index->num_files = num_files;
+  index->files = XOBNEWVEC (obstack, struct symtab *, num_files);
+  index->num_entries = num_entries;
+  index->entries = XOBNEWVEC (obstack, pc_line_index_entry, num_entries);
+  index->firsts = XOBNEWVEC (obstack, pc_line_index_entry, num_files);
+
+  int file = 0;
+  int n = 0;
+  for (symtab *s : cust->filetabs ())
+    {
+      struct linetable *l = s->linetable ();
+
+      if (l == nullptr || l->nitems <= 0)
+	continue;
+
+      index->files[file] = s;
+      index->firsts[file] = { &l->item[0], file, -1, num_files };
+      for (int i = 0; i < l->nitems; ++i)
+	index->entries[n++] = { &l->item[i], file, -1, num_files };
+      ++file;
+    }
+
+  /* The entries were added in file order and then line table order,
+     so a stable sort keeps that order for entries with the same
+     address.  */
+  auto pc_less = [] (const pc_line_index_entry &a,
+		     const pc_line_index_entry &b)
+    {
+      return a.item->pc < b.item->pc;
+    };
+  std::stable_sort (index->entries, index->entries + num_entries, pc_less);
+  std::stable_sort (index->firsts, index->firsts + num_files, pc_less);
+
+  /* Compute the search result after each entry, the way
+     find_pc_line_in_filetabs would.  The candidate of each file is its
+     last entry so far, and only matters if it has a line number.  The
+     best entry is the candidate with the highest address, and then the
+     lowest file position.  */
+  std::vector<int> last (num_files, -1);
+  std::set<int> valid_files;
+  std::set<std::pair<CORE_ADDR, int>> valid_candidates;
+  for (int i = 0; i < num_entries; ++i)
+    {
+      pc_line_index_entry &entry = index->entries[i];
+      int prev = last[entry.file];
+
+      if (prev >= 0 && index->entries[prev].item->line != 0)
+	{
+	  valid_candidates.erase ({ index->entries[prev].item->pc,
+				    -entry.file });
+	  valid_files.erase (entry.file);
+	}
+      last[entry.file] = i;
+      if (entry.item->line != 0)
+	{
+	  valid_candidates.insert ({ entry.item->pc, -entry.file });
+	  valid_files.insert (entry.file);
+	}
+
+      if (!valid_candidates.empty ())
+	{
+	  int best_file = -valid_candidates.rbegin ()->second;
+	  entry.best = last[best_file];
+	  entry.first_valid = *valid_files.begin ();
+	}
+    }
+
+  cust->m_pc_line_index = index;
+  return index;
+}
+
+/* Helper for find_pc_sect_line.  Like find_pc_line_in_filetabs, but
+   using INDEX.  This gives the same results, but only needs a binary
+   search in the usual case.  Return false if the answer can't be found
+   that way quickly, in which case the results are not set and
+   find_pc_line_in_filetabs should be used instead.  */
+
+static bool
+find_pc_line_in_index (const pc_line_index *index, CORE_ADDR pc,
+		       struct linetable_entry **bestp,
+		       CORE_ADDR *best_endp, struct symtab **best_symtabp,
+		       struct linetable_entry **altp)
+{
+  /* How many entries to look at for the end of the best line before
+     giving up.  */
+  const int max_steps = 64;
+
+  const pc_line_index_entry *begin = index->entries;
+  const pc_line_index_entry *end = begin + index->num_entries;
+  auto pc_compare = [] (CORE_ADDR comp_pc, const pc_line_index_entry &rhs)
+    {
+      return comp_pc < rhs.item->pc;
+    };
+
+  /* The first line table starting after PC gives the alternate line.  */
+  const pc_line_index_entry *firsts = index->firsts;
+  const pc_line_index_entry *firsts_end = firsts + index->num_files;
+  const pc_line_index_entry *alt = std::upper_bound (firsts, firsts_end, pc,
+						     pc_compare);
+
+  /* The first entry after PC.  The entry before it has the result of
+     the search.  */
+  const pc_line_index_entry *after = std::upper_bound (begin, end, pc,
+						       pc_compare);
+  struct linetable_entry *best = nullptr;
+  CORE_ADDR best_end = 0;
+  struct symtab *best_symtab = nullptr;
+
+  if (after > begin && after[-1].best >= 0)
+    {
+      const pc_line_index_entry &prev = after[-1];
+
+      best = begin[prev.best].item;
+      best_symtab = index->files[begin[prev.best].file];
+
+      /* Each line table from the first valid one on ends the best line
+	 at its first entry after PC, if it has one.  */
+      int steps = 0;
+      for (const pc_line_index_entry *it = after; it < end; ++it)
+	{
+	  if (++steps > max_steps)
+	    return false;
+	  if (it->file >= prev.first_valid)
+	    {
+	      best_end = it->item->pc;
+	      break;
+	    }
+	}
+
+      /* Like find_pc_line_in_filetabs, prefer an is-statement entry at
+	 the same address.  */
+      if (!best->is_stmt)
+	{
+	  struct linetable_entry *first = best_symtab->linetable ()->item;
+	  struct linetable_entry *tmp = best;
+	  while (tmp > first && (tmp - 1)->pc == tmp->pc
+		 && (tmp - 1)->line != 0 && !tmp->is_stmt)
+	    --tmp;
+	  if (tmp->is_stmt)
+	    best = tmp;
+	}
+    }
+
+  *bestp = best;
+  *best_endp = best_end;
+  *best_symtabp = best_symtab;
+  *altp = alt < firsts_end ? alt->item : nullptr;
+  return true;
+}
+
 /* Find the source file and line number for a given PC value and SECTION.
    Return a structure containing a symtab pointer, a line number,
    and a pc range for the entire source line.
@@ -3152,9 +3481,6 @@ struct symtab_and_line
 find_pc_sect_line (CORE_ADDR pc, struct obj_section *section, int notcurrent)
 {
   struct compunit_symtab *cust;
-  struct linetable *l;
-  int len;
-  struct linetable_entry *item;
   const struct blockvector *bv;
   struct bound_minimal_symbol msymbol;
 
@@ -3171,10 +3497,6 @@ find_pc_sect_line (CORE_ADDR pc, struct obj_section *section, int notcurrent)
      with a range from the start of that file to the first line's pc.  */
   struct linetable_entry *alt = NULL;
 
-  /* Info on best line seen in this file.  */
-
-  struct linetable_entry *prev;
-
   /* If this pc is not from the current frame,
      it is the address of the end of a call instruction.
      Quite likely that is the start of the following statement.
@@ -3296,88 +3618,15 @@ find_pc_sect_line (CORE_ADDR pc, struct obj_section *section, int notcurrent)
 
   /* Look at all the symtabs that share this blockvector.
      They all have the same apriori range, that we found was right;
-     but they have different line tables.  */
-
-  for (symtab *iter_s : cust->filetabs ())
-    {
-      /* Find the best line in this symtab.  */
-      l = iter_s->linetable ();
-      if (!l)
-	continue;
-      len = l->nitems;
-      if (len <= 0)
-	{
-	  /* I think len can be zero if the symtab lacks line numbers
-	     (e.g. gcc -g1).  (Either that or the LINETABLE is NULL;
-	     I'm not sure which, and maybe it depends on the symbol
-	     reader).  */
-	  continue;
-	}
-
-      prev = NULL;
-      item = l->item;		/* Get first line info.  */
-
-      /* Is this file's first line closer than the first lines of other files?
-	 If so, record this file, and its first line, as best alternate.  */
-      if (item->pc > pc && (!alt || item->pc < alt->pc))
-	alt = item;
-
-      auto pc_compare = [](const CORE_ADDR & comp_pc,
-			   const struct linetable_entry & lhs)->bool
-      {
-	return comp_pc < lhs.pc;
-      };
-
-      struct linetable_entry *first = item;
-      struct linetable_entry *last = item + len;
-      item = std::upper_bound (first, last, pc, pc_compare);
-      if (item != first)
-	prev = item - 1;		/* Found a matching item.  */
-
-      /* At this point, prev points at the line whose start addr is <= pc, and
-	 item points at the next line.  If we ran off the end of the linetable
-	 (pc >= start of the last line), then prev == item.  If pc < start of
-	 the first line, prev will not be set.  */
-
-      /* Is this file's best line closer than the best in the other files?
-	 If so, record this file, and its best line, as best so far.  Don't
-	 save prev if it represents the end of a function (i.e. line number
-	 0) instead of a real line.  */
-
-      if (prev && prev->line && (!best || prev->pc > best->pc))
-	{
-	  best = prev;
-	  best_symtab = iter_s;
-
-	  /* If during the binary search we land on a non-statement entry,
-	     scan backward through entries at the same address to see if
-	     there is an entry marked as is-statement.  In theory this
-	     duplication should have been removed from the line table
-	     during construction, this is just a double check.  If the line
-	     table has had the duplication removed then this should be
-	     pretty cheap.  */
-	  if (!best->is_stmt)
-	    {
-	      struct linetable_entry *tmp = best;
-	      while (tmp > first && (tmp - 1)->pc == tmp->pc
-		     && (tmp - 1)->line != 0 && !tmp->is_stmt)
-		--tmp;
-	      if (tmp->is_stmt)
-		best = tmp;
-	    }
+     but they have different line tables.  Use the index of all of
+     them if there is one, and search each one in turn otherwise.  */
 
-	  /* Discard BEST_END if it's before the PC of the current BEST.  */
-	  if (best_end <= best->pc)
-	    best_end = 0;
-	}
-
-      /* If another line (denoted by ITEM) is in the linetable and its
-	 PC is after BEST's PC, but before the current BEST_END, then
-	 use ITEM's PC as the new best_end.  */
-      if (best && item < last && item->pc > best->pc
-	  && (best_end == 0 || best_end > item->pc))
-	best_end = item->pc;
-    }
+  pc_line_index *index = get_pc_line_index (cust);
+  if (index == nullptr
+      || !find_pc_line_in_index (index, pc, &best, &best_end, &best_symtab,
+				 &alt))
+    find_pc_line_in_filetabs (cust, pc, &best, &best_end, &best_symtab,
+			      &alt);
 
   if (!best_symtab)
     {
@@ -3472,7 +3721,7 @@ find_line_symtab (struct symtab *sym_tab, int line,
   /* First try looking it up in the given symtab.  */
   best_linetable = sym_tab->linetable ();
   best_symtab = sym_tab;
-  best_index = find_line_common (best_linetable, line, &exact, 0);
+  best_index = find_line_common (sym_tab, line, &exact, 0);
   if (best_index < 0 || !exact)
     {
       /* Didn't find an exact match.  So we better keep looking for
@@ -3510,7 +3759,7 @@ find_line_symtab (struct symtab *sym_tab, int line,
 				    symtab_to_fullname (s)) != 0)
 		    continue;	
 		  l = s->linetable ();
-		  ind = find_line_common (l, line, &exact, 0);
+		  ind = find_line_common (s, line, &exact, 0);
 		  if (ind >= 0)
 		    {
 		      if (exact)
@@ -3561,8 +3810,7 @@ find_pcs_for_symtab_line (struct symtab *symtab, int line,
       int was_exact;
       int idx;
 
-      idx = find_line_common (symtab->linetable (), line, &was_exact,
-			      start);
+      idx = find_line_common (symtab, line, &was_exact, start);
       if (idx < 0)
 	break;
 
@@ -3649,7 +3897,50 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
   return true;
 }
 
-/* Given a line table and a line number, return the index into the line
+/* An index of the is-statement entries of a line table by line
+   number.  */
+
+struct linetable_line_index
+{
+  /* The number of entries in ITEMS.  */
+  int num_items;
+
+  /* The positions in the line table of its is-statement entries with a
+     line number, sorted by line number and then position.  */
+  int *items;
+};
+
+/* Return the line index of SYMTAB, building it if needed.  */
+
+static const linetable_line_index *
+get_linetable_line_index (struct symtab *symtab)
+{
+  if (symtab->m_line_index != nullptr)
+    return symtab->m_line_index;
+
+  struct linetable *l = symtab->linetable ();
+  std::vector<int> items;
+  for (int i = 0; i < l->nitems; ++i)
+    if (l->item[i].is_stmt && l->item[i].line > 0)
+      items.push_back (i);
+
+  std::stable_sort (items.begin (), items.end (),
+		    [l] (int a, int b)
+		    {
+		      return l->item[a].line < l->item[b].line;
+		    });
+
+  struct obstack *obstack = &symtab->compunit ()->objfile ()->objfile_obstack;
+  linetable_line_index *index = XOBNEW (obstack, linetable_line_index);
+  index->num_items = items.size ();
+  index->items = XOBNEWVEC (obstack, int, items.size ());
+  std::copy (items.begin (), items.end (), index->items);
+
+  symtab->m_line_index = index;
+  return index;
+}
+
+/* Given a symtab and a line number, return the index into the line
    table for the pc of the nearest line whose number is >= the specified one.
    Return -1 if none is found.  The value is >= 0 if it is an index.
    START is the index at which to start searching the line table.
@@ -3657,51 +3948,51 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
    Set *EXACT_MATCH nonzero if the value returned is an exact match.  */
 
 static int
-find_line_common (struct linetable *l, int lineno,
+find_line_common (struct symtab *symtab, int lineno,
 		  int *exact_match, int start)
 {
-  int i;
-  int len;
-
-  /* BEST is the smallest linenumber > LINENO so far seen,
-     or 0 if none has been seen so far.
-     BEST_INDEX identifies the item for it.  */
-
-  int best_index = -1;
-  int best = 0;
-
   *exact_match = 0;
 
   if (lineno <= 0)
     return -1;
-  if (l == 0)
+  if (symtab->linetable () == nullptr)
     return -1;
 
-  len = l->nitems;
-  for (i = start; i < len; i++)
-    {
-      struct linetable_entry *item = &(l->item[i]);
+  struct linetable *l = symtab->linetable ();
+  const linetable_line_index *index = get_linetable_line_index (symtab);
+  const int *begin = index->items;
+  const int *end = begin + index->num_items;
 
-      /* Ignore non-statements.  */
-      if (!item->is_stmt)
-	continue;
+  /* Look for the first (lowest address) entry which matches, or else
+     the first entry of the smallest line number > LINENO, ignoring the
+     entries before START.  */
+  auto entry_less = [l] (int i, std::pair<int, int> line_pos)
+    {
+      if (l->item[i].line != line_pos.first)
+	return l->item[i].line < line_pos.first;
+      return i < line_pos.second;
+    };
+  const int *it = std::lower_bound (begin, end, std::make_pair (lineno, start),
+				    entry_less);
+  if (it < end && l->item[*it].line == lineno)
+    {
+      *exact_match = 1;
+      return *it;
+    }
 
-      if (item->line == lineno)
-	{
-	  /* Return the first (lowest address) entry which matches.  */
-	  *exact_match = 1;
-	  return i;
-	}
+  /* IT is now the first entry of the smallest line number > LINENO.
+     Skip the lines that only have entries before START.  */
+  while (it < end)
+    {
+      int line = l->item[*it].line;
 
-      if (item->line > lineno && (best == 0 || item->line < best))
-	{
-	  best = item->line;
-	  best_index = i;
-	}
+      it = std::lower_bound (it, end, std::make_pair (line, start),
+			     entry_less);
+      if (it < end && l->item[*it].line == line)
+	return *it;
     }
 
-  /* If we got here, we didn't get an exact match.  */
-  return best_index;
+  return -1;
 }
 
 bool
@@ -5965,10 +6256,20 @@ default_collect_symbol_completion_matches_break_on
     }
 
   /* Look through the partial symtabs for all symbols which begin by
-     matching SYM_TEXT.  Expand all CUs that you find to the list.  */
+     matching SYM_TEXT.  Expand all CUs that you find to the list.
+     Don't expand a CU just for a name that is already in the list,
+     though.  Names defined in many CUs, like the functions of a
+     header, would otherwise expand all of them, and the minimal
+     symbols usually already provided most names.  */
   expand_symtabs_matching (NULL,
 			   lookup_name,
-			   NULL,
+			   [&] (const char *name) /* symbol matcher */
+			     {
+			       gdb::unique_xmalloc_ptr<char> completion
+				 = make_completion_match_str (name, sym_text,
+							      word);
+			       return !tracker.have_completion (completion.get ());
+			     },
 			   [&] (compunit_symtab *symtab) /* expansion notify */
 			     {
 			       add_symtab_completions (symtab,
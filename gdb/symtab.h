@@ -1617,6 +1617,7 @@ struct symtab
   void set_linetable (struct linetable *linetable)
   {
     m_linetable = linetable;
+    m_line_index = nullptr;
   }
 
   enum language language () const
@@ -1643,6 +1644,11 @@ struct symtab
 
   struct linetable *m_linetable;
 
+  /* Index of the line table by line number, built lazily by
+     find_line_common.  NULL if not built yet.  */
+
+  struct linetable_line_index *m_line_index;
+
   /* Name of this source file.  This pointer is never NULL.  */
 
   const char *filename;
@@ -1725,6 +1731,7 @@ struct compunit_symtab
 	m_last_filetab->next = filetab;
 	m_last_filetab = filetab;
       }
+    m_pc_line_index = nullptr;
   }
 
   const char *debugformat () const
@@ -1883,6 +1890,11 @@ struct compunit_symtab
   /* struct call_site entries for this compilation unit or NULL.  */
   htab_t m_call_site_htab;
 
+  /* Index of the line tables of all the filetabs by address, built
+     lazily by find_pc_sect_line.  NULL if not built yet, or if there
+     are less than two line tables.  */
+  struct pc_line_index *m_pc_line_index;
+
   /* The macro table for this symtab.  Like the blockvector, this
      is shared between different symtabs in a given compilation unit.
      It's debatable whether it *should* be shared among all the symtabs in
@@ -110,12 +110,16 @@
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_find_memory_region_ftype(X) \
   target_debug_do_print (host_address_to_string (X))
+#define target_debug_print_trace_buffer_ftype(X) \
+  target_debug_do_print (host_address_to_string (&X))
 #define target_debug_print_bfd_p(X) \
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_std_vector_mem_region(X) \
   target_debug_do_print (host_address_to_string (X.data ()))
 #define target_debug_print_std_vector_static_tracepoint_marker(X)	\
   target_debug_do_print (host_address_to_string (X.data ()))
+#define target_debug_print_std_vector_profile_sample(X)	\
+  target_debug_do_print (host_address_to_string (X.data ()))
 #define target_debug_print_const_struct_target_desc_p(X)	\
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_struct_bp_location_p(X)	\
@@ -160,6 +164,8 @@
   target_debug_do_print (host_address_to_string (X.get ()))
 #define target_debug_print_gdb_array_view_const_int(X)	\
   target_debug_do_print (host_address_to_string (X.data ()))
+#define target_debug_print_gdb_array_view_const_agent_expr_up(X)	\
+  target_debug_do_print (pulongest (X.size ()))
 #define target_debug_print_inferior_p(inf) \
   target_debug_do_print (host_address_to_string (inf))
 #define target_debug_print_record_print_flags(X) \
@@ -126,11 +126,13 @@ struct dummy_target : public target_ops
   bool supports_multi_process () override;
   bool supports_enable_disable_tracepoint () override;
   bool supports_disable_randomization () override;
+  bool supports_range_stepping () override;
   bool supports_string_tracing () override;
   bool supports_evaluation_of_breakpoint_conditions () override;
   bool supports_dumpcore () override;
   void dumpcore (const char *arg0) override;
   bool can_run_breakpoint_commands () override;
+  bool set_software_watchpoints (gdb::array_view<const agent_expr_up> arg0) override;
   struct gdbarch *thread_architecture (ptid_t arg0) override;
   struct address_space *thread_address_space (ptid_t arg0) override;
   bool filesystem_is_local () override;
@@ -151,6 +153,7 @@ struct dummy_target : public target_ops
   int upload_tracepoints (struct uploaded_tp **arg0) override;
   int upload_trace_state_variables (struct uploaded_tsv **arg0) override;
   LONGEST get_raw_trace_data (gdb_byte *arg0, ULONGEST arg1, LONGEST arg2) override;
+  bool get_trace_buffer (trace_buffer_ftype arg0) override;
   int get_min_fast_tracepoint_insn_len () override;
   void set_disconnected_tracing (int arg0) override;
   void set_circular_trace_buffer (int arg0) override;
@@ -165,6 +168,8 @@ struct dummy_target : public target_ops
   traceframe_info_up traceframe_info () override;
   bool use_agent (bool arg0) override;
   bool can_use_agent () override;
+  bool start_profiling (int arg0, int arg1) override;
+  std::vector<profile_sample> stop_profiling () override;
   struct btrace_target_info *enable_btrace (thread_info *arg0, const struct btrace_config *arg1) override;
   void disable_btrace (struct btrace_target_info *arg0) override;
   void teardown_btrace (struct btrace_target_info *arg0) override;
@@ -300,11 +305,13 @@ struct debug_target : public target_ops
   bool supports_multi_process () override;
   bool supports_enable_disable_tracepoint () override;
   bool supports_disable_randomization () override;
+  bool supports_range_stepping () override;
   bool supports_string_tracing () override;
   bool supports_evaluation_of_breakpoint_conditions () override;
   bool supports_dumpcore () override;
   void dumpcore (const char *arg0) override;
   bool can_run_breakpoint_commands () override;
+  bool set_software_watchpoints (gdb::array_view<const agent_expr_up> arg0) override;
   struct gdbarch *thread_architecture (ptid_t arg0) override;
   struct address_space *thread_address_space (ptid_t arg0) override;
   bool filesystem_is_local () override;
@@ -325,6 +332,7 @@ struct debug_target : public target_ops
   int upload_tracepoints (struct uploaded_tp **arg0) override;
   int upload_trace_state_variables (struct uploaded_tsv **arg0) override;
   LONGEST get_raw_trace_data (gdb_byte *arg0, ULONGEST arg1, LONGEST arg2) override;
+  bool get_trace_buffer (trace_buffer_ftype arg0) override;
   int get_min_fast_tracepoint_insn_len () override;
   void set_disconnected_tracing (int arg0) override;
   void set_circular_trace_buffer (int arg0) override;
@@ -339,6 +347,8 @@ struct debug_target : public target_ops
   traceframe_info_up traceframe_info () override;
   bool use_agent (bool arg0) override;
   bool can_use_agent () override;
+  bool start_profiling (int arg0, int arg1) override;
+  std::vector<profile_sample> stop_profiling () override;
   struct btrace_target_info *enable_btrace (thread_info *arg0, const struct btrace_config *arg1) override;
   void disable_btrace (struct btrace_target_info *arg0) override;
   void teardown_btrace (struct btrace_target_info *arg0) override;
@@ -2813,6 +2823,31 @@ debug_target::supports_disable_randomization ()
   return result;
 }
 
+bool
+target_ops::supports_range_stepping ()
+{
+  return this->beneath ()->supports_range_stepping ();
+}
+
+bool
+dummy_target::supports_range_stepping ()
+{
+  return find_default_supports_range_stepping (this);
+}
+
+bool
+debug_target::supports_range_stepping ()
+{
+  bool result;
+  gdb_printf (gdb_stdlog, "-> %s->supports_range_stepping (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->supports_range_stepping ();
+  gdb_printf (gdb_stdlog, "<- %s->supports_range_stepping (", this->beneath ()->shortname ());
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::supports_string_tracing ()
 {
@@ -2934,6 +2969,32 @@ debug_target::can_run_breakpoint_commands ()
   return result;
 }
 
+bool
+target_ops::set_software_watchpoints (gdb::array_view<const agent_expr_up> arg0)
+{
+  return this->beneath ()->set_software_watchpoints (arg0);
+}
+
+bool
+dummy_target::set_software_watchpoints (gdb::array_view<const agent_expr_up> arg0)
+{
+  return false;
+}
+
+bool
+debug_target::set_software_watchpoints (gdb::array_view<const agent_expr_up> arg0)
+{
+  bool result;
+  gdb_printf (gdb_stdlog, "-> %s->set_software_watchpoints (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->set_software_watchpoints (arg0);
+  gdb_printf (gdb_stdlog, "<- %s->set_software_watchpoints (", this->beneath ()->shortname ());
+  target_debug_print_gdb_array_view_const_agent_expr_up (arg0);
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
 struct gdbarch *
 target_ops::thread_architecture (ptid_t arg0)
 {
@@ -3428,6 +3489,32 @@ debug_target::get_raw_trace_data (gdb_byte *arg0, ULONGEST arg1, LONGEST arg2)
   return result;
 }
 
+bool
+target_ops::get_trace_buffer (trace_buffer_ftype arg0)
+{
+  return this->beneath ()->get_trace_buffer (arg0);
+}
+
+bool
+dummy_target::get_trace_buffer (trace_buffer_ftype arg0)
+{
+  return false;
+}
+
+bool
+debug_target::get_trace_buffer (trace_buffer_ftype arg0)
+{
+  bool result;
+  gdb_printf (gdb_stdlog, "-> %s->get_trace_buffer (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->get_trace_buffer (arg0);
+  gdb_printf (gdb_stdlog, "<- %s->get_trace_buffer (", this->beneath ()->shortname ());
+  target_debug_print_trace_buffer_ftype (arg0);
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
 int
 target_ops::get_min_fast_tracepoint_insn_len ()
 {
@@ -3780,6 +3867,59 @@ debug_target::can_use_agent ()
   return result;
 }
 
+bool
+target_ops::start_profiling (int arg0, int arg1)
+{
+  return this->beneath ()->start_profiling (arg0, arg1);
+}
+
+bool
+dummy_target::start_profiling (int arg0, int arg1)
+{
+  return false;
+}
+
+bool
+debug_target::start_profiling (int arg0, int arg1)
+{
+  bool result;
+  gdb_printf (gdb_stdlog, "-> %s->start_profiling (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->start_profiling (arg0, arg1);
+  gdb_printf (gdb_stdlog, "<- %s->start_profiling (", this->beneath ()->shortname ());
+  target_debug_print_int (arg0);
+  gdb_puts (", ", gdb_stdlog);
+  target_debug_print_int (arg1);
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
+std::vector<profile_sample>
+target_ops::stop_profiling ()
+{
+  return this->beneath ()->stop_profiling ();
+}
+
+std::vector<profile_sample>
+dummy_target::stop_profiling ()
+{
+  tcomplain ();
+}
+
+std::vector<profile_sample>
+debug_target::stop_profiling ()
+{
+  std::vector<profile_sample> result;
+  gdb_printf (gdb_stdlog, "-> %s->stop_profiling (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->stop_profiling ();
+  gdb_printf (gdb_stdlog, "<- %s->stop_profiling (", this->beneath ()->shortname ());
+  gdb_puts (") = ", gdb_stdlog);
+  target_debug_print_std_vector_profile_sample (result);
+  gdb_puts ("\n", gdb_stdlog);
+  return result;
+}
+
 struct btrace_target_info *
 target_ops::enable_btrace (thread_info *arg0, const struct btrace_config *arg1)
 {
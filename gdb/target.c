@@ -271,6 +271,16 @@ target_supports_evaluation_of_breakpoint_conditions ()
 
 /* See target.h.  */
 
+bool
+target_set_software_watchpoints (gdb::array_view<const agent_expr_up> exprs)
+{
+  target_ops *target = current_inferior ()->top_target ();
+
+  return target->set_software_watchpoints (exprs);
+}
+
+/* See target.h.  */
+
 bool
 target_supports_dumpcore ()
 {
@@ -724,6 +734,14 @@ target_get_raw_trace_data (gdb_byte *buf, ULONGEST offset, LONGEST len)
   return target->get_raw_trace_data (buf, offset, len);
 }
 
+bool
+target_get_trace_buffer (trace_buffer_ftype func)
+{
+  target_ops *target = current_inferior ()->top_target ();
+
+  return target->get_trace_buffer (func);
+}
+
 int
 target_get_min_fast_tracepoint_insn_len ()
 {
@@ -2998,6 +3016,25 @@ target_supports_disable_randomization (void)
   return current_inferior ()->top_target ()->supports_disable_randomization ();
 }
 
+static bool
+find_default_supports_range_stepping (struct target_ops *self)
+{
+  struct target_ops *t;
+
+  t = find_default_run_target (NULL);
+  if (t != NULL)
+    return t->supports_range_stepping ();
+  return false;
+}
+
+/* See target.h.  */
+
+bool
+target_supports_range_stepping ()
+{
+  return current_inferior ()->top_target ()->supports_range_stepping ();
+}
+
 /* See target/target.h.  */
 
 int
@@ -4062,6 +4099,23 @@ target_ranged_break_num_registers (void)
 
 /* See target.h.  */
 
+bool
+target_start_profiling (int frequency, int depth)
+{
+  return current_inferior ()->top_target ()->start_profiling (frequency,
+							      depth);
+}
+
+/* See target.h.  */
+
+std::vector<profile_sample>
+target_stop_profiling ()
+{
+  return current_inferior ()->top_target ()->stop_profiling ();
+}
+
+/* See target.h.  */
+
 struct btrace_target_info *
 target_enable_btrace (thread_info *tp, const struct btrace_config *conf)
 {
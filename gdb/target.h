@@ -81,6 +81,7 @@ struct inferior;
 #include "command.h"
 #include "disasm-flags.h"
 #include "tracepoint.h"
+#include "profile.h"
 
 #include "gdbsupport/break-common.h" /* For enum target_hw_bp_type.  */
 
@@ -181,10 +182,14 @@ enum target_object
   TARGET_OBJECT_SIGNAL_INFO,
   /* The list of threads that are being debugged.  */
   TARGET_OBJECT_THREADS,
+  /* The expedited registers of all stopped threads.  */
+  TARGET_OBJECT_EXPEDITED_REGISTERS,
   /* Collected static trace data.  */
   TARGET_OBJECT_STATIC_TRACE_DATA,
   /* Traceframe info, in XML format.  */
   TARGET_OBJECT_TRACEFRAME_INFO,
+  /* Stack samples taken by the target, see start_profiling.  */
+  TARGET_OBJECT_PROFILE,
   /* Load maps for FDPIC systems.  */
   TARGET_OBJECT_FDPIC,
   /* Darwin dynamic linker info data.  */
@@ -375,6 +380,12 @@ struct thread_info;		/* fwd decl for parameter list below: */
 typedef void async_callback_ftype (enum inferior_event_type event_type,
 				   void *context);
 
+/* The type of the callback to the get_trace_buffer method, called
+   with each piece of the trace buffer in turn.  */
+
+typedef gdb::function_view<void (const gdb_byte *data, size_t len)>
+  trace_buffer_ftype;
+
 /* Normally target debug printing is purely type-based.  However,
    sometimes it is necessary to override the debug printing on a
    per-argument basis.  This macro can be used, attribute-style, to
@@ -900,6 +911,12 @@ struct target_ops
     virtual bool supports_disable_randomization ()
       TARGET_DEFAULT_FUNC (find_default_supports_disable_randomization);
 
+    /* Does this target support stepping a thread through a range of
+       addresses itself, only reporting when it leaves the range?  See
+       thread_control_state::may_range_step.  */
+    virtual bool supports_range_stepping ()
+      TARGET_DEFAULT_FUNC (find_default_supports_range_stepping);
+
     /* Does this target support the tracenz bytecode for string collection?  */
     virtual bool supports_string_tracing ()
       TARGET_DEFAULT_RETURN (false);
@@ -922,6 +939,14 @@ struct target_ops
     virtual bool can_run_breakpoint_commands ()
       TARGET_DEFAULT_RETURN (false);
 
+    /* Ask the target to single-step the threads of the current
+       inferior itself while they are meant to be running, and to only
+       report a stop when the value computed by one of EXPRS changes.
+       An empty EXPRS cancels a previous request.  Return true if the
+       target will check EXPRS.  */
+    virtual bool set_software_watchpoints (gdb::array_view<const agent_expr_up> exprs)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Determine current architecture of thread PTID.
 
        The target is supposed to determine the architecture of the code where
@@ -1073,6 +1098,13 @@ struct target_ops
 					ULONGEST offset, LONGEST len)
       TARGET_DEFAULT_NORETURN (tcomplain ());
 
+    /* Read the whole trace buffer, in the format get_raw_trace_data
+       returns it, and pass it in order to FUNC, in as many pieces as
+       convenient.  Return false, without calling FUNC, if the target
+       can't do this; get_raw_trace_data should be used instead.  */
+    virtual bool get_trace_buffer (trace_buffer_ftype func)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Get the minimum length of instruction on which a fast tracepoint
        may be set on the target.  If this operation is unsupported,
        return -1.  If for some reason the minimum length cannot be
@@ -1151,6 +1183,19 @@ struct target_ops
     virtual bool can_use_agent ()
       TARGET_DEFAULT_RETURN (false);
 
+    /* Start sampling the stacks of the threads GDB lets run,
+       FREQUENCY times per second, by following the chain of saved
+       frame pointers of each, up to DEPTH frames.  The target samples
+       the threads on its own, without reporting them stopped.  Return
+       false if the target can't do this.  */
+    virtual bool start_profiling (int frequency, int depth)
+      TARGET_DEFAULT_RETURN (false);
+
+    /* Stop sampling, and return the samples taken since
+       start_profiling.  */
+    virtual std::vector<profile_sample> stop_profiling ()
+      TARGET_DEFAULT_NORETURN (tcomplain ());
+
     /* Enable branch tracing for TP using CONF configuration.
        Return a branch trace target information struct for reading and for
        disabling branch trace.  */
@@ -1551,6 +1596,10 @@ int target_info_proc (const char *, enum info_proc_what);
 
 int target_supports_disable_randomization (void);
 
+/* Returns true if this target can step a range of addresses itself.  */
+
+extern bool target_supports_range_stepping ();
+
 /* Returns true if this target can enable and disable tracepoints
    while a trace experiment is running.  */
 
@@ -1563,6 +1612,12 @@ extern bool target_supports_string_tracing ();
 
 extern bool target_supports_evaluation_of_breakpoint_conditions ();
 
+/* Ask the target to check the software watchpoints whose values EXPRS
+   compute.  See target_ops::set_software_watchpoints.  */
+
+extern bool target_set_software_watchpoints
+  (gdb::array_view<const agent_expr_up> exprs);
+
 /* Does this target support dumpcore API?  */
 
 extern bool target_supports_dumpcore ();
@@ -2276,6 +2331,8 @@ extern int target_upload_trace_state_variables (uploaded_tsv **utsvp);
 extern LONGEST target_get_raw_trace_data (gdb_byte *buf, ULONGEST offset,
 					  LONGEST len);
 
+extern bool target_get_trace_buffer (trace_buffer_ftype func);
+
 extern int target_get_min_fast_tracepoint_insn_len ();
 
 extern void target_set_disconnected_tracing (int val);
@@ -2501,6 +2558,12 @@ extern void update_target_permissions (void);
 
 /* Imported from machine dependent code.  */
 
+/* See target_ops::start_profiling.  */
+extern bool target_start_profiling (int frequency, int depth);
+
+/* See target_ops::stop_profiling.  */
+extern std::vector<profile_sample> target_stop_profiling ();
+
 /* See to_enable_btrace in struct target_ops.  */
 extern struct btrace_target_info *
   target_enable_btrace (thread_info *tp, const struct btrace_config *);
@@ -0,0 +1,60 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct s
+{
+  int x;
+  unsigned int a : 3;
+  unsigned int b : 5;
+  int y;
+  char tail[1000];
+};
+
+/* Points to a struct S whose TAIL runs into an unmapped page.  */
+struct s *straddling;
+
+void
+breakpt (void)
+{
+  /* Nothing.  */
+}
+
+int
+main (void)
+{
+  size_t pg_size = getpagesize ();
+  char *p;
+
+  p = mmap (0, 2 * pg_size, PROT_READ|PROT_WRITE,
+	    MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+  if (p == MAP_FAILED)
+    abort ();
+  munmap (p + pg_size, pg_size);
+
+  straddling = (struct s *) (p + pg_size - 16);
+  straddling->x = 1;
+  straddling->a = 5;
+  straddling->b = 17;
+  straddling->y = 2;
+
+  breakpt ();
+  return 0;
+}
@@ -0,0 +1,127 @@
+/* This test program is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Simulate a JIT that links several code entries, and notifies GDB
+   only once for all of them.  */
+
+#include <elf.h>
+#include <link.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "jit-protocol.h"
+#include "jit-elf-util.h"
+
+static void
+usage (void)
+{
+  fprintf (stderr, "Usage: jit-elf-batch libraries...\n");
+  exit (1);
+}
+
+/* Must be defined by .exp file when compiling to know
+   what address to map the ELF binary to.  */
+#ifndef LOAD_ADDRESS
+#error "Must define LOAD_ADDRESS"
+#endif
+#ifndef LOAD_INCREMENT
+#error "Must define LOAD_INCREMENT"
+#endif
+
+int
+main (int argc, char *argv[])
+{
+  int i;
+  alarm (300);
+  /* Used as backing storage for GDB to populate argv.  */
+  char *fake_argv[10];
+  struct jit_code_entry *entries[10];
+  int (*jit_functions[10]) (void);
+
+  if (argc < 2 || argc > 10)
+    {
+      usage ();
+      exit (1);
+    }
+
+  /* Link all the entries at the end of the list, without telling
+     GDB.  */
+  for (i = 1; i < argc; ++i)
+    {
+      size_t obj_size;
+      void *load_addr = (void *) (size_t) (LOAD_ADDRESS + (i - 1) * LOAD_INCREMENT);
+      printf ("Loading %s as JIT at %p\n", argv[i], load_addr);
+      void *addr = load_elf (argv[i], &obj_size, load_addr);
+
+      char name[32];
+      sprintf (name, "jit_function_%04d", i);
+      jit_functions[i] = (int (*) (void)) load_symbol (addr, name);
+
+      struct jit_code_entry *const entry = calloc (1, sizeof (*entry));
+      entry->symfile_addr = (const char *)addr;
+      entry->symfile_size = obj_size;
+      entry->prev_entry = i > 1 ? entries[i - 1] : NULL;
+      entries[i] = entry;
+
+      if (entry->prev_entry != NULL)
+	entry->prev_entry->next_entry = entry;
+      else
+	__jit_debug_descriptor.first_entry = entry;
+    }
+
+  /* Notify GDB once.  The relevant entry is in the middle of the
+     list, so GDB has to find the other new entries on both sides of
+     it.  */
+  __jit_debug_descriptor.relevant_entry = entries[(argc + 1) / 2];
+  __jit_debug_descriptor.action_flag = JIT_REGISTER;
+  __jit_debug_register_code ();
+
+  for (i = 1; i < argc; ++i)
+    if (jit_functions[i] () != 42)
+      {
+	fprintf (stderr, "unexpected return value\n");
+	exit (1);
+      }
+
+  i = 0;  /* break after register */
+
+  /* Now unregister them one by one, from the first one.  */
+  for (i = 1; i < argc; ++i)
+    {
+      struct jit_code_entry *const entry = entries[i];
+
+      __jit_debug_descriptor.first_entry = entry->next_entry;
+      if (entry->next_entry != NULL)
+	entry->next_entry->prev_entry = NULL;
+
+      /* Notify GDB.  */
+      __jit_debug_descriptor.relevant_entry = entry;
+      __jit_debug_descriptor.action_flag = JIT_UNREGISTER;
+      __jit_debug_register_code ();
+
+      free (entry);  /* break after unregister */
+    }
+
+  return 0;  /* break before return */
+}
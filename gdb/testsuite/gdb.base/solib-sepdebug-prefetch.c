@@ -0,0 +1,29 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+extern int lib_func_1 (void);
+extern int lib_func_2 (void);
+extern int lib_func_3 (void);
+extern int lib_func_4 (void);
+extern int lib_func_5 (void);
+
+int
+main (void)
+{
+  return (lib_func_1 () + lib_func_2 () + lib_func_3 () + lib_func_4 ()
+	  + lib_func_5 ());
+}
@@ -0,0 +1,70 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <assert.h>
+#include <stddef.h>
+
+/* Only the shared library defines this structure.  */
+struct opaque;
+
+struct opaque *opaque_ptr;
+
+void
+stop (void)
+{
+}
+
+/* Each frame of this function has a VLA of a different length, with
+   the same type in the debug info.  */
+
+int
+vla_frame (int n, int depth)
+{
+  int vla[n];
+  int i;
+
+  for (i = 0; i < n; i++)
+    vla[i] = n * 10 + i;
+
+  if (depth > 0)
+    return vla_frame (n + 2, depth - 1) + vla[0];
+
+  stop ();	/* vla stop */
+  return vla[0];
+}
+
+int
+main (void)
+{
+  void *handle;
+  struct opaque *(*make_opaque) (void);
+
+  vla_frame (2, 1);
+
+  stop ();	/* before dlopen */
+
+  handle = dlopen (SHLIB_NAME, RTLD_LAZY);
+  assert (handle != NULL);
+  make_opaque = (struct opaque *(*) (void)) dlsym (handle, "make_opaque");
+  assert (make_opaque != NULL);
+  opaque_ptr = make_opaque ();
+
+  stop ();	/* after dlopen */
+
+  return 0;
+}
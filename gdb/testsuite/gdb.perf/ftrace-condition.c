@@ -0,0 +1,60 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "trace-common.h"
+
+/* The number of times the fast tracepoint is hit in a round.  Set by
+   the test.  */
+volatile int hits = 1000;
+
+/* Tested by the condition of the fast tracepoint.  */
+long counter;
+
+static void
+collect_point (void)
+{
+  FAST_TRACEPOINT_LABEL(set_point);
+}
+
+static void
+begin (void)
+{
+}
+
+static void
+end (void)
+{
+}
+
+int
+main (void)
+{
+  while (1)
+    {
+      begin ();
+
+      for (int i = 0; i < hits; i++)
+	{
+	  counter = i;
+	  collect_point ();
+	}
+
+      end ();
+    }
+
+  return 0;
+}
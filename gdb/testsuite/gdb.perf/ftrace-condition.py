@@ -0,0 +1,37 @@
+# Copyright (C) 2022 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class FtraceCondition(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, hits):
+        super(FtraceCondition, self).__init__("ftrace-condition")
+        self.hits = hits
+
+    def _run(self, hits):
+        # Each round hits the fast tracepoint HITS times, from "begin"
+        # to "end".
+        gdb.execute("set variable hits = %d" % hits, False, True)
+        gdb.execute("continue", False, True)
+        gdb.execute("continue", False, True)
+
+    def warm_up(self):
+        self._run(10)
+
+    def execute_test(self):
+        for i in range(1, 5):
+            func = lambda: self._run(i * self.hits)
+            self.measure.measure(func, i * self.hits)
@@ -0,0 +1,91 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include "trace-common.h"
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 64
+#endif
+
+static pthread_barrier_t barrier;
+
+/* The number of times each thread hits the fast tracepoint in a
+   round.  Set by the test.  */
+volatile int hits = 1000;
+
+/* Collected at each hit.  */
+int counter;
+
+static void
+collect_point (void)
+{
+  FAST_TRACEPOINT_LABEL(set_point);
+  counter++;
+}
+
+static void *
+thread_function (void *arg)
+{
+  while (1)
+    {
+      /* Wait for the round to start.  */
+      pthread_barrier_wait (&barrier);
+
+      for (int i = 0; i < hits; i++)
+	collect_point ();
+
+      pthread_barrier_wait (&barrier);
+    }
+
+  return NULL;
+}
+
+static void
+begin (void)
+{
+}
+
+static void
+end (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+
+  while (1)
+    {
+      begin ();
+
+      /* Start a round, and wait for all threads to finish it.  */
+      pthread_barrier_wait (&barrier);
+      pthread_barrier_wait (&barrier);
+
+      end ();
+    }
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jit-protocol.h"
+
+/* The symbol file registered for every code entry.  The same file is
+   used for all of them, as only the cost of the registration itself
+   is measured.  */
+
+static char *symfile;
+static long symfile_size;
+
+static struct jit_code_entry *entries;
+static int entry_count;
+
+/* Register NUMBER code entries, notifying GDB once every BATCH
+   entries.  */
+
+void
+do_test_register (int number, int batch)
+{
+  int i;
+
+  entries = calloc (number, sizeof (*entries));
+  if (entries == NULL)
+    {
+      printf ("ERROR on calloc\n");
+      exit (-1);
+    }
+  entry_count = number;
+
+  for (i = 0; i < number; i++)
+    {
+      /* Link the entry at the end of the list.  */
+      struct jit_code_entry *entry = &entries[i];
+
+      entry->symfile_addr = symfile;
+      entry->symfile_size = symfile_size;
+      entry->prev_entry = i > 0 ? &entries[i - 1] : NULL;
+      if (entry->prev_entry != NULL)
+	entry->prev_entry->next_entry = entry;
+      else
+	__jit_debug_descriptor.first_entry = entry;
+
+      if ((i + 1) % batch == 0 || i + 1 == number)
+	{
+	  __jit_debug_descriptor.relevant_entry = entry;
+	  __jit_debug_descriptor.action_flag = JIT_REGISTER;
+	  __jit_debug_register_code ();
+	}
+    }
+}
+
+/* Unregister all the entries, from the last to the first.  */
+
+void
+do_test_unregister (void)
+{
+  int i;
+
+  for (i = entry_count - 1; i >= 0; i--)
+    {
+      struct jit_code_entry *entry = &entries[i];
+
+      if (entry->prev_entry != NULL)
+	entry->prev_entry->next_entry = NULL;
+      else
+	__jit_debug_descriptor.first_entry = NULL;
+
+      __jit_debug_descriptor.relevant_entry = entry;
+      __jit_debug_descriptor.action_flag = JIT_UNREGISTER;
+      __jit_debug_register_code ();
+    }
+
+  free (entries);
+  entries = NULL;
+  entry_count = 0;
+}
+
+int
+main (void)
+{
+  FILE *f = fopen (JIT_SYMFILE, "rb");
+
+  if (f == NULL
+      || fseek (f, 0, SEEK_END) != 0
+      || (symfile_size = ftell (f)) <= 0
+      || fseek (f, 0, SEEK_SET) != 0)
+    {
+      printf ("ERROR on reading %s\n", JIT_SYMFILE);
+      exit (-1);
+    }
+
+  symfile = malloc (symfile_size);
+  if (symfile == NULL
+      || fread (symfile, 1, symfile_size, f) != (size_t) symfile_size)
+    {
+      printf ("ERROR on reading %s\n", JIT_SYMFILE);
+      exit (-1);
+    }
+  fclose (f);
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+# Copyright (C) 2022 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when the inferior
+# registers many pieces of code through the JIT debug interface.
+
+from perftest import perftest
+
+
+class JitRegisterMany1(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, entry_count, batch_size):
+        if batch_size == 1:
+            name = "jit_register"
+        else:
+            name = "jit_register_batch_%d" % batch_size
+        super(JitRegisterMany1, self).__init__(name)
+        self.entry_count = entry_count
+        self.batch_size = batch_size
+
+    def warm_up(self):
+        gdb.execute("call do_test_register (%d, %d)" % (self.entry_count, 1))
+        gdb.execute("call do_test_unregister ()")
+
+    def execute_test(self):
+        num = self.entry_count
+        iteration = 5
+
+        while num > 0 and iteration > 0:
+            do_test_register = "call do_test_register (%d, %d)" % (
+                num,
+                self.batch_size,
+            )
+            func = lambda: gdb.execute(do_test_register)
+            self.measure.measure(func, num)
+
+            gdb.execute("call do_test_unregister ()")
+
+            num = num // 2
+            iteration -= 1
+
+
+class JitRegisterMany(object):
+    def __init__(self, entry_count, batch_size):
+        self.entry_count = entry_count
+        self.batch_size = batch_size
+
+    def run(self):
+        JitRegisterMany1(self.entry_count, 1).run()
+        JitRegisterMany1(self.entry_count, self.batch_size).run()
@@ -0,0 +1,48 @@
+# Copyright (C) 2022 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when the inferior loads
+# many shared libraries one at a time, while many breakpoints are set.
+
+from perftest import perftest
+
+
+class SolibBreakpoints(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, solib_count, breakpoint_count):
+        super(SolibBreakpoints, self).__init__("solib_breakpoints")
+        self.solib_count = solib_count
+        self.breakpoint_count = breakpoint_count
+
+    def warm_up(self):
+        # The breakpoints are pending until their library is loaded.
+        for i in range(self.breakpoint_count):
+            gdb.Breakpoint("shr%d" % (i % self.solib_count))
+
+        gdb.execute("call do_test_load (%d)" % self.solib_count)
+        gdb.execute("call do_test_unload (%d)" % self.solib_count)
+
+    def execute_test(self):
+        num = self.solib_count
+        iteration = 5
+
+        while num > 0 and iteration > 0:
+            do_test_load = "call do_test_load (%d)" % num
+            func = lambda: gdb.execute(do_test_load)
+            self.measure.measure(func, num)
+
+            gdb.execute("call do_test_unload (%d)" % num)
+
+            num = num // 2
+            iteration -= 1
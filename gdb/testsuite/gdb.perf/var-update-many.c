@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef NUM_VARS
+#define NUM_VARS 10000
+#endif
+
+int values[NUM_VARS];
+
+volatile int flag = 1;
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i = 0;
+
+  marker (); /* all values set */
+
+  /* Only a few values change between two stops, like in a typical
+     watch window.  */
+  while (flag)
+    {
+      values[i % NUM_VARS]++;
+      i++;
+      marker ();
+    }
+
+  return 0;
+}
@@ -0,0 +1,44 @@
+# Copyright (C) 2022 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+def mi(command):
+    gdb.execute('interpreter-exec mi "%s"' % command, False, True)
+
+
+class VarUpdateMany(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, num_vars, count):
+        super(VarUpdateMany, self).__init__("var-update-many")
+        self.num_vars = num_vars
+        self.count = count
+
+    def warm_up(self):
+        for i in range(0, self.num_vars):
+            mi("-var-create v%d * values[%d]" % (i, i))
+        mi("-var-update --all-values *")
+
+    def _run(self, r):
+        # Each stop is followed by an update of every varobj, like an
+        # IDE refreshing its watch window.
+        for _ in range(0, r):
+            gdb.execute("continue", False, True)
+            mi("-var-update --all-values *")
+
+    def execute_test(self):
+        for i in range(1, 5):
+            func = lambda: self._run(i * self.count)
+            self.measure.measure(func, i * self.count)
@@ -0,0 +1,73 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdbool.h>
+
+enum color { RED, GREEN, BLUE };
+
+struct point
+{
+  int x;
+  int y;
+};
+
+struct packed
+{
+  unsigned int a : 3;
+  int b : 5;
+  unsigned int c : 24;
+};
+
+struct all
+{
+  char ch;
+  unsigned char uch;
+  short sh;
+  long l;
+  unsigned long long ull;
+  bool flag;
+  enum color color;
+  float f;
+  double d;
+  struct point p;
+  struct packed bits;
+  int arr[3];
+  struct point points[2];
+  int grid[2][2];
+  union
+  {
+    int i;
+    unsigned int u;
+  };
+  struct point *ptr;
+};
+
+struct all all =
+  {
+    'x', 200, -3, -100000, 0xffffffffffffffffULL, true, BLUE, 1.5, -2.25,
+    { 1, 2 }, { 5, -7, 123456 }, { 10, 20, 30 }, { { 3, 4 }, { 5, 6 } },
+    { { 1, 2 }, { 3, 4 } }, { -1 }, 0
+  };
+
+int empty[0];
+
+int
+main (void)
+{
+  all.ptr = &all.p;
+  return 0;
+}
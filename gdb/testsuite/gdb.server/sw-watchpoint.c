@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int global_var;
+volatile int other_var;
+
+static void __attribute__ ((noinline))
+change (int value)
+{
+  global_var = value;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 100; i++)	/* start here */
+    other_var += i;
+
+  global_var = 1;
+  other_var = 0;		/* after first change */
+  change (2);			/* next over call */
+  other_var = 1;		/* after call */
+  global_var = 3; other_var = 2; /* next over store */
+  other_var = 3;		/* after store */
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "trace-common.h"
+#include <inttypes.h>
+
+int64_t globvar;
+uint64_t uglobvar;
+
+int array[16];
+int *arrayp = array;
+
+char string[] = "abcdefghijklmnop";
+char *stringp = string;
+
+static void
+begin (void)
+{
+}
+
+static void
+marker (void)
+{
+  FAST_TRACEPOINT_LABEL(set_point);
+}
+
+static void
+end (void)
+{
+}
+
+int
+main ()
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    array[i] = i * i;
+
+  begin ();
+
+  for (globvar = -8; globvar < 8; ++globvar)
+    {
+      uglobvar = (uint64_t) globvar;
+      marker ();
+    }
+
+  end ();
+  return 0;
+}
@@ -0,0 +1,73 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2022 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int val;
+
+/* A function with many lines, so that the disassembly window stops
+   far from its start.  */
+
+void
+long_function (void)
+{
+  val = val + 1;
+  val = val + 2;
+  val = val + 3;
+  val = val + 4;
+  val = val + 5;
+  val = val + 6;
+  val = val + 7;
+  val = val + 8;
+  val = val + 9;
+  val = val + 10;
+  val = val + 11;
+  val = val + 12;
+  val = val + 13;
+  val = val + 14;
+  val = val + 15;
+  val = val + 16;
+  val = val + 17;
+  val = val + 18;
+  val = val + 19;
+  val = val + 20;
+  val = val + 21;
+  val = val + 22;
+  val = val + 23;
+  val = val + 24;
+  val = val + 25;
+  val = val + 26;
+  val = val + 27;
+  val = val + 28;
+  val = val + 29;
+  val = val + 30;  /* break here */
+  val = val + 31;
+  val = val + 32;
+  val = val + 33;
+  val = val + 34;
+  val = val + 35;
+  val = val + 36;
+  val = val + 37;
+  val = val + 38;
+  val = val + 39;
+  val = val + 40;
+}
+
+int
+main ()
+{
+  long_function ();
+  return 0;
+}
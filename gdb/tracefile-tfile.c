@@ -34,6 +34,8 @@
 #include "gdbsupport/buffer.h"
 #include "gdbsupport/pathstuff.h"
 #include <algorithm>
+#include <map>
+#include <sys/stat.h>
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -72,6 +74,21 @@ class tfile_target final : public tracefile_target
 			      struct uploaded_tp *utp) override;
 };
 
+/* The size of the header of a traceframe: the tracepoint number and
+   the size of the traceframe's data.  */
+
+#define TFILE_FRAME_HEADER_SIZE 6
+
+/* The size of an entry of the traceframe index, and of the trailer at
+   the end of the index.  */
+
+#define TFILE_INDEX_ENTRY_SIZE 10
+#define TFILE_INDEX_TRAILER_SIZE 24
+
+/* The last bytes of the trailer of the traceframe index.  */
+
+#define TFILE_INDEX_MAGIC "\x7fINDEX0\n"
+
 /* TFILE trace writer.  */
 
 struct tfile_trace_file_writer
@@ -82,6 +99,18 @@ struct tfile_trace_file_writer
   FILE *fp;
   /* Path name of the tfile trace file.  */
   char *pathname;
+
+  /* How many bytes of trace frames were written so far.  */
+  ULONGEST data_offset;
+  /* The offset of the next traceframe in the trace frames, and the
+     part of its header written so far.  */
+  ULONGEST next_frame;
+  gdb_byte frame_header[TFILE_FRAME_HEADER_SIZE];
+  int frame_header_len;
+  /* The index of the traceframes written so far, in the format it has
+     in the file, and its number of entries.  */
+  struct buffer index;
+  ULONGEST index_count;
 };
 
 /* This is the implementation of trace_file_write_ops method
@@ -107,6 +136,7 @@ tfile_dtor (struct trace_file_writer *self)
     = (struct tfile_trace_file_writer *) self;
 
   xfree (writer->pathname);
+  buffer_free (&writer->index);
 
   if (writer->fp != NULL)
     fclose (writer->fp);
@@ -348,6 +378,54 @@ tfile_write_definition_end (struct trace_file_writer *self)
   fprintf (writer->fp, "\n");
 }
 
+/* Add the traceframes that start in BUF, the next LEN bytes of the
+   trace frames, to WRITER's index.  */
+
+static void
+tfile_index_raw_data (struct tfile_trace_file_writer *writer,
+		      const gdb_byte *buf, LONGEST len)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  ULONGEST end = writer->data_offset + len;
+
+  while (writer->next_frame < end)
+    {
+      /* The header of a traceframe may be split between writes.  */
+      ULONGEST pos = writer->next_frame + writer->frame_header_len;
+      int n = std::min<ULONGEST> (TFILE_FRAME_HEADER_SIZE
+				  - writer->frame_header_len, end - pos);
+
+      memcpy (writer->frame_header + writer->frame_header_len,
+	      buf + (pos - writer->data_offset), n);
+      writer->frame_header_len += n;
+      if (writer->frame_header_len < TFILE_FRAME_HEADER_SIZE)
+	break;
+
+      int tpnum = extract_signed_integer (writer->frame_header, 2,
+					  byte_order);
+      ULONGEST size = extract_unsigned_integer (writer->frame_header + 2,
+						4, byte_order);
+      gdb_byte entry[TFILE_INDEX_ENTRY_SIZE];
+
+      /* Don't index past a premature end of the trace frames.  */
+      if (tpnum == 0)
+	{
+	  writer->next_frame = ULONGEST_MAX;
+	  break;
+	}
+
+      store_unsigned_integer (entry, 8, byte_order, writer->next_frame);
+      store_signed_integer (entry + 8, 2, byte_order, tpnum);
+      buffer_grow (&writer->index, (const char *) entry, sizeof (entry));
+      writer->index_count++;
+
+      writer->next_frame += TFILE_FRAME_HEADER_SIZE + size;
+      writer->frame_header_len = 0;
+    }
+
+  writer->data_offset = end;
+}
+
 /* This is the implementation of trace_file_write_ops method
    write_raw_data.  */
 
@@ -360,6 +438,8 @@ tfile_write_raw_data (struct trace_file_writer *self, gdb_byte *buf,
 
   if (fwrite (buf, len, 1, writer->fp) < 1)
     perror_with_name (writer->pathname);
+
+  tfile_index_raw_data (writer, buf, len);
 }
 
 /* This is the implementation of trace_file_write_ops method
@@ -375,6 +455,25 @@ tfile_end (struct trace_file_writer *self)
   /* Mark the end of trace data.  */
   if (fwrite (&gotten, 4, 1, writer->fp) < 1)
     perror_with_name (writer->pathname);
+
+  /* Follow it with the index of the traceframes, unless the trace
+     data ended in the middle of one.  Readers that don't know about
+     the index stop at the end mark.  */
+  if (writer->next_frame != writer->data_offset)
+    return;
+
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  gdb_byte trailer[TFILE_INDEX_TRAILER_SIZE];
+
+  store_unsigned_integer (trailer, 8, byte_order, writer->index_count);
+  store_unsigned_integer (trailer + 8, 8, byte_order, writer->data_offset);
+  memcpy (trailer + 16, TFILE_INDEX_MAGIC, 8);
+
+  if ((writer->index.used_size > 0
+       && fwrite (writer->index.buffer, writer->index.used_size, 1,
+		  writer->fp) < 1)
+      || fwrite (trailer, sizeof (trailer), 1, writer->fp) < 1)
+    perror_with_name (writer->pathname);
 }
 
 /* Operations to write trace buffers into TFILE format.  */
@@ -407,6 +506,11 @@ tfile_trace_file_writer_new (void)
   writer->base.ops = &tfile_write_ops;
   writer->fp = NULL;
   writer->pathname = NULL;
+  writer->data_offset = 0;
+  writer->next_frame = 0;
+  writer->frame_header_len = 0;
+  buffer_init (&writer->index);
+  writer->index_count = 0;
 
   return (struct trace_file_writer *) writer;
 }
@@ -427,6 +531,28 @@ static int cur_data_size;
 int trace_regblock_size;
 static struct buffer trace_tdesc;
 
+/* A traceframe in the trace file.  */
+
+struct tfile_traceframe
+{
+  /* The offset of the traceframe from TRACE_FRAMES_OFFSET.  */
+  ULONGEST offset;
+
+  /* The number of the tracepoint that collected it, on the target.  */
+  int tpnum;
+};
+
+/* All the traceframes in the trace file, by traceframe number, and
+   whether they were looked for yet.  They come from the index at the
+   end of the file if there is one, or else from walking the trace
+   frames, the first time a traceframe is looked up.  */
+static std::vector<tfile_traceframe> tfile_traceframes;
+static bool tfile_traceframes_loaded;
+
+/* The numbers of the traceframes each tracepoint collected, in
+   increasing order, by tracepoint number on the target.  */
+static std::map<int, std::vector<int>> tfile_tracepoint_traceframes;
+
 static void tfile_append_tdesc_line (const char *line);
 static void tfile_interp_line (char *line,
 			       struct uploaded_tp **utpp,
@@ -627,6 +753,9 @@ tfile_target::close ()
   xfree (trace_filename);
   trace_filename = NULL;
   buffer_free (&trace_tdesc);
+  tfile_traceframes.clear ();
+  tfile_tracepoint_traceframes.clear ();
+  tfile_traceframes_loaded = false;
 
   trace_reset_local_state ();
 }
@@ -644,54 +773,171 @@ tfile_target::get_tracepoint_status (struct breakpoint *tp, struct uploaded_tp *
      trace files, so nothing to do here.  */
 }
 
-/* Given the position of a traceframe in the file, figure out what
-   address the frame was collected at.  This would normally be the
-   value of a collected PC register, but if not available, we
-   improvise.  */
+/* Given the number of the tracepoint that collected a traceframe,
+   figure out what address the frame was collected at.  This would
+   normally be the value of a collected PC register, but if not
+   available, we improvise.  */
 
 static CORE_ADDR
-tfile_get_traceframe_address (off_t tframe_offset)
+tfile_get_traceframe_address (int tpnum)
 {
   CORE_ADDR addr = 0;
-  short tpnum;
   struct tracepoint *tp;
-  off_t saved_offset = cur_offset;
 
   /* FIXME dig pc out of collected registers.  */
 
   /* Fall back to using tracepoint address.  */
-  lseek (trace_fd, tframe_offset, SEEK_SET);
-  tfile_read ((gdb_byte *) &tpnum, 2);
-  tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					  gdbarch_byte_order
-					      (target_gdbarch ()));
-
   tp = get_tracepoint_by_number_on_target (tpnum);
   /* FIXME this is a poor heuristic if multiple locations.  */
   if (tp && tp->loc)
     addr = tp->loc->address;
 
-  /* Restore our seek position.  */
-  cur_offset = saved_offset;
-  lseek (trace_fd, cur_offset, SEEK_SET);
   return addr;
 }
 
-/* Given a type of search and some parameters, scan the collection of
-   traceframes in the file looking for a match.  When found, return
-   both the traceframe and tracepoint number, otherwise -1 for
-   each.  */
+/* Read the traceframe index at the end of the trace file into
+   TFILE_TRACEFRAMES.  Return false if there is no valid index.  */
+
+static bool
+tfile_read_traceframe_index ()
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  gdb_byte trailer[TFILE_INDEX_TRAILER_SIZE];
+  struct stat st;
+
+  if (fstat (trace_fd, &st) < 0
+      || st.st_size < trace_frames_offset + 4 + TFILE_INDEX_TRAILER_SIZE)
+    return false;
+
+  lseek (trace_fd, st.st_size - TFILE_INDEX_TRAILER_SIZE, SEEK_SET);
+  tfile_read (trailer, TFILE_INDEX_TRAILER_SIZE);
+  if (memcmp (trailer + 16, TFILE_INDEX_MAGIC, 8) != 0)
+    return false;
+
+  ULONGEST count = extract_unsigned_integer (trailer, 8, byte_order);
+  ULONGEST end = extract_unsigned_integer (trailer + 8, 8, byte_order);
+
+  /* The index must directly follow the end mark of the trace
+     frames.  */
+  if (count > INT_MAX
+      || (trace_frames_offset + end + 4 + count * TFILE_INDEX_ENTRY_SIZE
+	  + TFILE_INDEX_TRAILER_SIZE) != st.st_size)
+    return false;
+
+  gdb::byte_vector index (count * TFILE_INDEX_ENTRY_SIZE);
+
+  lseek (trace_fd, trace_frames_offset + end + 4, SEEK_SET);
+  tfile_read (index.data (), index.size ());
+
+  tfile_traceframes.resize (count);
+  for (ULONGEST i = 0; i < count; i++)
+    {
+      const gdb_byte *entry = &index[i * TFILE_INDEX_ENTRY_SIZE];
+      tfile_traceframe &tf = tfile_traceframes[i];
+
+      tf.offset = extract_unsigned_integer (entry, 8, byte_order);
+      tf.tpnum = extract_signed_integer (entry + 8, 2, byte_order);
+      if (tf.offset >= end
+	  || (i > 0 && tf.offset <= tfile_traceframes[i - 1].offset))
+	{
+	  tfile_traceframes.clear ();
+	  return false;
+	}
+    }
+
+  return true;
+}
+
+/* Fill TFILE_TRACEFRAMES by walking the trace frames.  */
+
+static void
+tfile_walk_traceframes ()
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  off_t offset = trace_frames_offset;
+
+  lseek (trace_fd, offset, SEEK_SET);
+  while (1)
+    {
+      gdb_byte header[TFILE_FRAME_HEADER_SIZE];
+      short tpnum;
+      unsigned int data_size;
+
+      tfile_read (header, 2);
+      tpnum = (short) extract_signed_integer (header, 2, byte_order);
+      if (tpnum == 0)
+	break;
+      tfile_read (header + 2, 4);
+      data_size = (unsigned int) extract_unsigned_integer (header + 2, 4,
+							  byte_order);
+
+      tfile_traceframes.push_back ({ (ULONGEST) (offset
+						 - trace_frames_offset),
+				     tpnum });
+
+      /* Skip past the traceframe's data.  */
+      offset += TFILE_FRAME_HEADER_SIZE + data_size;
+      lseek (trace_fd, offset, SEEK_SET);
+    }
+}
+
+/* Find the traceframes of the trace file, if not done yet.  */
+
+static void
+tfile_load_traceframes ()
+{
+  if (tfile_traceframes_loaded)
+    return;
+
+  if (!tfile_read_traceframe_index ())
+    tfile_walk_traceframes ();
+
+  for (int i = 0; i < tfile_traceframes.size (); i++)
+    tfile_tracepoint_traceframes[tfile_traceframes[i].tpnum].push_back (i);
+
+  tfile_traceframes_loaded = true;
+}
+
+/* Return true if the traceframes collected by the tracepoint numbered
+   TPNUM on the target match a search of type TYPE, for the NUM, ADDR1
+   and ADDR2 arguments of trace_find.  */
+
+static bool
+tfile_tracepoint_matches (enum trace_find_type type, int num, int tpnum,
+			  CORE_ADDR addr1, CORE_ADDR addr2)
+{
+  struct tracepoint *tp;
+  CORE_ADDR tfaddr;
+
+  switch (type)
+    {
+    case tfind_pc:
+      tfaddr = tfile_get_traceframe_address (tpnum);
+      return tfaddr == addr1;
+    case tfind_tp:
+      tp = get_tracepoint (num);
+      return tp && tpnum == tp->number_on_target;
+    case tfind_range:
+      tfaddr = tfile_get_traceframe_address (tpnum);
+      return addr1 <= tfaddr && tfaddr <= addr2;
+    case tfind_outside:
+      tfaddr = tfile_get_traceframe_address (tpnum);
+      return !(addr1 <= tfaddr && tfaddr <= addr2);
+    default:
+      internal_error (__FILE__, __LINE__, _("unknown tfind type"));
+    }
+}
+
+/* Given a type of search and some parameters, look up the collection
+   of traceframes in the file for a match.  When found, return both
+   the traceframe and tracepoint number, otherwise -1 for each.  */
 
 int
 tfile_target::trace_find (enum trace_find_type type, int num,
 			  CORE_ADDR addr1, CORE_ADDR addr2, int *tpp)
 {
-  short tpnum;
-  int tfnum = 0, found = 0;
+  int tfnum = -1;
   unsigned int data_size;
-  struct tracepoint *tp;
-  off_t offset, tframe_offset;
-  CORE_ADDR tfaddr;
 
   if (num == -1)
     {
@@ -700,82 +946,54 @@ tfile_target::trace_find (enum trace_find_type type, int num,
       return -1;
     }
 
-  lseek (trace_fd, trace_frames_offset, SEEK_SET);
-  offset = trace_frames_offset;
-  while (1)
+  tfile_load_traceframes ();
+
+  if (type == tfind_number)
     {
-      tframe_offset = offset;
-      tfile_read ((gdb_byte *) &tpnum, 2);
-      tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					      gdbarch_byte_order
-						  (target_gdbarch ()));
-      offset += 2;
-      if (tpnum == 0)
-	break;
-      tfile_read ((gdb_byte *) &data_size, 4);
-      data_size = (unsigned int) extract_unsigned_integer
-				     ((gdb_byte *) &data_size, 4,
-				      gdbarch_byte_order (target_gdbarch ()));
-      offset += 4;
+      /* Looking for a specific trace frame.  */
+      if (num >= 0 && num < tfile_traceframes.size ())
+	tfnum = num;
+    }
+  else
+    {
+      /* Look for the first traceframe after the current one among
+	 those of each matching tracepoint.  */
+      int current = get_traceframe_number ();
 
-      if (type == tfind_number)
-	{
-	  /* Looking for a specific trace frame.  */
-	  if (tfnum == num)
-	    found = 1;
-	}
-      else
+      for (const auto &iter : tfile_tracepoint_traceframes)
 	{
-	  /* Start from the _next_ trace frame.  */
-	  if (tfnum > get_traceframe_number ())
-	    {
-	      switch (type)
-		{
-		case tfind_pc:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (tfaddr == addr1)
-		    found = 1;
-		  break;
-		case tfind_tp:
-		  tp = get_tracepoint (num);
-		  if (tp && tpnum == tp->number_on_target)
-		    found = 1;
-		  break;
-		case tfind_range:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (addr1 <= tfaddr && tfaddr <= addr2)
-		    found = 1;
-		  break;
-		case tfind_outside:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (!(addr1 <= tfaddr && tfaddr <= addr2))
-		    found = 1;
-		  break;
-		default:
-		  internal_error (__FILE__, __LINE__, _("unknown tfind type"));
-		}
-	    }
-	}
+	  const std::vector<int> &tfnums = iter.second;
 
-      if (found)
-	{
-	  if (tpp)
-	    *tpp = tpnum;
-	  cur_offset = offset;
-	  cur_data_size = data_size;
+	  if (!tfile_tracepoint_matches (type, num, iter.first, addr1, addr2))
+	    continue;
 
-	  return tfnum;
+	  auto next = std::upper_bound (tfnums.begin (), tfnums.end (),
+					current);
+	  if (next != tfnums.end () && (tfnum == -1 || *next < tfnum))
+	    tfnum = *next;
 	}
-      /* Skip past the traceframe's data.  */
-      lseek (trace_fd, data_size, SEEK_CUR);
-      offset += data_size;
-      /* Update our own count of traceframes.  */
-      ++tfnum;
     }
-  /* Did not find what we were looking for.  */
+
+  if (tfnum == -1)
+    {
+      /* Did not find what we were looking for.  */
+      if (tpp)
+	*tpp = -1;
+      return -1;
+    }
+
+  const tfile_traceframe &tf = tfile_traceframes[tfnum];
+
+  cur_offset = trace_frames_offset + tf.offset + TFILE_FRAME_HEADER_SIZE;
+  lseek (trace_fd, cur_offset - 4, SEEK_SET);
+  tfile_read ((gdb_byte *) &data_size, 4);
+  cur_data_size = (unsigned int) extract_unsigned_integer
+				   ((gdb_byte *) &data_size, 4,
+				    gdbarch_byte_order (target_gdbarch ()));
   if (tpp)
-    *tpp = -1;
-  return -1;
+    *tpp = tf.tpnum;
+
+  return tfnum;
 }
 
 /* Prototype of the callback passed to tframe_walk_blocks.  */
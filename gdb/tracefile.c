@@ -134,8 +134,17 @@ trace_save (const char *filename, struct trace_file_writer *writer,
   /* Mark the end of the definition section.  */
   writer->ops->write_definition_end (writer);
 
+  /* If the writer takes the trace buffer as is, have the target send
+     all of it at once, if it can.  */
+  bool done = false;
+  if (writer->ops->write_trace_buffer != NULL)
+    done = target_get_trace_buffer ([&] (const gdb_byte *data, size_t len)
+      {
+	writer->ops->write_trace_buffer (writer, (gdb_byte *) data, len);
+      });
+
   /* Get and write the trace data proper.  */
-  while (1)
+  while (!done)
     {
       LONGEST gotten = 0;
 
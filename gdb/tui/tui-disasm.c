@@ -156,14 +156,21 @@ tui_disassemble (struct gdbarch *gdbarch,
 
 /* Look backward from ADDR for an address from which we can start
    disassembling, this needs to be something we can be reasonably
-   confident will fall on an instruction boundary.  We use msymbol
-   addresses, or the start of a section.  */
+   confident will fall on an instruction boundary.  We use the start of
+   the line table entry before ADDR, msymbol addresses, or the start of
+   a section.  */
 
 static CORE_ADDR
 tui_find_backward_disassembly_start_address (CORE_ADDR addr)
 {
   struct bound_minimal_symbol msym, msym_prev;
 
+  /* Line table entries are usually much closer to ADDR than the start
+     of the function, which matters for very large functions.  */
+  symtab_and_line sal = find_pc_line (addr - 1, 0);
+  if (sal.symtab != nullptr && sal.pc != 0 && sal.pc < addr)
+    return sal.pc;
+
   msym = lookup_minimal_symbol_by_pc_section (addr - 1, nullptr,
 					      lookup_msym_prefer::TEXT,
 					      &msym_prev);
@@ -141,6 +141,10 @@ tui_copy_source_line (const char **ptr, int *length)
 void
 tui_source_window_base::style_changed ()
 {
+  /* The lines on the pad were drawn with the old styles, so none of
+     them can be kept.  */
+  m_drawn_lines.clear ();
+
   if (tui_active && is_visible ())
     refill ();
 }
@@ -239,13 +243,27 @@ tui_source_window_base::show_source_line (int lineno)
   struct tui_source_element *line;
 
   line = &m_content[lineno];
+
+  /* Nothing to do if the pad already shows this line.  */
+  if (lineno < m_drawn_lines.size ()
+      && m_drawn_lines[lineno].is_exec_point == line->is_exec_point
+      && m_drawn_lines[lineno].line == line->line)
+    return;
+
+  wmove (m_pad.get (), lineno, 0);
+  wclrtoeol (m_pad.get ());
+
   if (line->is_exec_point)
     tui_set_reverse_mode (m_pad.get (), true);
 
-  wmove (m_pad.get (), lineno, 0);
   tui_puts (line->line.c_str (), m_pad.get ());
   if (line->is_exec_point)
     tui_set_reverse_mode (m_pad.get (), false);
+
+  if (lineno >= m_drawn_lines.size ())
+    m_drawn_lines.resize (lineno + 1);
+  m_drawn_lines[lineno].line = line->line;
+  m_drawn_lines[lineno].is_exec_point = line->is_exec_point;
 }
 
 /* See tui-winsource.h.  */
@@ -278,11 +296,24 @@ tui_source_window_base::show_source_content ()
   int pad_width = std::max (m_max_length, width);
   if (m_pad == nullptr || pad_width > getmaxx (m_pad.get ())
       || m_content.size () > getmaxy (m_pad.get ()))
-    m_pad.reset (newpad (m_content.size (), pad_width));
+    {
+      m_pad.reset (newpad (m_content.size (), pad_width));
+      m_drawn_lines.clear ();
+    }
 
-  werase (m_pad.get ());
+  /* Only redraw the lines that changed, and erase the lines that are
+     no longer part of the content.  */
   for (int lineno = 0; lineno < m_content.size (); lineno++)
     show_source_line (lineno);
+  for (int lineno = m_content.size ();
+       lineno < m_drawn_lines.size ();
+       lineno++)
+    {
+      wmove (m_pad.get (), lineno, 0);
+      wclrtoeol (m_pad.get ());
+    }
+  if (m_drawn_lines.size () > m_content.size ())
+    m_drawn_lines.resize (m_content.size ());
 
   refresh_window ();
 }
@@ -415,8 +446,14 @@ tui_source_window_base::set_is_exec_point_at (struct tui_line_or_address l)
 	}
       i++;
     }
+
+  /* The content itself didn't change, so only the lines whose
+     highlighting changed need to be redrawn.  */
   if (changed)
-    refill ();
+    {
+      show_source_content ();
+      update_exec_info ();
+    }
 }
 
 /* See tui-winsource.h.  */
@@ -189,6 +189,17 @@ struct tui_source_window_base : public tui_win_info
 
   /* Pad used to display fixme mumble  */
   std::unique_ptr<WINDOW, curses_deleter> m_pad;
+
+  /* A line as last drawn on the pad.  */
+  struct drawn_line
+  {
+    std::string line;
+    bool is_exec_point = false;
+  };
+
+  /* The lines currently drawn on the pad, so that only the lines that
+     changed need to be redrawn.  */
+  std::vector<drawn_line> m_drawn_lines;
 };
 
 
@@ -0,0 +1,341 @@
+/* Self tests for the event loop.
+
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/event-loop.h"
+#include "top.h"
+#include <fcntl.h>
+#include <memory>
+#include <vector>
+
+#ifndef USE_WIN32API
+
+namespace selftests {
+namespace event_loop_tests {
+
+/* A pipe whose read end is monitored by the event loop.  */
+
+struct test_pipe
+{
+  test_pipe ()
+  {
+    if (pipe (fds) != 0)
+      fds[0] = fds[1] = -1;
+    else
+      fcntl (fds[0], F_SETFL, O_NONBLOCK);
+  }
+
+  ~test_pipe ()
+  {
+    if (fds[0] != -1)
+      {
+	delete_file_handler (fds[0]);
+	close (fds[0]);
+	close (fds[1]);
+      }
+  }
+
+  DISABLE_COPY_AND_ASSIGN (test_pipe);
+
+  /* Make the read end readable.  */
+  void poke ()
+  {
+    char c = 0;
+    SELF_CHECK (write (fds[1], &c, 1) == 1);
+  }
+
+  int fds[2];
+
+  /* The number of times the handler consumed a byte.  */
+  int count = 0;
+
+  /* If not NULL, the handler stops monitoring this pipe.  */
+  test_pipe *victim = nullptr;
+};
+
+/* The total number of times a pipe handler was called.  */
+
+static int events_handled;
+
+static void
+pipe_handler (int error, gdb_client_data client_data)
+{
+  test_pipe *p = (test_pipe *) client_data;
+  char c;
+
+  if (read (p->fds[0], &c, 1) == 1)
+    p->count++;
+  events_handled++;
+
+  if (p->victim != nullptr)
+    {
+      delete_file_handler (p->victim->fds[0]);
+      p->victim->victim = nullptr;
+      p->victim = nullptr;
+    }
+}
+
+/* Create up to N pipes monitored by the event loop.  Fewer pipes are
+   created if we run out of file descriptors.  */
+
+static std::vector<std::unique_ptr<test_pipe>>
+make_pipes (int n)
+{
+  std::vector<std::unique_ptr<test_pipe>> pipes;
+
+  for (int i = 0; i < n; ++i)
+    {
+      std::unique_ptr<test_pipe> p (new test_pipe);
+      if (p->fds[0] == -1)
+	break;
+      add_file_handler (p->fds[0], pipe_handler, p.get (),
+			string_printf ("test pipe %d", i));
+      pipes.push_back (std::move (p));
+    }
+
+  return pipes;
+}
+
+/* While an instance of this class is alive, the input of the user
+   interfaces is not read, so that running the event loop only
+   dispatches the events of the test's file handlers and timers, and
+   does not execute the commands that follow "maint selftest".  */
+
+class scoped_disable_ui_input
+{
+public:
+
+  scoped_disable_ui_input ()
+  {
+    for (ui *ui : all_uis ())
+      if (ui->prompt_state != PROMPT_BLOCKED)
+	{
+	  ui_unregister_input_event_handler (ui);
+	  m_uis.push_back (ui);
+	}
+  }
+
+  ~scoped_disable_ui_input ()
+  {
+    for (ui *ui : m_uis)
+      ui_register_input_event_handler (ui);
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_disable_ui_input);
+
+private:
+
+  std::vector<ui *> m_uis;
+};
+
+static void
+timeout_handler (gdb_client_data client_data)
+{
+  *(bool *) client_data = true;
+}
+
+/* Run the event loop until DONE returns true, or for at most
+   TIMEOUT_MS milliseconds.  Return the number of times the event loop
+   ran.  */
+
+template<typename Callback>
+static int
+run_until (Callback done, int timeout_ms = 10000)
+{
+  scoped_disable_ui_input disable_ui_input;
+  bool timed_out = false;
+  int timer = create_timer (timeout_ms, timeout_handler, &timed_out);
+  int iterations = 0;
+
+  while (!done () && !timed_out && gdb_do_one_event () >= 0)
+    iterations++;
+
+  delete_timer (timer);
+  return iterations;
+}
+
+/* Run the event loop until EVENTS_HANDLED reaches N, or for at most
+   TIMEOUT_MS milliseconds.  */
+
+static void
+run_until_handled (int n, int timeout_ms = 10000)
+{
+  run_until ([=] () { return events_handled >= n; }, timeout_ms);
+}
+
+/* Check that each ready file descriptor is handled exactly once.  */
+
+static void
+test_file_handlers ()
+{
+  std::vector<std::unique_ptr<test_pipe>> pipes = make_pipes (64);
+  SELF_CHECK (!pipes.empty ());
+
+  events_handled = 0;
+  for (auto &p : pipes)
+    p->poke ();
+  run_until_handled (pipes.size ());
+
+  for (auto &p : pipes)
+    SELF_CHECK (p->count == 1);
+
+  /* Again, with only some of the pipes.  */
+  events_handled = 0;
+  for (size_t i = 0; i < pipes.size (); i += 2)
+    pipes[i]->poke ();
+  run_until_handled ((pipes.size () + 1) / 2);
+
+  for (size_t i = 0; i < pipes.size (); ++i)
+    SELF_CHECK (pipes[i]->count == (i % 2 == 0 ? 2 : 1));
+}
+
+/* Check that a handler can stop monitoring another file descriptor
+   that is ready too, and that no event is reported for the latter
+   afterwards.  */
+
+static void
+test_delete_in_handler ()
+{
+  std::vector<std::unique_ptr<test_pipe>> pipes = make_pipes (2);
+  SELF_CHECK (pipes.size () == 2);
+
+  pipes[0]->victim = pipes[1].get ();
+  pipes[1]->victim = pipes[0].get ();
+
+  events_handled = 0;
+  pipes[0]->poke ();
+  pipes[1]->poke ();
+  run_until_handled (1);
+
+  /* Give the deleted handler a chance to be called, wrongly.  */
+  run_until_handled (2, 50);
+
+  SELF_CHECK (events_handled == 1);
+  SELF_CHECK (pipes[0]->count + pipes[1]->count == 1);
+}
+
+/* The order in which the test timers fired.  */
+
+static std::vector<int> timers_fired;
+
+static void
+record_timer (gdb_client_data client_data)
+{
+  timers_fired.push_back (*(int *) client_data);
+}
+
+/* Check that timers fire in order, and that deleted timers do not
+   fire.  */
+
+static void
+test_timers ()
+{
+  static int values[] = { 30, 10, 20 };
+
+  /* The event loop gives up if there are no file descriptors to
+     monitor.  */
+  std::vector<std::unique_ptr<test_pipe>> pipes = make_pipes (1);
+  SELF_CHECK (pipes.size () == 1);
+
+  timers_fired.clear ();
+  for (int &value : values)
+    create_timer (value, record_timer, &value);
+  int deleted = create_timer (15, record_timer, &values[0]);
+  delete_timer (deleted);
+
+  run_until ([] () { return timers_fired.size () >= 3; });
+
+  SELF_CHECK (timers_fired == std::vector<int> ({ 10, 20, 30 }));
+}
+
+/* Check that closing a monitored file descriptor before deleting its
+   handler does not leave the event loop reporting events for it, when
+   its file description stays open through another file
+   descriptor.  */
+
+static void
+test_closed_before_delete ()
+{
+  std::vector<std::unique_ptr<test_pipe>> pipes = make_pipes (1);
+  SELF_CHECK (pipes.size () == 1);
+
+  test_pipe &p = *pipes[0];
+  int dup_fd = dup (p.fds[0]);
+  SELF_CHECK (dup_fd != -1);
+
+  /* Close the monitored file descriptor first, then stop monitoring
+     it.  */
+  int old_fd = p.fds[0];
+  SELF_CHECK (close (old_fd) == 0);
+  delete_file_handler (old_fd);
+  p.fds[0] = dup_fd;
+
+  /* Monitor another pipe under the old number.  */
+  std::unique_ptr<test_pipe> reused (new test_pipe);
+  SELF_CHECK (reused->fds[0] != -1);
+  if (reused->fds[0] != old_fd)
+    {
+      SELF_CHECK (dup2 (reused->fds[0], old_fd) == old_fd);
+      close (reused->fds[0]);
+      reused->fds[0] = old_fd;
+    }
+  add_file_handler (reused->fds[0], pipe_handler, reused.get (),
+		    "reused test pipe");
+
+  /* Make the file description of the deleted handler readable.  It
+     must not be reported, neither to the new handler, nor as an event
+     without handler, which would make the event loop spin instead of
+     blocking until the timeout.  */
+  events_handled = 0;
+  p.poke ();
+  int iterations = run_until ([] () { return false; }, 50);
+
+  SELF_CHECK (events_handled == 0);
+  SELF_CHECK (reused->count == 0);
+  SELF_CHECK (iterations < 50);
+
+  /* The new handler still gets its events.  */
+  reused->poke ();
+  run_until_handled (1);
+  SELF_CHECK (reused->count == 1);
+}
+
+}
+}
+
+#endif /* USE_WIN32API */
+
+void _initialize_event_loop_selftests ();
+void
+_initialize_event_loop_selftests ()
+{
+#ifndef USE_WIN32API
+  selftests::register_test ("event_loop_file_handlers",
+			    selftests::event_loop_tests::test_file_handlers);
+  selftests::register_test
+    ("event_loop_delete_in_handler",
+     selftests::event_loop_tests::test_delete_in_handler);
+  selftests::register_test ("event_loop_timers",
+			    selftests::event_loop_tests::test_timers);
+  selftests::register_test
+    ("event_loop_closed_before_delete",
+     selftests::event_loop_tests::test_closed_before_delete);
+#endif /* USE_WIN32API */
+}
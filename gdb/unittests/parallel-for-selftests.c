@@ -63,12 +63,80 @@ test (int n_threads)
 #undef NUMBER
 }
 
+/* Like test, but with a size-weighted split.  Also check that each
+   element is processed exactly once, and that the results come back
+   in order.  */
+
+static void
+test_task_size (int n_threads)
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+
+#define NUMBER 10000
+
+  std::vector<std::atomic<int>> seen (NUMBER);
+  for (auto &s : seen)
+    s = 0;
+
+  /* A few elements are much costlier than the others.  */
+  auto task_size_ = [] (int i) -> size_t
+    {
+      return i % 1000 == 0 ? 1000 : 1;
+    };
+  gdb::function_view<size_t (int)> task_size = task_size_;
+
+  std::vector<std::pair<int, int>> results
+    = gdb::parallel_for_each (1, 0, NUMBER,
+			      [&] (int start, int end)
+			      {
+				for (int i = start; i < end; ++i)
+				  ++seen[i];
+				return std::make_pair (start, end);
+			      }, task_size);
+
+  for (const auto &s : seen)
+    SELF_CHECK (s == 1);
+
+  int expected_start = 0;
+  for (const auto &range : results)
+    {
+      SELF_CHECK (range.first == expected_start);
+      SELF_CHECK (range.first < range.second);
+      expected_start = range.second;
+    }
+  SELF_CHECK (expected_start == NUMBER);
+
+  /* Exceptions are propagated to the caller.  */
+  bool caught = false;
+  try
+    {
+      gdb::parallel_for_each (1, 0, NUMBER,
+			      [&] (int start, int end)
+			      {
+				if (start <= NUMBER / 2 && NUMBER / 2 < end)
+				  error (_("error in task"));
+			      }, task_size);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      caught = true;
+    }
+  SELF_CHECK (caught);
+
+#undef NUMBER
+}
+
 static void
 test_n_threads ()
 {
   test (0);
   test (1);
   test (3);
+
+  test_task_size (0);
+  test_task_size (1);
+  test_task_size (3);
 }
 
 }
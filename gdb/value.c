@@ -103,6 +103,27 @@ ranges_overlap (LONGEST offset1, LONGEST len1,
   return (l < h);
 }
 
+/* Returns true if RANGES covers all of [OFFSET, OFFSET+LENGTH).  */
+
+static bool
+ranges_cover (const std::vector<range> &ranges, LONGEST offset,
+	      LONGEST length)
+{
+  range what;
+
+  what.offset = offset;
+  what.length = length;
+
+  /* Since overlapping and contiguous ranges are coalesced, a covered
+     range must lie within the last range starting at or before
+     OFFSET.  */
+  auto i = std::upper_bound (ranges.begin (), ranges.end (), what);
+  if (i == ranges.begin ())
+    return false;
+  --i;
+  return offset + length <= i->offset + i->length;
+}
+
 /* Returns true if RANGES contains any range that overlaps [OFFSET,
    OFFSET+LENGTH).  */
 
@@ -365,6 +386,13 @@ struct value
      treated pretty much the same, except not-saved registers have a
      different string representation and related error strings.  */
   std::vector<range> optimized_out;
+
+  /* Ranges of CONTENTS that have already been read from memory while
+     the value is still lazy, tracked in bits.  This lets parts of a
+     large lval_memory value (e.g. the word containing a bitfield) be
+     read without reading the whole value.  Always empty for non-lazy
+     values.  */
+  std::vector<range> fetched;
 };
 
 /* See value.h.  */
@@ -1317,8 +1345,9 @@ value_ranges_copy_adjusted (struct value *dst, int dst_bit_offset,
    (value_contents_all) starting at SRC_OFFSET, into DST value's (all)
    contents, starting at DST_OFFSET.  If unavailable contents are
    being copied from SRC, the corresponding DST contents are marked
-   unavailable accordingly.  Neither DST nor SRC may be lazy
-   values.
+   unavailable accordingly.  DST may not be lazy.  SRC may only be
+   lazy if the copied range has already been fetched, see
+   value_fetch_lazy_memory_range.
 
    It is assumed the contents of DST in the [DST_OFFSET,
    DST_OFFSET+LENGTH) range are wholly available.  */
@@ -1334,8 +1363,12 @@ value_contents_copy_raw (struct value *dst, LONGEST dst_offset,
   /* A lazy DST would make that this copy operation useless, since as
      soon as DST's contents were un-lazied (by a later value_contents
      call, say), the contents would be overwritten.  A lazy SRC would
-     mean we'd be copying garbage.  */
-  gdb_assert (!dst->lazy && !src->lazy);
+     mean we'd be copying garbage, unless the range was fetched.  */
+  gdb_assert (!dst->lazy);
+  gdb_assert (!src->lazy
+	      || ranges_cover (src->fetched,
+			       src_offset * unit_size * HOST_CHAR_BIT,
+			       length * unit_size * HOST_CHAR_BIT));
 
   /* The overwritten DST range gets unavailability ORed in, not
      replaced.  Make sure to remember to implement replacing if it
@@ -1394,6 +1427,7 @@ void
 set_value_lazy (struct value *value, int val)
 {
   value->lazy = val;
+  value->fetched.clear ();
 }
 
 int
@@ -1729,8 +1763,10 @@ value_copy (const value *arg)
   val->initialized = arg->initialized;
   val->unavailable = arg->unavailable;
   val->optimized_out = arg->optimized_out;
+  val->fetched = arg->fetched;
 
-  if (!value_lazy (val) && !value_entirely_optimized_out (val))
+  if ((!value_lazy (val) && !value_entirely_optimized_out (val))
+      || !arg->fetched.empty ())
     {
       gdb_assert (arg->contents != nullptr);
       ULONGEST length = TYPE_LENGTH (value_enclosing_type (arg));
@@ -3128,7 +3164,13 @@ value_primitive_field (struct value *arg1, LONGEST offset,
       if (VALUE_LVAL (arg1) == lval_register && value_lazy (arg1))
 	value_fetch_lazy (arg1);
 
-      if (value_lazy (arg1))
+      /* If the part of a lazy ARG1 holding this field was already
+	 read, reuse it rather than reading the field again.  */
+      if (value_lazy (arg1)
+	  && !ranges_cover (arg1->fetched,
+			    ((value_embedded_offset (arg1) + offset)
+			     * unit_size * HOST_CHAR_BIT),
+			    TYPE_LENGTH (type) * HOST_CHAR_BIT))
 	v = allocate_value_lazy (type);
       else
 	{
@@ -3893,13 +3935,32 @@ value_fetch_lazy_bitfield (struct value *val)
 {
   gdb_assert (value_bitsize (val) != 0);
 
-  /* To read a lazy bitfield, read the entire enclosing value.  This
-     prevents reading the same block of (possibly volatile) memory once
-     per bitfield.  It would be even better to read only the containing
-     word, but we have no way to record that just specific bits of a
-     value have been fetched.  */
   struct value *parent = value_parent (val);
 
+  if (value_lazy (parent)
+      && VALUE_LVAL (parent) == lval_memory
+      && value_bitsize (parent) == 0)
+    {
+      /* Read only the word containing the bitfield.  The parent
+	 remembers which parts of it were read, so that reading several
+	 bitfields sharing the same block of (possibly volatile) memory
+	 reads that memory only once.  */
+      int unit_size
+	= gdbarch_addressable_memory_unit_size (get_value_arch (parent));
+      LONGEST unit_bits = unit_size * HOST_CHAR_BIT;
+      LONGEST start = value_offset (val) / unit_size;
+      LONGEST end = ((value_offset (val) * HOST_CHAR_BIT
+		      + value_bitpos (val) + value_bitsize (val)
+		      + unit_bits - 1)
+		     / unit_bits);
+
+      value_fetch_lazy_memory_range (parent, start, end - start);
+      unpack_value_bitfield (val, value_bitpos (val), value_bitsize (val),
+			     parent->contents.get (), value_offset (val),
+			     parent);
+      return;
+    }
+
   if (value_lazy (parent))
     value_fetch_lazy (parent);
 
@@ -3908,6 +3969,52 @@ value_fetch_lazy_bitfield (struct value *val)
 			 value_offset (val), parent);
 }
 
+/* See value.h.  */
+
+void
+value_fetch_lazy_memory_range (struct value *val, LONGEST offset,
+			       LONGEST length)
+{
+  gdb_assert (VALUE_LVAL (val) == lval_memory);
+  gdb_assert (value_lazy (val));
+
+  int unit_size = gdbarch_addressable_memory_unit_size (get_value_arch (val));
+  LONGEST unit_bits = unit_size * HOST_CHAR_BIT;
+  LONGEST pos = offset * unit_bits;
+  LONGEST end = pos + length * unit_bits;
+
+  /* Find the parts of the range that were not read yet.  */
+  std::vector<range> holes;
+  for (const range &r : val->fetched)
+    {
+      if (r.offset >= end)
+	break;
+      if (r.offset > pos)
+	holes.push_back ({pos, r.offset - pos});
+      pos = std::max (pos, r.offset + r.length);
+    }
+  if (pos < end)
+    holes.push_back ({pos, end - pos});
+
+  if (holes.empty ())
+    return;
+
+  allocate_value_contents (val);
+
+  CORE_ADDR addr = value_address (val);
+  for (const range &hole : holes)
+    {
+      LONGEST hole_offset = hole.offset / unit_bits;
+
+      read_value_memory (val, hole.offset, value_stack (val),
+			 addr + hole_offset,
+			 val->contents.get () + hole_offset * unit_size,
+			 hole.length / unit_bits);
+      insert_into_bit_range_vector (&val->fetched, hole.offset,
+				    hole.length);
+    }
+}
+
 /* Helper for value_fetch_lazy when the value is in memory.  */
 
 static void
@@ -3915,13 +4022,10 @@ value_fetch_lazy_memory (struct value *val)
 {
   gdb_assert (VALUE_LVAL (val) == lval_memory);
 
-  CORE_ADDR addr = value_address (val);
   struct type *type = check_typedef (value_enclosing_type (val));
 
   if (TYPE_LENGTH (type))
-      read_value_memory (val, 0, value_stack (val),
-			 addr, value_contents_all_raw (val).data (),
-			 type_length_units (type));
+    value_fetch_lazy_memory_range (val, 0, type_length_units (type));
 }
 
 /* Helper for value_fetch_lazy when the value is in a register.  */
@@ -4058,9 +4162,9 @@ value_fetch_lazy (struct value *val)
   allocate_value_contents (val);
   /* A value is either lazy, or fully fetched.  The
      availability/validity is only established as we try to fetch a
-     value.  */
+     value, or a part of it, see value_fetch_lazy_memory_range.  */
   gdb_assert (val->optimized_out.empty ());
-  gdb_assert (val->unavailable.empty ());
+  gdb_assert (val->unavailable.empty () || !val->fetched.empty ());
   if (val->is_zero)
     {
       /* Nothing.  */
@@ -390,6 +390,14 @@ extern gdb::array_view<const gdb_byte>
 
 extern void value_fetch_lazy (struct value *val);
 
+/* Read the LENGTH addressable memory units at OFFSET in the contents
+   of the lazy lval_memory value VAL, without fetching the rest of
+   VAL.  Parts of the range that were read by an earlier call are not
+   read again.  VAL stays lazy.  */
+
+extern void value_fetch_lazy_memory_range (struct value *val,
+					   LONGEST offset, LONGEST length);
+
 /* If nonzero, this is the value of a variable which does not actually
    exist in the program, at least partially.  If the value is lazy,
    this may fetch it now.  */
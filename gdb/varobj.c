@@ -31,6 +31,7 @@
 #include "varobj-iter.h"
 #include "parser-defs.h"
 #include "gdbarch.h"
+#include "observable.h"
 #include <algorithm>
 
 #if HAVE_PYTHON
@@ -57,10 +58,16 @@ const char *varobj_format_string[] =
 /* True if we want to allow Python-based pretty-printing.  */
 static bool pretty_printing = false;
 
+/* Incremented whenever the string rendering of values may have
+   changed, because a setting changed.  See the print_value_generation
+   field of struct varobj.  */
+static unsigned int print_value_generation;
+
 void
 varobj_enable_pretty_printing (void)
 {
   pretty_printing = true;
+  ++print_value_generation;
 }
 
 /* Data structures */
@@ -491,6 +498,8 @@ varobj_set_display_format (struct varobj *var,
     {
       var->print_value = varobj_value_get_print_value (var->value.get (),
 						       var->format, var);
+      var->print_value_generation = print_value_generation;
+      var->print_value_language = current_language;
     }
 
   return var->format;
@@ -1169,6 +1178,40 @@ update_type_if_necessary (struct varobj *var, struct value *new_value)
   return false;
 }
 
+/* Return true if NEW_VALUE has the same contents as OLD_VALUE, the
+   previous value of a varobj, and the string rendering of such values
+   only depends on their contents.  Both values must not be lazy.  */
+
+static bool
+varobj_same_print_value_p (struct value *old_value, struct value *new_value)
+{
+  struct type *type = check_typedef (value_type (new_value));
+
+  if (check_typedef (value_type (old_value)) != type)
+    return false;
+
+  /* Other changeable types, e.g. pointers to strings, are printed with
+     more than their contents.  */
+  switch (type->code ())
+    {
+    case TYPE_CODE_INT:
+    case TYPE_CODE_FLT:
+    case TYPE_CODE_DECFLOAT:
+    case TYPE_CODE_BOOL:
+    case TYPE_CODE_CHAR:
+    case TYPE_CODE_ENUM:
+    case TYPE_CODE_RANGE:
+      break;
+
+    default:
+      return false;
+    }
+
+  return value_contents_eq (old_value, value_embedded_offset (old_value),
+			    new_value, value_embedded_offset (new_value),
+			    TYPE_LENGTH (type));
+}
+
 /* Assign a new value to a variable object.  If INITIAL is true,
    this is the first assignment after the variable object was just
    created, or changed type.  In that case, just assign the value 
@@ -1269,11 +1312,23 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
   /* Below, we'll be comparing string rendering of old and new
      values.  Don't get string rendering if the value is
      lazy -- if it is, the code above has decided that the value
-     should not be fetched.  */
+     should not be fetched.  Getting the string rendering can be
+     costly, e.g. when updating thousands of variable objects on each
+     stop, so if the contents did not change, reuse the old one.  */
   std::string print_value;
   if (value != NULL && !value_lazy (value)
       && var->dynamic->pretty_printer == NULL)
-    print_value = varobj_value_get_print_value (value, var->format, var);
+    {
+      if (!initial && changeable && !var->updated
+	  && !var->print_value.empty ()
+	  && var->print_value_generation == print_value_generation
+	  && var->print_value_language == current_language
+	  && var->value != NULL && !value_lazy (var->value.get ())
+	  && varobj_same_print_value_p (var->value.get (), value))
+	print_value = var->print_value;
+      else
+	print_value = varobj_value_get_print_value (value, var->format, var);
+    }
 
   /* If the type is changeable, compare the old and the new values.
      If this is the initial assignment, we don't have any old value
@@ -1351,6 +1406,8 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
 	  changed = true;
     }
   var->print_value = print_value;
+  var->print_value_generation = print_value_generation;
+  var->print_value_language = current_language;
 
   gdb_assert (var->value == nullptr || value_type (var->value.get ()));
 
@@ -2396,6 +2453,15 @@ eq_varobj_and_string (const void *a, const void *b)
   return obj->obj_name == name;
 }
 
+/* Observer for the command_param_changed event.  Many settings, e.g.
+   "set output-radix", affect the string rendering of values.  */
+
+static void
+varobj_param_changed (const char *param, const char *value)
+{
+  ++print_value_generation;
+}
+
 void _initialize_varobj ();
 void
 _initialize_varobj ()
@@ -2403,6 +2469,9 @@ _initialize_varobj ()
   varobj_table = htab_create_alloc (5, hash_varobj, eq_varobj_and_string,
 				    nullptr, xcalloc, xfree);
 
+  gdb::observers::command_param_changed.attach (varobj_param_changed,
+						"varobj");
+
   add_setshow_zuinteger_cmd ("varobj", class_maintenance,
 			     &varobjdebug,
 			     _("Set varobj debugging."),
@@ -146,6 +146,15 @@ struct varobj
   /* Last print value.  */
   std::string print_value;
 
+  /* The value of print_value_generation in varobj.c when PRINT_VALUE
+     was computed.  */
+  unsigned int print_value_generation = 0;
+
+  /* The current language when PRINT_VALUE was computed.  It changes
+     with the selected frame under "set language auto", without any
+     setting being changed.  */
+  const struct language_defn *print_value_language = nullptr;
+
   /* Is this variable frozen.  Frozen variables are never implicitly
      updated by -var-update * 
      or -var-update <direct-or-indirect-parent>.  */
@@ -373,6 +373,50 @@ emit_le_goto (int *offset_p, int *size_p)
   target_emit_ops ()->emit_le_goto (offset_p, size_p);
 }
 
+static void
+emit_div_signed (void)
+{
+  target_emit_ops ()->emit_div_signed ();
+}
+
+static void
+emit_div_unsigned (void)
+{
+  target_emit_ops ()->emit_div_unsigned ();
+}
+
+static void
+emit_rem_signed (void)
+{
+  target_emit_ops ()->emit_rem_signed ();
+}
+
+static void
+emit_rem_unsigned (void)
+{
+  target_emit_ops ()->emit_rem_unsigned ();
+}
+
+static void
+emit_pick (int depth)
+{
+  target_emit_ops ()->emit_pick (depth);
+}
+
+static void
+emit_rot (void)
+{
+  target_emit_ops ()->emit_rot ();
+}
+
+/* FN's prototype is `void(*fn)(LONGEST,LONGEST)'.  */
+
+static void
+emit_void_call_pop_2 (CORE_ADDR fn)
+{
+  target_emit_ops ()->emit_void_call_pop_2 (fn);
+}
+
 /* Scan an agent expression for any evidence that the given PC is the
    target of a jump bytecode in the expression.  */
 
@@ -460,19 +504,27 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  break;
 
 	case gdb_agent_op_div_signed:
-	  UNHANDLED;
+	  if (target_emit_ops ()->emit_div_signed == NULL)
+	    UNHANDLED;
+	  emit_div_signed ();
 	  break;
 
 	case gdb_agent_op_div_unsigned:
-	  UNHANDLED;
+	  if (target_emit_ops ()->emit_div_unsigned == NULL)
+	    UNHANDLED;
+	  emit_div_unsigned ();
 	  break;
 
 	case gdb_agent_op_rem_signed:
-	  UNHANDLED;
+	  if (target_emit_ops ()->emit_rem_signed == NULL)
+	    UNHANDLED;
+	  emit_rem_signed ();
 	  break;
 
 	case gdb_agent_op_rem_unsigned:
-	  UNHANDLED;
+	  if (target_emit_ops ()->emit_rem_unsigned == NULL)
+	    UNHANDLED;
+	  emit_rem_unsigned ();
 	  break;
 
 	case gdb_agent_op_lsh:
@@ -488,11 +540,16 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  break;
 
 	case gdb_agent_op_trace:
-	  UNHANDLED;
+	  if (target_emit_ops ()->emit_void_call_pop_2 == NULL)
+	    UNHANDLED;
+	  emit_void_call_pop_2 (get_trace_func_addr ());
 	  break;
 
 	case gdb_agent_op_trace_quick:
-	  UNHANDLED;
+	  arg = aexpr->bytes[pc++];
+	  if (target_emit_ops ()->emit_void_call_pop_2 == NULL)
+	    UNHANDLED;
+	  emit_void_call_2 (get_trace_quick_func_addr (), arg);
 	  break;
 
 	case gdb_agent_op_log_not:
@@ -734,7 +791,30 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  break;
 
 	case gdb_agent_op_tracev:
-	  UNHANDLED;
+	  arg = aexpr->bytes[pc++];
+	  arg = (arg << 8) + aexpr->bytes[pc++];
+	  if (target_emit_ops ()->emit_void_call_pop_2 == NULL)
+	    UNHANDLED;
+	  emit_void_call_2 (get_tracev_func_addr (), arg);
+	  break;
+
+	case gdb_agent_op_tracenz:
+	  if (target_emit_ops ()->emit_void_call_pop_2 == NULL)
+	    UNHANDLED;
+	  emit_void_call_pop_2 (get_tracenz_func_addr ());
+	  break;
+
+	case gdb_agent_op_pick:
+	  arg = aexpr->bytes[pc++];
+	  if (target_emit_ops ()->emit_pick == NULL)
+	    UNHANDLED;
+	  emit_pick (arg);
+	  break;
+
+	case gdb_agent_op_rot:
+	  if (target_emit_ops ()->emit_rot == NULL)
+	    UNHANDLED;
+	  emit_rot ();
 	  break;
 
 	  /* GDB never (currently) generates any of these ops.  */
@@ -137,6 +137,33 @@ struct emit_ops
   void (*emit_le_goto) (int *offset_p, int *size_p);
   void (*emit_gt_goto) (int *offset_p, int *size_p);
   void (*emit_ge_goto) (int *offset_p, int *size_p);
+
+  /* The methods below are optional.  If a target leaves one NULL,
+     expressions using the corresponding bytecode are left to the
+     interpreter.  */
+
+  /* Emit code for division and remainder.  If the divisor is zero,
+     the compiled code returns expr_eval_divide_by_zero.  */
+  void (*emit_div_signed) (void);
+  void (*emit_div_unsigned) (void);
+  void (*emit_rem_signed) (void);
+  void (*emit_rem_unsigned) (void);
+
+  /* Emit code for the pick and rot bytecodes.  */
+  void (*emit_pick) (int depth);
+  void (*emit_rot) (void);
+
+  /* Emit code for a generic function that takes the two entries at
+     the top of the stack, pops both, and returns nothing (for
+     instance, the helper of the trace bytecode).  The entry below
+     them is the new top of the stack; if the stack ends up empty, the
+     top is undefined, so this must not touch the data saved by the
+     prologue.
+
+     All the trace bytecodes, and so the collection actions of fast
+     tracepoints, are only compiled for targets that implement this
+     method.  */
+  void (*emit_void_call_pop_2) (CORE_ADDR fn);
 };
 
 extern CORE_ADDR current_insn_ptr;
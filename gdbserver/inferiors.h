@@ -30,6 +30,7 @@ struct sym_cache;
 struct breakpoint;
 struct raw_breakpoint;
 struct fast_tracepoint_jump;
+struct software_watchpoint;
 struct process_info_private;
 
 struct process_info
@@ -61,6 +62,10 @@ struct process_info
   /* The list of installed fast tracepoints.  */
   struct fast_tracepoint_jump *fast_tracepoint_jumps = NULL;
 
+  /* The list of software watchpoints GDB asked us to check while
+     single-stepping the threads it wants running.  */
+  struct software_watchpoint *software_watchpoints = NULL;
+
   /* The list of syscalls to report, or just a single element, ANY_SYSCALL,
      for unfiltered syscall reporting.  */
   std::vector<int> syscalls_to_catch;
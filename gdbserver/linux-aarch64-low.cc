@@ -140,6 +140,8 @@ protected:
 
   bool low_supports_range_stepping () override;
 
+  int low_frame_pointer_regno () override;
+
   bool low_supports_catch_syscall () override;
 
   void low_get_syscall_trapinfo (regcache *regcache, int *sysno) override;
@@ -1638,6 +1640,50 @@ emit_mul (uint32_t *buf, struct aarch64_register rd,
   return emit_data_processing_reg (buf, MUL, rd, rn, rm);
 }
 
+/* Write a MSUB instruction into *BUF.
+
+     MSUB rd, rn, rm, ra
+
+   RD is the destination register, set to RA - RN * RM.
+   RN, RM and RA are the source registers.  */
+
+static int
+emit_msub (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm,
+	   struct aarch64_register ra)
+{
+  return emit_data_processing_reg (buf, MSUB | ENCODE (ra.num, 5, 10),
+				   rd, rn, rm);
+}
+
+/* Write a SDIV instruction into *BUF.
+
+     SDIV rd, rn, rm
+
+   RD is the destination register.
+   RN and RM are the source registers.  */
+
+static int
+emit_sdiv (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm)
+{
+  return emit_data_processing_reg (buf, SDIV, rd, rn, rm);
+}
+
+/* Write a UDIV instruction into *BUF.
+
+     UDIV rd, rn, rm
+
+   RD is the destination register.
+   RN and RM are the source registers.  */
+
+static int
+emit_udiv (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm)
+{
+  return emit_data_processing_reg (buf, UDIV, rd, rn, rm);
+}
+
 /* Write a MRS instruction into *BUF.  The register size is 64-bit.
 
      MRS xt, system_reg
@@ -2518,6 +2564,7 @@ aarch64_emit_prologue (void)
 	  | FP                                                   | <- FP
 	  | x1  (ULONGEST *value)                                |
 	  | x0  (unsigned char *regs)                            |
+	  | (spill slot)                                         |
      Low  *------------------------------------------------------*
 
      As we are implementing a stack machine, each opcode can expand the
@@ -2527,13 +2574,17 @@ aarch64_emit_prologue (void)
      clobbered when calling C functions.
 
      Finally, throughout every operation, we are using register x0 as the
-     top of the stack, and x1 as a scratch register.  */
+     top of the stack, and x1 as a scratch register.  Bytecodes that
+     empty the stack, like trace, leave x0 undefined by popping one
+     entry too many; the spill slot keeps the entry pushed after that
+     from overwriting x0 (regs).  */
 
   p += emit_stp (p, x0, x1, sp, preindex_memory_operand (-2 * 16));
   p += emit_str (p, lr, sp, offset_memory_operand (3 * 8));
   p += emit_str (p, fp, sp, offset_memory_operand (2 * 8));
 
   p += emit_add (p, fp, sp, immediate_operand (2 * 8));
+  p += emit_sub (p, sp, sp, immediate_operand (1 * 16));
 
 
   emit_ops_insns (buf, p - buf);
@@ -3020,6 +3071,152 @@ aarch64_emit_void_call_2 (CORE_ADDR fn, int arg1)
   aarch64_emit_pop ();
 }
 
+/* Emit code returning expr_eval_divide_by_zero if the divisor, on
+   top of the stack, is zero.  */
+
+static void
+aarch64_emit_divide_check (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  /* Branch over the early return if x0 != 0.  */
+  p += emit_cb (p, 1, x0, 5 * 4);
+
+  /* Like the epilogue, but without storing the result.  */
+  p += emit_mov (p, x0, immediate_operand (expr_eval_divide_by_zero));
+  p += emit_add (p, sp, fp, immediate_operand (2 * 8));
+  p += emit_ldp (p, fp, lr, fp, offset_memory_operand (0));
+  p += emit_ret (p, lr);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_div_signed".  */
+
+static void
+aarch64_emit_div_signed (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  aarch64_emit_divide_check ();
+
+  p += emit_pop (p, x1);
+  p += emit_sdiv (p, x0, x1, x0);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_div_unsigned".  */
+
+static void
+aarch64_emit_div_unsigned (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  aarch64_emit_divide_check ();
+
+  p += emit_pop (p, x1);
+  p += emit_udiv (p, x0, x1, x0);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_rem_signed".  */
+
+static void
+aarch64_emit_rem_signed (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  aarch64_emit_divide_check ();
+
+  /* x0 = x1 - (x1 / x0) * x0.  */
+  p += emit_pop (p, x1);
+  p += emit_sdiv (p, x2, x1, x0);
+  p += emit_msub (p, x0, x2, x0, x1);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_rem_unsigned".  */
+
+static void
+aarch64_emit_rem_unsigned (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  aarch64_emit_divide_check ();
+
+  p += emit_pop (p, x1);
+  p += emit_udiv (p, x2, x1, x0);
+  p += emit_msub (p, x0, x2, x0, x1);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_pick".  */
+
+static void
+aarch64_emit_pick (int depth)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p += emit_push (p, x0);
+  p += emit_ldr (p, x0, sp, offset_memory_operand (depth * 16));
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_rot".  */
+
+static void
+aarch64_emit_rot (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p += emit_ldr (p, x1, sp, offset_memory_operand (0 * 16));
+  p += emit_ldr (p, x2, sp, offset_memory_operand (1 * 16));
+  p += emit_str (p, x2, sp, offset_memory_operand (0 * 16));
+  p += emit_str (p, x0, sp, offset_memory_operand (1 * 16));
+  p += emit_mov (p, x0, register_operand (x1));
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_void_call_pop_2".  */
+
+static void
+aarch64_emit_void_call_pop_2 (CORE_ADDR fn)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  /* Setup arguments for the function call:
+
+     x0: the entry below the top of the stack
+     x1: top of the stack
+
+       MOV x1, x0
+       LDR x0, [sp], #16  */
+
+  p += emit_mov (p, x1, register_operand (x0));
+  p += emit_pop (p, x0);
+
+  emit_ops_insns (buf, p - buf);
+
+  aarch64_emit_call (fn);
+
+  /* Load the new top of the stack.  */
+  aarch64_emit_pop ();
+}
+
 /* Implementation of emit_ops method "emit_eq_goto".  */
 
 static void
@@ -3191,6 +3388,13 @@ static struct emit_ops aarch64_emit_ops_impl =
   aarch64_emit_le_goto,
   aarch64_emit_gt_goto,
   aarch64_emit_ge_got,
+  aarch64_emit_div_signed,
+  aarch64_emit_div_unsigned,
+  aarch64_emit_rem_signed,
+  aarch64_emit_rem_unsigned,
+  aarch64_emit_pick,
+  aarch64_emit_rot,
+  aarch64_emit_void_call_pop_2,
 };
 
 /* Implementation of target ops method "emit_ops".  */
@@ -3218,6 +3422,19 @@ aarch64_target::low_supports_range_stepping ()
   return true;
 }
 
+/* Implementation of linux target ops method "low_frame_pointer_regno".  */
+
+int
+aarch64_target::low_frame_pointer_regno ()
+{
+  /* AArch32 code keeps its frame pointer in either of r7 or r11,
+     depending on the instruction set.  */
+  if (!is_64bit_tdesc ())
+    return -1;
+
+  return find_regno (current_process ()->tdesc, "x29");
+}
+
 /* Implementation of target ops method "sw_breakpoint_from_kind".  */
 
 const gdb_byte *
@@ -834,13 +834,16 @@ linux_process_target::save_stop_reason (lwp_info *lwp)
 	      if (!check_stopped_by_watchpoint (lwp))
 		lwp->stop_reason = TARGET_STOPPED_BY_HW_BREAKPOINT;
 	    }
-	  else if (siginfo.si_code == TRAP_TRACE)
+	  else if (siginfo.si_code == TRAP_TRACE
+		   || (siginfo.si_code == TRAP_BRKPT && lwp->stepping))
 	    {
 	      /* We may have single stepped an instruction that
 		 triggered a watchpoint.  In that case, on some
 		 architectures (such as x86), instead of TRAP_HWBKPT,
 		 si_code indicates TRAP_TRACE, and we need to check
-		 the debug registers separately.  */
+		 the debug registers separately.  On x86, single
+		 stepping a syscall instruction gives TRAP_BRKPT
+		 instead of TRAP_TRACE (see nat/linux-ptrace.h).  */
 	      if (!check_stopped_by_watchpoint (lwp))
 		lwp->stop_reason = TARGET_STOPPED_BY_SINGLE_STEP;
 	    }
@@ -2455,7 +2458,8 @@ linux_process_target::resume_stopped_resumed_lwps (thread_info *thread)
     {
       int step = 0;
 
-      if (thread->last_resume_kind == resume_step)
+      if (thread->last_resume_kind == resume_step
+	  || has_software_watchpoints (get_thread_process (thread)))
 	step = maybe_hw_step (thread);
 
       threads_debug_printf ("resuming stopped-resumed LWP %s at %s: step=%d",
@@ -3278,6 +3282,18 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
      there's no range to begin with.  */
   in_step_range = lwp_in_step_range (event_child);
 
+  /* If we single-stepped the thread while checking software
+     watchpoints, report the step if one of them changed.  That is the
+     case for threads GDB wants running, which we step for the
+     watchpoints only, but also for threads GDB asked to step through
+     a range, which we would otherwise only report at the end of the
+     range.  */
+  bool sw_watchpoint_changed
+    = (maybe_internal_trap
+       && event_child->stop_reason == TARGET_STOPPED_BY_SINGLE_STEP
+       && has_software_watchpoints (current_process ())
+       && software_watchpoint_value_changed ());
+
   /* If GDB wanted this thread to single step, and the thread is out
      of the step range, we always want to report the SIGTRAP, and let
      GDB handle it.  Watchpoints should always be reported.  So should
@@ -3295,6 +3311,7 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
 		   || (current_thread->last_resume_kind == resume_step
 		       && !in_step_range)
 		   || event_child->stop_reason == TARGET_STOPPED_BY_WATCHPOINT
+		   || sw_watchpoint_changed
 		   || (!in_step_range
 		       && !bp_explains_trap
 		       && !trace_event
@@ -3387,6 +3404,8 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
 
 	if (event_child->stop_reason == TARGET_STOPPED_BY_WATCHPOINT)
 	  threads_debug_printf ("Stopped by watchpoint.");
+	else if (sw_watchpoint_changed)
+	  threads_debug_printf ("Software watchpoint value changed.");
 	else if (gdb_breakpoint_here (event_child->stop_pc))
 	  threads_debug_printf ("Stopped by GDB breakpoint.");
       }
@@ -4146,6 +4165,7 @@ linux_process_target::resume_one_lwp_throw (lwp_info *lwp, int step,
      status.  Note that we must not throw after this is cleared,
      otherwise handle_zombie_lwp_error would get confused.  */
   lwp->stopped = 0;
+  lwp->core = -1;
   lwp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
 }
 
@@ -4204,6 +4224,7 @@ linux_process_target::resume_one_lwp (lwp_info *lwp, int step, int signal,
 	     exited.  Mark it as resumed, so we can collect an exit event
 	     from it.  */
 	  lwp->stopped = 0;
+	  lwp->core = -1;
 	  lwp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
 	}
       else
@@ -4819,6 +4840,13 @@ linux_process_target::proceed_one_lwp (thread_info *thread, lwp_info *except)
       threads_debug_printf ("   stepping LWP %ld, reinsert set",
 			    lwpid_of (thread));
 
+      step = maybe_hw_step (thread);
+    }
+  else if (has_software_watchpoints (get_thread_process (thread)))
+    {
+      threads_debug_printf ("   stepping LWP %ld, software watchpoints",
+			    lwpid_of (thread));
+
       step = maybe_hw_step (thread);
     }
   else
@@ -5940,7 +5968,16 @@ linux_process_target::handle_monitor_command (char *mon)
 int
 linux_process_target::core_of_thread (ptid_t ptid)
 {
-  return linux_common_core_of_thread (ptid);
+  struct lwp_info *lwp = find_lwp_pid (ptid);
+
+  /* A running LWP may migrate at any time, so only cache the core
+     of stopped LWPs.  */
+  if (lwp == NULL || !lwp->stopped)
+    return linux_common_core_of_thread (ptid);
+
+  if (lwp->core == -1)
+    lwp->core = linux_common_core_of_thread (ptid);
+  return lwp->core;
 }
 
 bool
@@ -5970,6 +6007,26 @@ linux_process_target::low_supports_range_stepping ()
   return false;
 }
 
+int
+linux_process_target::frame_pointer_regno ()
+{
+  return low_frame_pointer_regno ();
+}
+
+int
+linux_process_target::low_frame_pointer_regno ()
+{
+  return -1;
+}
+
+bool
+linux_process_target::supports_software_watchpoints ()
+{
+  /* Inserting single-step breakpoints at each step would cost more
+     than we save.  */
+  return supports_hardware_single_step ();
+}
+
 bool
 linux_process_target::supports_pid_to_exec_file ()
 {
@@ -289,6 +289,10 @@ class linux_process_target : public process_stratum_target
 
   bool supports_range_stepping () override;
 
+  bool supports_software_watchpoints () override;
+
+  int frame_pointer_regno () override;
+
   bool supports_pid_to_exec_file () override;
 
   const char *pid_to_exec_file (int pid) override;
@@ -689,6 +693,11 @@ class linux_process_target : public process_stratum_target
   /* Returns true if the low target supports range stepping.  */
   virtual bool low_supports_range_stepping ();
 
+  /* Return the number of the frame pointer register of the current
+     thread, if the low target follows the frame layout described in
+     the frame_pointer_regno target op, or -1.  */
+  virtual int low_frame_pointer_regno ();
+
   /* Return true if the target supports catch syscall.  Such targets
      override the low_get_syscall_trapinfo method below.  */
   virtual bool low_supports_catch_syscall ();
@@ -824,6 +833,13 @@ struct lwp_info
      notified about the parent's fork event.  */
   struct lwp_info *fork_relative = nullptr;
 
+  /* When stopped is set, the processor core this lwp was last seen
+     running on, or -1 if it hasn't been fetched yet.  Caching this
+     avoids accessing /proc for every thread each time GDB refreshes
+     the thread list, which becomes noticeably expensive when we have
+     thousands of LWPs.  */
+  int core = -1;
+
   /* When stopped is set, this is where the lwp last stopped, with
      decr_pc_after_break already accounted for.  If the LWP is
      running, this is the address at which the lwp was resumed.  */
@@ -178,6 +178,8 @@ protected:
 
   bool low_supports_range_stepping () override;
 
+  int low_frame_pointer_regno () override;
+
   bool low_supports_catch_syscall () override;
 
   void low_get_syscall_trapinfo (regcache *regcache, int *sysno) override;
@@ -1247,12 +1249,17 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
   append_insns (&buildaddr, i, buf);
 
   /* The collector function being in the shared library, may be
-     >31-bits away off the jump pad.  */
+     >31-bits away off the jump pad.  The ABI wants the stack aligned
+     on 16 bytes at the call, but the tracepoint may be anywhere.
+     %rbx is saved in the register block, and callee-saved.  */
   i = 0;
   i += push_opcode (&buf[i], "48 b8");          /* mov $collector,%rax */
   memcpy (buf + i, &collector, 8);
   i += 8;
+  i += push_opcode (&buf[i], "48 89 e3");	/* mov %rsp,%rbx */
+  i += push_opcode (&buf[i], "48 83 e4 f0");	/* and $-16,%rsp */
   i += push_opcode (&buf[i], "ff d0");          /* callq *%rax */
+  i += push_opcode (&buf[i], "48 89 dc");	/* mov %rbx,%rsp */
   append_insns (&buildaddr, i, buf);
 
   /* Clear the spin-lock.  */
@@ -1717,25 +1724,36 @@ amd64_emit_sub (void)
 static void
 amd64_emit_mul (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_mul,
+	    "imul (%rsp),%rax\n\t"
+	    "lea 0x8(%rsp),%rsp");
 }
 
 static void
 amd64_emit_lsh (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_lsh,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shl %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_signed (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "sar %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_unsigned (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shr %cl,%rax");
 }
 
 static void
@@ -1852,11 +1870,11 @@ amd64_emit_ref (int size)
     {
     case 1:
       EMIT_ASM (amd64_ref1,
-		"movb (%rax),%al");
+		"movzbq (%rax),%rax");
       break;
     case 2:
       EMIT_ASM (amd64_ref2,
-		"movw (%rax),%ax");
+		"movzwq (%rax),%rax");
       break;
     case 4:
       EMIT_ASM (amd64_ref4,
@@ -1967,6 +1985,44 @@ amd64_emit_call (CORE_ADDR fn)
   current_insn_ptr = buildaddr;
 }
 
+/* Like amd64_emit_call, but align the stack on 16 bytes first, as the
+   ABI wants.  The bytecode stack leaves it aligned on 8 bytes only,
+   which functions storing SSE registers on the stack do not expect.
+   The original stack pointer is saved twice, so that one copy is
+   right above the aligned stack pointer either way.  */
+
+static void
+amd64_emit_aligned_call (CORE_ADDR fn)
+{
+  unsigned char buf[16];
+  int i;
+  CORE_ADDR buildaddr = current_insn_ptr;
+
+  i = 0;
+  buf[i++] = 0x54; /* push %rsp */
+  buf[i++] = 0xff; /* push (%rsp) */
+  buf[i++] = 0x34;
+  buf[i++] = 0x24;
+  buf[i++] = 0x48; /* and $-0x10,%rsp */
+  buf[i++] = 0x83;
+  buf[i++] = 0xe4;
+  buf[i++] = 0xf0;
+  append_insns (&buildaddr, i, buf);
+  current_insn_ptr = buildaddr;
+
+  amd64_emit_call (fn);
+
+  buildaddr = current_insn_ptr;
+  i = 0;
+  buf[i++] = 0x48; /* mov 0x8(%rsp),%rsp */
+  buf[i++] = 0x8b;
+  buf[i++] = 0x64;
+  buf[i++] = 0x24;
+  buf[i++] = 0x08;
+  append_insns (&buildaddr, i, buf);
+  current_insn_ptr = buildaddr;
+}
+
 static void
 amd64_emit_reg (int reg)
 {
@@ -2065,7 +2121,7 @@ amd64_emit_int_call_1 (CORE_ADDR fn, int arg1)
   i += 4;
   append_insns (&buildaddr, i, buf);
   current_insn_ptr = buildaddr;
-  amd64_emit_call (fn);
+  amd64_emit_aligned_call (fn);
 }
 
 /* FN's prototype is `void(*fn)(int,LONGEST)'.  */
@@ -2089,7 +2145,7 @@ amd64_emit_void_call_2 (CORE_ADDR fn, int arg1)
 	    "push %rax\n\t"
 	    /* Also pass top as the second argument.  */
 	    "mov %rax,%rsi");
-  amd64_emit_call (fn);
+  amd64_emit_aligned_call (fn);
   EMIT_ASM (amd64_void_call_2_b,
 	    /* Restore the stack top, %rax may have been trashed.  */
 	    "pop %rax");
@@ -2216,6 +2272,121 @@ amd64_emit_ge_goto (int *offset_p, int *size_p)
     *size_p = 4;
 }
 
+/* Emit code returning expr_eval_divide_by_zero if the divisor, on top
+   of the stack, is zero.  */
+
+static void
+amd64_emit_divide_check (void)
+{
+  unsigned char buf[16];
+  int i;
+  int err = expr_eval_divide_by_zero;
+  CORE_ADDR buildaddr = current_insn_ptr;
+
+  i = 0;
+  buf[i++] = 0x48; buf[i++] = 0x85; buf[i++] = 0xc0; /* test %rax,%rax */
+  buf[i++] = 0x75; buf[i++] = 0x07; /* jnz .+9 */
+  buf[i++] = 0xb8; /* mov $<err>,%eax */
+  memcpy (&buf[i], &err, sizeof (err));
+  i += 4;
+  buf[i++] = 0xc9; /* leave */
+  buf[i++] = 0xc3; /* ret */
+  append_insns (&buildaddr, i, buf);
+  current_insn_ptr = buildaddr;
+}
+
+static void
+amd64_emit_div_signed (void)
+{
+  amd64_emit_divide_check ();
+  EMIT_ASM (amd64_div_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "cqto\n\t"
+	    "idiv %rcx");
+}
+
+static void
+amd64_emit_div_unsigned (void)
+{
+  amd64_emit_divide_check ();
+  EMIT_ASM (amd64_div_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "xor %edx,%edx\n\t"
+	    "div %rcx");
+}
+
+static void
+amd64_emit_rem_signed (void)
+{
+  amd64_emit_divide_check ();
+  EMIT_ASM (amd64_rem_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "cqto\n\t"
+	    "idiv %rcx\n\t"
+	    "mov %rdx,%rax");
+}
+
+static void
+amd64_emit_rem_unsigned (void)
+{
+  amd64_emit_divide_check ();
+  EMIT_ASM (amd64_rem_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "xor %edx,%edx\n\t"
+	    "div %rcx\n\t"
+	    "mov %rdx,%rax");
+}
+
+static void
+amd64_emit_pick (int depth)
+{
+  unsigned char buf[16];
+  int i;
+  int offset = depth * 8;
+  CORE_ADDR buildaddr = current_insn_ptr;
+
+  i = 0;
+  buf[i++] = 0x50; /* push %rax */
+  buf[i++] = 0x48; /* mov <offset>(%rsp),%rax */
+  buf[i++] = 0x8b;
+  buf[i++] = 0x84;
+  buf[i++] = 0x24;
+  memcpy (&buf[i], &offset, sizeof (offset));
+  i += 4;
+  append_insns (&buildaddr, i, buf);
+  current_insn_ptr = buildaddr;
+}
+
+static void
+amd64_emit_rot (void)
+{
+  EMIT_ASM (amd64_rot,
+	    "mov (%rsp),%rcx\n\t"
+	    "mov 0x8(%rsp),%rdx\n\t"
+	    "mov %rdx,(%rsp)\n\t"
+	    "mov %rax,0x8(%rsp)\n\t"
+	    "mov %rcx,%rax");
+}
+
+/* FN's prototype is `void(*fn)(LONGEST,LONGEST)'.  If this empties the
+   stack, the last pop reads the scratch space the prologue reserves
+   below the saved arguments.  */
+
+static void
+amd64_emit_void_call_pop_2 (CORE_ADDR fn)
+{
+  EMIT_ASM (amd64_void_call_pop_2_a,
+	    "mov %rax,%rsi\n\t"
+	    "pop %rdi");
+  amd64_emit_aligned_call (fn);
+  EMIT_ASM (amd64_void_call_pop_2_b,
+	    "pop %rax");
+}
+
 static emit_ops amd64_emit_ops =
   {
     amd64_emit_prologue,
@@ -2254,7 +2425,14 @@ static emit_ops amd64_emit_ops =
     amd64_emit_lt_goto,
     amd64_emit_le_goto,
     amd64_emit_gt_goto,
-    amd64_emit_ge_goto
+    amd64_emit_ge_goto,
+    amd64_emit_div_signed,
+    amd64_emit_div_unsigned,
+    amd64_emit_rem_signed,
+    amd64_emit_rem_unsigned,
+    amd64_emit_pick,
+    amd64_emit_rot,
+    amd64_emit_void_call_pop_2
   };
 
 #endif /* __x86_64__ */
@@ -2953,6 +3131,19 @@ x86_target::low_supports_range_stepping ()
   return true;
 }
 
+int
+x86_target::low_frame_pointer_regno ()
+{
+  const char *name = "ebp";
+
+#ifdef __x86_64__
+  if (is_64bit_tdesc ())
+    name = "rbp";
+#endif
+
+  return find_regno (current_process ()->tdesc, name);
+}
+
 int
 x86_target::get_ipa_tdesc_idx ()
 {
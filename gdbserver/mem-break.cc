@@ -165,6 +165,28 @@ struct point_command_list
   struct point_command_list *next;
 };
 
+/* A software watchpoint.  GDB asks us to check their values after
+   each single-step of the threads it wants running, and to only
+   report a stop when one changes, instead of stepping the threads and
+   checking the values itself.  */
+
+struct software_watchpoint
+{
+  /* Pointer to the next software watchpoint of the process.  */
+  struct software_watchpoint *next;
+
+  /* The agent expression computing the watched value.  */
+  struct agent_expr *expr;
+
+  /* True if VALUE and ERROR hold what EXPR computed the last time we
+     checked.  */
+  bool known;
+
+  /* The value EXPR computed, and the result of the evaluation.  */
+  ULONGEST value;
+  enum eval_result_type error;
+};
+
 /* A high level (in gdbserver's perspective) breakpoint.  */
 struct breakpoint
 {
@@ -1380,6 +1402,102 @@ run_breakpoint_commands (CORE_ADDR where)
 
 /* See mem-break.h.  */
 
+void
+add_software_watchpoint (struct process_info *proc, const char **expr)
+{
+  struct software_watchpoint *wp = XCNEW (struct software_watchpoint);
+  struct software_watchpoint **link = &proc->software_watchpoints;
+
+  wp->expr = gdb_parse_agent_expr (expr);
+
+  /* Keep the list in the order GDB sent it.  */
+  while (*link != NULL)
+    link = &(*link)->next;
+  *link = wp;
+}
+
+/* See mem-break.h.  */
+
+void
+clear_software_watchpoints (struct process_info *proc)
+{
+  struct software_watchpoint *wp = proc->software_watchpoints;
+
+  while (wp != NULL)
+    {
+      struct software_watchpoint *wp_next = wp->next;
+
+      gdb_free_agent_expr (wp->expr);
+      free (wp);
+      wp = wp_next;
+    }
+
+  proc->software_watchpoints = NULL;
+}
+
+/* See mem-break.h.  */
+
+bool
+has_software_watchpoints (struct process_info *proc)
+{
+  return proc->software_watchpoints != NULL;
+}
+
+/* See mem-break.h.  */
+
+bool
+software_watchpoint_value_changed (void)
+{
+  struct eval_agent_expr_context ctx;
+  struct software_watchpoint *wp;
+  bool changed = false;
+
+  ctx.regcache = get_thread_regcache (current_thread, 1);
+  ctx.tframe = NULL;
+  ctx.tpoint = NULL;
+
+  for (wp = current_process ()->software_watchpoints;
+       wp != NULL; wp = wp->next)
+    {
+      ULONGEST value = 0;
+      enum eval_result_type error
+	= gdb_eval_agent_expr (&ctx, wp->expr, &value);
+
+      /* Failing to compute the value where we could before, or the
+	 other way around, is a change too.  */
+      if (wp->known
+	  && (error != wp->error
+	      || (error == expr_eval_no_error && value != wp->value)))
+	changed = true;
+
+      wp->known = true;
+      wp->value = value;
+      wp->error = error;
+    }
+
+  return changed;
+}
+
+/* See mem-break.h.  */
+
+void
+record_software_watchpoint_values (void)
+{
+  struct software_watchpoint *wp;
+
+  if (target_thread_stopped (current_thread))
+    {
+      software_watchpoint_value_changed ();
+      return;
+    }
+
+  for (wp = current_process ()->software_watchpoints;
+       wp != NULL; wp = wp->next)
+    wp->known = false;
+}
+
+/* See mem-break.h.  */
+
 int
 gdb_breakpoint_here (CORE_ADDR where)
 {
@@ -2025,6 +2143,8 @@ free_all_breakpoints (struct process_info *proc)
      current_process from here on.  */
   while (proc->breakpoints)
     delete_breakpoint_1 (proc, proc->breakpoints);
+
+  clear_software_watchpoints (proc);
 }
 
 /* Clone an agent expression.  */
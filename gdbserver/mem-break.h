@@ -137,6 +137,32 @@ int gdb_no_commands_at_breakpoint (CORE_ADDR where);
 
 void run_breakpoint_commands (CORE_ADDR where);
 
+/* Add a software watchpoint to PROC, whose value the agent expression
+   at *EXPR computes.  Advances EXPR past the expression.  */
+
+void add_software_watchpoint (struct process_info *proc, const char **expr);
+
+/* Delete all software watchpoints of PROC.  */
+
+void clear_software_watchpoints (struct process_info *proc);
+
+/* Return true if PROC has software watchpoints.  */
+
+bool has_software_watchpoints (struct process_info *proc);
+
+/* Record the current values of the software watchpoints of the
+   current process, as seen by the current thread if it is stopped.
+   Otherwise, the values are recorded the next time they are
+   checked.  */
+
+void record_software_watchpoint_values (void);
+
+/* Compute the values of the software watchpoints of the current
+   process, as seen by the current thread, which must be stopped.
+   Return true if one of them changed since the last time.  */
+
+bool software_watchpoint_value_changed (void);
+
 /* Returns TRUE if there's a GDB breakpoint (Z0 or Z1) set at
    WHERE.  */
 
@@ -0,0 +1,327 @@
+/* Sampling profiler of the remote server for GDB.
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* While GDB profiles the inferior with "profile -frame-pointers", a
+   timer pauses the threads GDB let run a given number of times per
+   second, and records the PC of each, followed by the return
+   addresses found by following its chain of saved frame pointers.
+   This takes no round trip to GDB, which would have to stop every
+   thread and unwind it with all the debug info at hand; GDB reads
+   the raw samples back with qXfer:profile:read once it is done, and
+   symbolizes them all at once.  The timer only runs in non-stop
+   mode, where the event loop keeps going while the inferior runs.  */
+
+#include "server.h"
+#include "profile.h"
+#include "gdbthread.h"
+#include "regcache.h"
+#include "gdbsupport/event-loop.h"
+#include "gdbsupport/rsp-low.h"
+#include <chrono>
+
+/* The highest sampling frequency, in samples per second, and the
+   deepest stack sampled, in frames.  */
+
+#define PROFILE_MAX_FREQUENCY 1000
+#define PROFILE_MAX_DEPTH 1024
+
+/* How many bytes of samples we keep at most.  Once that many have
+   been taken, further samples are dropped.  */
+
+#define PROFILE_SAMPLES_MAX (16 * 1024 * 1024)
+
+/* The samples taken, in the format of qXfer:profile:read: one line per
+   sample and thread, with the time since profiling started in
+   microseconds, the thread, the PC and the return addresses found,
+   all in hex.  */
+
+static std::string profile_samples;
+
+/* The timer that takes the next sample, or -1 if we aren't
+   profiling.  */
+
+static int profile_timer = -1;
+
+/* The time between samples, and the most frames to record per
+   sample.  */
+
+static std::chrono::microseconds profile_period;
+static int profile_depth;
+
+/* When profiling started, and when the next sample is due.  */
+
+static std::chrono::steady_clock::time_point profile_start;
+static std::chrono::steady_clock::time_point profile_next;
+
+/* Return the address of SIZE bytes at BUF, in the inferior's byte
+   order, which is ours.  */
+
+static CORE_ADDR
+extract_profile_address (const gdb_byte *buf, int size)
+{
+  if (size == 8)
+    {
+      uint64_t addr;
+
+      memcpy (&addr, buf, sizeof (addr));
+      return addr;
+    }
+  else
+    {
+      uint32_t addr;
+
+      memcpy (&addr, buf, sizeof (addr));
+      return addr;
+    }
+}
+
+/* Append a sample of the current thread, taken at TIME, to
+   profile_samples.  */
+
+static void
+sample_current_thread (std::chrono::microseconds time)
+{
+  struct regcache *regcache = get_thread_regcache (current_thread, 1);
+  char ptid_buf[64];
+
+  write_ptid (ptid_buf, current_thread->id);
+  profile_samples += phex_nz (time.count (), sizeof (ULONGEST));
+  profile_samples += ';';
+  profile_samples += ptid_buf;
+  profile_samples += ';';
+  profile_samples += phex_nz (regcache_read_pc (regcache),
+			      sizeof (CORE_ADDR));
+
+  int regno = target_frame_pointer_regno ();
+  int size = regno >= 0 ? register_size (regcache->tdesc, regno) : 0;
+
+  if (size == 4 || size == 8)
+    {
+      gdb_byte buf[16];
+
+      collect_register (regcache, regno, buf);
+      CORE_ADDR fp = extract_profile_address (buf, size);
+
+      for (int i = 1; i < profile_depth && fp != 0; i++)
+	{
+	  if (read_inferior_memory (fp, buf, 2 * size) != 0)
+	    break;
+
+	  CORE_ADDR next_fp = extract_profile_address (buf, size);
+	  CORE_ADDR ret = extract_profile_address (buf + size, size);
+
+	  if (ret == 0)
+	    break;
+
+	  profile_samples += ',';
+	  profile_samples += phex_nz (ret, sizeof (CORE_ADDR));
+
+	  /* Stacks grow down on all the targets that support this, so a
+	     frame pointer that doesn't move up the stack means the
+	     chain is broken, e.g. by code that doesn't keep one.  */
+	  if (next_fp <= fp)
+	    break;
+	  fp = next_fp;
+	}
+    }
+
+  profile_samples += '\n';
+}
+
+/* Take a sample of every thread GDB let run.  */
+
+static void
+sample_threads ()
+{
+  std::vector<thread_info *> threads;
+
+  for_each_thread ([&] (thread_info *thread)
+    {
+      if (thread->last_resume_kind != resume_stop)
+	threads.push_back (thread);
+    });
+
+  if (threads.empty () || profile_samples.size () >= PROFILE_SAMPLES_MAX)
+    return;
+
+  auto time = (std::chrono::duration_cast<std::chrono::microseconds>
+	       (std::chrono::steady_clock::now () - profile_start));
+
+  scoped_restore_current_thread restore_thread;
+
+  target_pause_all (true);
+
+  for (thread_info *thread : threads)
+    {
+      switch_to_thread (thread);
+
+      /* A thread may have exited since we listed it.  Drop the part
+	 of its sample we recorded, if any.  */
+      size_t size = profile_samples.size ();
+      try
+	{
+	  sample_current_thread (time);
+	}
+      catch (const gdb_exception_error &exception)
+	{
+	  profile_samples.resize (size);
+	}
+    }
+
+  target_unpause_all (true);
+}
+
+static void profile_timer_handler (gdb_client_data client_data);
+
+/* Arm the timer for the next sample.  */
+
+static void
+schedule_sample ()
+{
+  using namespace std::chrono;
+
+  steady_clock::time_point now = steady_clock::now ();
+
+  profile_next += profile_period;
+
+  /* If sampling takes longer than the period, skip the samples that
+     are overdue rather than take them in a burst.  */
+  if (profile_next < now)
+    profile_next += ((now - profile_next) / profile_period + 1) * profile_period;
+
+  microseconds delay = duration_cast<microseconds> (profile_next - now);
+  profile_timer = create_timer ((delay.count () + 999) / 1000,
+				profile_timer_handler, NULL);
+}
+
+/* Take the samples that are due, and arm the timer again.  */
+
+static void
+profile_timer_handler (gdb_client_data client_data)
+{
+  profile_timer = -1;
+
+  sample_threads ();
+  schedule_sample ();
+}
+
+/* Start taking FREQUENCY samples per second of the threads GDB let
+   run, recording no more than DEPTH frames of each.  Forget the
+   samples of any previous run.  */
+
+static void
+start_profiling (int frequency, int depth)
+{
+  stop_profiling ();
+
+  profile_samples.clear ();
+  profile_period = std::chrono::microseconds (1000000 / frequency);
+  profile_depth = depth;
+  profile_start = profile_next = std::chrono::steady_clock::now ();
+  schedule_sample ();
+}
+
+/* See profile.h.  */
+
+void
+stop_profiling (void)
+{
+  if (profile_timer != -1)
+    {
+      delete_timer (profile_timer);
+      profile_timer = -1;
+    }
+}
+
+/* See profile.h.  */
+
+int
+read_profile_samples (ULONGEST offset, unsigned char *buf, ULONGEST len)
+{
+  if (offset >= profile_samples.size ())
+    return 0;
+
+  if (len > profile_samples.size () - offset)
+    len = profile_samples.size () - offset;
+
+  memcpy (buf, profile_samples.data () + offset, len);
+  return len;
+}
+
+/* See profile.h.  */
+
+int
+handle_profile_general_set (char *own_buf)
+{
+  if (startswith (own_buf, "QProfile:start:"))
+    {
+      const char *p = own_buf + strlen ("QProfile:start:");
+      ULONGEST frequency, depth;
+
+      p = unpack_varlen_hex (p, &frequency);
+      if (*p++ != ',')
+	{
+	  write_enn (own_buf);
+	  return 1;
+	}
+      p = unpack_varlen_hex (p, &depth);
+      if (*p != '\0'
+	  || frequency == 0 || frequency > PROFILE_MAX_FREQUENCY
+	  || depth == 0 || depth > PROFILE_MAX_DEPTH)
+	{
+	  write_enn (own_buf);
+	  return 1;
+	}
+
+      if (!non_stop)
+	{
+	  strcpy (own_buf, "E.Profiling requires non-stop mode.");
+	  return 1;
+	}
+
+      /* GDB need not have selected a thread yet.  Any will tell
+	 whether the target keeps frame pointers.  */
+      thread_info *thread = current_thread;
+      if (thread == NULL)
+	thread = get_first_thread ();
+
+      scoped_restore_current_thread restore_thread;
+      if (thread != NULL)
+	switch_to_thread (thread);
+
+      if (thread == NULL || target_frame_pointer_regno () < 0)
+	{
+	  strcpy (own_buf,
+		  "E.Frame pointers can not be followed on this target.");
+	  return 1;
+	}
+
+      start_profiling (frequency, depth);
+      write_ok (own_buf);
+      return 1;
+    }
+
+  if (strcmp (own_buf, "QProfile:stop") == 0)
+    {
+      stop_profiling ();
+      write_ok (own_buf);
+      return 1;
+    }
+
+  return 0;
+}
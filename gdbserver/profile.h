@@ -0,0 +1,39 @@
+/* Sampling profiler of the remote server for GDB.
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDBSERVER_PROFILE_H
+#define GDBSERVER_PROFILE_H
+
+/* Handle the QProfile packet in OWN_BUF, writing the reply back into
+   it.  Return 1 if OWN_BUF was a QProfile packet, 0 otherwise.  */
+
+int handle_profile_general_set (char *own_buf);
+
+/* Stop taking samples, if we were.  The samples taken so far can
+   still be read.  */
+
+void stop_profiling (void);
+
+/* Read LEN bytes of the samples taken at OFFSET into BUF, for
+   qXfer:profile:read.  Return the number of bytes read, or 0 at the
+   end.  */
+
+int read_profile_samples (ULONGEST offset, unsigned char *buf,
+			  ULONGEST len);
+
+#endif /* GDBSERVER_PROFILE_H */
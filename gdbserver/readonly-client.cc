@@ -0,0 +1,981 @@
+/* Read-only clients of the remote server for GDB.
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Read-only clients connect on a port of their own, alongside the GDB
+   that controls the inferior, and speak the same remote protocol.
+   They are served from the event loop, one packet at a time, so they
+   get answers while the inferior runs in non-stop mode, and while it
+   is stopped in all-stop mode.  Only packets that neither resume, stop
+   nor modify the inferior are accepted; anything else gets the empty
+   reply of an unsupported packet.
+
+   Their sockets are non-blocking.  A reply that can't be sent right
+   away is queued, and the client's further packets wait until it is
+   sent, so a client that stops reading never blocks gdbserver, and is
+   disconnected if it doesn't catch up in time.
+
+   What they read comes from a snapshot shared by all of them.  The
+   registers of a stopped thread are those of its regcache, which is
+   fetched at most once per stop, and those of a running thread are a
+   copy of its registers from when it was last resumed.  Memory is read
+   in blocks, which are kept until the inferior next stops or is
+   written to, so several clients reading the same data cost a single
+   access to the inferior.  */
+
+#include "server.h"
+#include "readonly-client.h"
+#include "gdbthread.h"
+#include "regcache.h"
+#include "tdesc.h"
+#include "tracepoint.h"
+#include "gdbsupport/rsp-low.h"
+#include "gdbsupport/byte-vector.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#if HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#if HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#if HAVE_NETDB_H
+#include <netdb.h>
+#endif
+#if HAVE_NETINET_TCP_H
+#include <netinet/tcp.h>
+#endif
+#if HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+#include "gdbsupport/gdb_sys_time.h"
+#include "gdbsupport/netstuff.h"
+#include "gdbsupport/event-loop.h"
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if USE_WIN32API
+#include <ws2tcpip.h>
+#endif
+
+#ifndef HAVE_SOCKLEN_T
+typedef int socklen_t;
+#endif
+
+#ifdef USE_WIN32API
+/* gnulib wraps these as macros, undo them.  */
+# undef read
+# undef write
+
+# define read(fd, buf, len) recv (fd, (char *) buf, len, 0)
+# define write(fd, buf, len) send (fd, (char *) buf, len, 0)
+#endif
+
+/* The size and alignment of the blocks of memory in the snapshot.
+   This divides the page size, so a block is either entirely readable
+   or not at all.  */
+#define READONLY_MEMORY_BLOCK_SIZE 256
+
+/* The number of blocks of memory the snapshot holds at most, before
+   it starts over.  */
+#define READONLY_MEMORY_MAX_BLOCKS 4096
+
+/* How long, in seconds, a reply to a read-only client may stay
+   unsent before the client is disconnected.  */
+#define READONLY_CLIENT_SEND_TIMEOUT 5
+
+/* How often, in milliseconds, sending the queued output of a
+   read-only client is retried.  */
+#define READONLY_CLIENT_SEND_RETRY 10
+
+/* A client connected on the read-only port.  */
+
+struct readonly_client
+{
+  explicit readonly_client (int fd_)
+    : fd (fd_)
+  {}
+
+  /* The connection to the client.  */
+  int fd;
+
+  /* The protocol state of the client, which is what get_client_state
+     returns while its requests are handled.  */
+  client_state cs;
+
+  /* Input received from the client, but not yet handled.  */
+  std::string input;
+
+  /* Output for the client that could not be sent yet.  */
+  std::string output;
+
+  /* The timer retrying to send OUTPUT, or 0.  */
+  int send_timer = 0;
+
+  /* When some output was last sent to the client, or when OUTPUT
+     last started queuing up.  */
+  std::chrono::steady_clock::time_point last_sent;
+
+  /* Whether the client asked for non-stop mode.  */
+  bool non_stop = false;
+
+  /* The threads not yet listed in reply to qsThreadInfo.  */
+  std::vector<ptid_t> threads_to_list;
+};
+
+/* Deleter for the copies of regcaches in the snapshot.  */
+
+struct regcache_deleter
+{
+  void operator() (struct regcache *regcache) const
+  {
+    free_register_cache (regcache);
+  }
+};
+
+/* What read-only clients are shown of the inferior.  */
+
+struct readonly_snapshot
+{
+  /* The registers of threads, as they were when the threads were last
+     resumed.  */
+  std::unordered_map<ptid_t, std::unique_ptr<struct regcache,
+					     regcache_deleter>,
+		     hash_ptid> registers;
+
+  /* Blocks of memory, by process and address.  A block that could not
+     be read is empty.  */
+  std::map<std::pair<int, CORE_ADDR>, gdb::byte_vector> memory;
+};
+
+/* The socket read-only clients connect to, or -1.  */
+
+static int readonly_listen_desc = -1;
+
+/* The connected read-only clients.  */
+
+static std::vector<std::unique_ptr<readonly_client>> readonly_clients;
+
+/* The state of the inferior shown to all read-only clients.  */
+
+static readonly_snapshot snapshot;
+
+/* See readonly-client.h.  */
+
+void
+readonly_clients_save_registers (thread_info *thread,
+				 struct regcache *regcache)
+{
+  if (readonly_clients.empty ())
+    return;
+
+  auto &saved = snapshot.registers[thread->id];
+  if (saved == nullptr || saved->tdesc != regcache->tdesc)
+    saved.reset (new_register_cache (regcache->tdesc));
+  regcache_cpy (saved.get (), regcache);
+}
+
+/* See readonly-client.h.  */
+
+void
+readonly_clients_thread_resuming (thread_info *thread)
+{
+  /* In all-stop mode, read-only clients are only served while all
+     threads are stopped.  */
+  if (!non_stop || readonly_clients.empty ())
+    return;
+
+  struct process_info *proc = get_thread_process (thread);
+  if (proc->tdesc == nullptr || !the_target->supports_thread_stopped ()
+      || !target_thread_stopped (thread))
+    return;
+
+  /* If the regcache holds the registers, regcache_invalidate_thread
+     saves them when the thread resumes.  */
+  struct regcache *regcache = thread_regcache_data (thread);
+  if (regcache != nullptr && regcache->registers_valid)
+    return;
+
+  /* Otherwise fetch them into the snapshot directly, which spares
+     writing them back to the thread when it resumes.  */
+  auto &saved = snapshot.registers[thread->id];
+  if (saved == nullptr || saved->tdesc != proc->tdesc)
+    saved.reset (new_register_cache (proc->tdesc));
+
+  scoped_restore_current_thread restore_thread;
+  switch_to_thread (thread);
+  memset (saved->register_status, REG_UNAVAILABLE,
+	  saved->tdesc->reg_defs.size ());
+
+  try
+    {
+      fetch_inferior_registers (saved.get (), -1);
+    }
+  catch (const gdb_exception_error &exception)
+    {
+      snapshot.registers.erase (thread->id);
+    }
+}
+
+/* See readonly-client.h.  */
+
+void
+readonly_clients_forget_thread (thread_info *thread)
+{
+  snapshot.registers.erase (thread->id);
+}
+
+/* See readonly-client.h.  */
+
+void
+readonly_clients_invalidate_memory ()
+{
+  snapshot.memory.clear ();
+}
+
+/* Return true if THREAD is known to be stopped, so that reading its
+   registers does not disturb it.  */
+
+static bool
+readonly_thread_stopped (thread_info *thread)
+{
+  /* In all-stop mode, the event loop, and so read-only clients, only
+     run while all threads are stopped.  */
+  if (!non_stop)
+    return true;
+
+  return (the_target->supports_thread_stopped ()
+	  && target_thread_stopped (thread));
+}
+
+/* Return the registers of THREAD to show read-only clients, or NULL
+   if they are not known.  */
+
+static struct regcache *
+readonly_thread_registers (thread_info *thread)
+{
+  if (readonly_thread_stopped (thread))
+    {
+      if (get_thread_process (thread)->tdesc == nullptr)
+	return nullptr;
+      return get_thread_regcache (thread, 1);
+    }
+
+  auto it = snapshot.registers.find (thread->id);
+  if (it == snapshot.registers.end ())
+    return nullptr;
+  return it->second.get ();
+}
+
+/* Return the block of memory at ADDR, aligned on
+   READONLY_MEMORY_BLOCK_SIZE, of the current process, reading it from
+   the inferior if the snapshot does not have it yet.  */
+
+static const gdb::byte_vector &
+readonly_memory_block (CORE_ADDR addr)
+{
+  std::pair<int, CORE_ADDR> key (pid_of (current_process ()), addr);
+
+  auto it = snapshot.memory.find (key);
+  if (it != snapshot.memory.end ())
+    return it->second;
+
+  if (snapshot.memory.size () >= READONLY_MEMORY_MAX_BLOCKS)
+    snapshot.memory.clear ();
+
+  gdb::byte_vector block (READONLY_MEMORY_BLOCK_SIZE);
+  if (read_inferior_memory (addr, block.data (), block.size ()) != 0)
+    block.clear ();
+
+  return snapshot.memory.emplace (key, std::move (block)).first->second;
+}
+
+/* Read LEN bytes at MEMADDR of the current process into MYADDR,
+   through the snapshot.  Return the number of bytes read, which is
+   less than LEN if there is unreadable memory in the range.  */
+
+static int
+readonly_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
+{
+  int done = 0;
+
+  while (done < len)
+    {
+      CORE_ADDR addr = memaddr + done;
+      CORE_ADDR block_addr = addr - addr % READONLY_MEMORY_BLOCK_SIZE;
+      const gdb::byte_vector &block = readonly_memory_block (block_addr);
+
+      if (block.empty ())
+	break;
+
+      int offset = addr - block_addr;
+      int n = std::min (len - done, READONLY_MEMORY_BLOCK_SIZE - offset);
+
+      memcpy (myaddr + done, block.data () + offset, n);
+      done += n;
+    }
+
+  return done;
+}
+
+/* Close the connection to CLIENT and forget about it.  */
+
+static void
+readonly_client_close (readonly_client *client)
+{
+  if (client->send_timer != 0)
+    delete_timer (client->send_timer);
+  delete_file_handler (client->fd);
+#ifdef USE_WIN32API
+  closesocket (client->fd);
+#else
+  close (client->fd);
+#endif
+
+  for (auto it = readonly_clients.begin (); it != readonly_clients.end ();
+       ++it)
+    if (it->get () == client)
+      {
+	readonly_clients.erase (it);
+	break;
+      }
+
+  if (readonly_clients.empty ())
+    {
+      snapshot.registers.clear ();
+      snapshot.memory.clear ();
+    }
+}
+
+static bool readonly_client_process_input (readonly_client *client);
+static void readonly_client_send_retry (gdb_client_data client_data);
+
+/* Send as much of the queued output of CLIENT as the connection takes
+   without blocking.  If some is left, arrange for sending it to be
+   retried later.  Return false if the connection failed, or if CLIENT
+   hasn't taken any output for too long.  */
+
+static bool
+readonly_client_send (readonly_client *client)
+{
+  std::string &output = client->output;
+  size_t sent = 0;
+
+  while (sent < output.size ())
+    {
+      int n = write (client->fd, output.data () + sent,
+		     output.size () - sent);
+
+      if (n > 0)
+	{
+	  sent += n;
+	  client->last_sent = std::chrono::steady_clock::now ();
+	  continue;
+	}
+
+#ifdef USE_WIN32API
+      if (n < 0 && WSAGetLastError () == WSAEWOULDBLOCK)
+	break;
+#else
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	break;
+#endif
+      return false;
+    }
+
+  output.erase (0, sent);
+  if (output.empty ())
+    return true;
+
+  if (std::chrono::steady_clock::now () - client->last_sent
+      > std::chrono::seconds (READONLY_CLIENT_SEND_TIMEOUT))
+    {
+      remote_debug_printf ("readonly %d: client stopped reading",
+			   client->fd);
+      return false;
+    }
+
+  if (client->send_timer == 0)
+    client->send_timer = create_timer (READONLY_CLIENT_SEND_RETRY,
+				       readonly_client_send_retry, client);
+  return true;
+}
+
+/* Timer callback retrying to send the queued output of the read-only
+   client in CLIENT_DATA, and then handling the packets it sent in the
+   meantime.  */
+
+static void
+readonly_client_send_retry (gdb_client_data client_data)
+{
+  readonly_client *client = (readonly_client *) client_data;
+
+  client->send_timer = 0;
+  if (readonly_client_send (client)
+      && (!client->output.empty ()
+	  || readonly_client_process_input (client)))
+    return;
+
+  fprintf (stderr, _("Read-only client disconnected\n"));
+  readonly_client_close (client);
+}
+
+/* Queue the LEN bytes of BUF for CLIENT, and send what can be sent
+   right away.  Return false if the connection failed.  */
+
+static bool
+readonly_client_write (readonly_client *client, const char *buf, int len)
+{
+  if (client->output.empty ())
+    client->last_sent = std::chrono::steady_clock::now ();
+  client->output.append (buf, len);
+
+  if (client->send_timer != 0)
+    return true;
+  return readonly_client_send (client);
+}
+
+/* Send the packet of LEN bytes in BUF to CLIENT.  Return false if
+   that failed.  */
+
+static bool
+readonly_client_putpkt (readonly_client *client, const char *buf, int len)
+{
+  std::string packet;
+  unsigned char csum = 0;
+
+  packet.reserve (len + 4);
+  packet += '$';
+  for (int i = 0; i < len; i++)
+    {
+      csum += buf[i];
+      packet += buf[i];
+    }
+  packet += '#';
+  packet += tohex ((csum >> 4) & 0xf);
+  packet += tohex (csum & 0xf);
+
+  remote_debug_printf ("readonly %d: putpkt (\"%s\");", client->fd,
+		       packet.c_str ());
+
+  return readonly_client_write (client, packet.data (), packet.size ());
+}
+
+/* Reply to a qSupported packet in OWN_BUF.  */
+
+static void
+readonly_handle_qsupported (char *own_buf)
+{
+  client_state &cs = get_client_state ();
+  char *p = strchr (own_buf, ':');
+
+  if (p != nullptr)
+    {
+      char *saveptr;
+
+      for (p = strtok_r (p + 1, ";", &saveptr);
+	   p != nullptr;
+	   p = strtok_r (nullptr, ";", &saveptr))
+	if (strcmp (p, "multiprocess+") == 0
+	    && the_target->supports_multi_process ())
+	  cs.multi_process = 1;
+    }
+
+  sprintf (own_buf, "PacketSize=%x;QStartNoAckMode+;QNonStop+"
+	   ";qXfer:features:read+", PBUFSIZ - 1);
+
+  if (cs.multi_process)
+    strcat (own_buf, ";multiprocess+");
+
+  if (the_target->supports_read_auxv ())
+    strcat (own_buf, ";qXfer:auxv:read+");
+
+  if (the_target->supports_qxfer_libraries_svr4 ())
+    strcat (own_buf, ";qXfer:libraries-svr4:read+");
+
+  if (the_target->supports_pid_to_exec_file ())
+    strcat (own_buf, ";qXfer:exec-file:read+");
+
+  if (target_supports_tracepoints ())
+    strcat (own_buf, ";qXfer:trace-buffer:read+");
+}
+
+/* Return true if the qXfer packet in OWN_BUF is one read-only clients
+   may send.  */
+
+static bool
+readonly_qxfer_allowed (const char *own_buf)
+{
+  static const char *const allowed[] =
+    {
+      "qXfer:auxv:read:",
+      "qXfer:exec-file:read:",
+      "qXfer:features:read:",
+      "qXfer:libraries:read:",
+      "qXfer:libraries-svr4:read:",
+      /* The zlib stream is shared by all clients, so only the plain
+	 trace buffer can be read here.  */
+      "qXfer:trace-buffer:read::",
+    };
+
+  for (const char *prefix : allowed)
+    if (startswith (own_buf, prefix))
+      return true;
+
+  return false;
+}
+
+/* Reply to the 'H' packet in OWN_BUF.  */
+
+static void
+readonly_handle_set_thread (char *own_buf)
+{
+  client_state &cs = get_client_state ();
+
+  if (own_buf[1] != 'g')
+    {
+      /* Read-only clients never resume threads, so the thread to
+	 resume does not matter.  */
+      write_ok (own_buf);
+      return;
+    }
+
+  ptid_t thread_id = read_ptid (&own_buf[2], NULL);
+  thread_info *thread;
+
+  if (thread_id == null_ptid || thread_id == minus_one_ptid)
+    {
+      thread = find_thread_ptid (cs.general_thread);
+      if (thread == nullptr)
+	thread = get_first_thread ();
+    }
+  else if (thread_id.is_pid ())
+    thread = find_any_thread_of_pid (thread_id.pid ());
+  else
+    thread = find_thread_ptid (thread_id);
+
+  if (thread == nullptr)
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  cs.general_thread = thread->id;
+  write_ok (own_buf);
+}
+
+/* Reply to a qfThreadInfo or qsThreadInfo packet from CLIENT, in
+   OWN_BUF.  Threads are listed as many to a packet as fit.  */
+
+static void
+readonly_handle_thread_info (readonly_client *client, char *own_buf)
+{
+  if (own_buf[1] == 'f')
+    {
+      client->threads_to_list.clear ();
+      for (thread_info *thread : all_threads)
+	client->threads_to_list.push_back (thread->id);
+    }
+
+  if (client->threads_to_list.empty ())
+    {
+      strcpy (own_buf, "l");
+      return;
+    }
+
+  char *p = own_buf;
+  size_t count = 0;
+
+  *p++ = 'm';
+  for (const ptid_t &ptid : client->threads_to_list)
+    {
+      /* Leave room for one more thread id.  */
+      if (p - own_buf > PBUFSIZ - 64)
+	break;
+      if (count > 0)
+	*p++ = ',';
+      p = write_ptid (p, ptid);
+      count++;
+    }
+  *p = '\0';
+
+  client->threads_to_list.erase (client->threads_to_list.begin (),
+				 client->threads_to_list.begin () + count);
+}
+
+/* Reply to the 'm' packet in OWN_BUF.  */
+
+static void
+readonly_handle_read_memory (char *own_buf)
+{
+  CORE_ADDR mem_addr;
+  unsigned int len;
+
+  decode_m_packet (&own_buf[1], &mem_addr, &len);
+  if (len > PBUFSIZ / 2)
+    len = PBUFSIZ / 2;
+
+  gdb::byte_vector buf (len);
+  int res = readonly_read_memory (mem_addr, buf.data (), len);
+
+  if (res == 0 && len > 0)
+    write_enn (own_buf);
+  else
+    bin2hex (buf.data (), own_buf, res);
+}
+
+/* Handle the packet of PACKET_LEN bytes CLIENT sent, in its OWN_BUF,
+   leaving the reply there.  Set *REPLY_LEN to the length of the
+   reply if it is binary, or leave it alone.  Return false if the
+   connection to CLIENT should be closed after the reply.  */
+
+static bool
+readonly_client_handle_packet (readonly_client *client, int packet_len,
+			       int *reply_len)
+{
+  client_state &cs = get_client_state ();
+  char *own_buf = cs.own_buf;
+
+  /* Make the client's selected thread current, or any thread if it
+     did not select one, and restore GDB's afterwards.  */
+  scoped_restore_current_thread restore_thread;
+  if (!set_desired_thread () && !all_threads.empty ())
+    switch_to_thread (get_first_thread ());
+
+  switch (own_buf[0])
+    {
+    case 'q':
+      if (startswith (own_buf, "qSupported"))
+	readonly_handle_qsupported (own_buf);
+      else if (strcmp (own_buf, "qfThreadInfo") == 0
+	       || strcmp (own_buf, "qsThreadInfo") == 0)
+	readonly_handle_thread_info (client, own_buf);
+      else if (strcmp (own_buf, "qC") == 0)
+	{
+	  if (current_thread == nullptr)
+	    write_enn (own_buf);
+	  else
+	    {
+	      strcpy (own_buf, "QC");
+	      write_ptid (own_buf + 2, current_thread->id);
+	    }
+	}
+      else if (startswith (own_buf, "qAttached"))
+	{
+	  /* The inferior is not the client's to kill.  */
+	  strcpy (own_buf, "1");
+	}
+      else if (startswith (own_buf, "qXfer:"))
+	{
+	  if (!readonly_qxfer_allowed (own_buf)
+	      || !handle_qxfer (own_buf, packet_len, reply_len))
+	    own_buf[0] = '\0';
+	}
+      else if (target_supports_tracepoints ()
+	       && handle_tracepoint_readonly_query (own_buf))
+	;
+      else
+	own_buf[0] = '\0';
+      break;
+    case 'Q':
+      if (strcmp (own_buf, "QStartNoAckMode") == 0)
+	write_ok (own_buf);
+      else if (startswith (own_buf, "QNonStop:"))
+	{
+	  client->non_stop = own_buf[strlen ("QNonStop:")] == '1';
+	  write_ok (own_buf);
+	}
+      else
+	own_buf[0] = '\0';
+      break;
+    case '?':
+      if (client->non_stop)
+	{
+	  /* Read-only clients are not told of stops, so leave the
+	     threads running as far as the client knows.  */
+	  write_ok (own_buf);
+	}
+      else if (current_thread == nullptr)
+	strcpy (own_buf, "W00");
+      else
+	{
+	  strcpy (own_buf, "T00thread:");
+	  char *p = write_ptid (own_buf + strlen (own_buf),
+				current_thread->id);
+	  strcpy (p, ";");
+	}
+      break;
+    case 'H':
+      readonly_handle_set_thread (own_buf);
+      break;
+    case 'g':
+      {
+	struct regcache *regcache = nullptr;
+
+	if (current_thread != nullptr)
+	  regcache = readonly_thread_registers (current_thread);
+	if (regcache == nullptr)
+	  write_enn (own_buf);
+	else
+	  registers_to_string (regcache, own_buf);
+      }
+      break;
+    case 'm':
+      if (current_thread == nullptr)
+	write_enn (own_buf);
+      else
+	readonly_handle_read_memory (own_buf);
+      break;
+    case 'T':
+      if (find_thread_ptid (read_ptid (&own_buf[1], NULL)) == nullptr)
+	write_enn (own_buf);
+      else
+	write_ok (own_buf);
+      break;
+    case 'D':
+      write_ok (own_buf);
+      return false;
+    case 'k':
+      /* No reply is expected.  */
+      return false;
+    default:
+      own_buf[0] = '\0';
+      break;
+    }
+
+  return true;
+}
+
+/* Handle the complete packets in the input of CLIENT.  Return false
+   if the connection to CLIENT should be closed.  */
+
+static bool
+readonly_client_process_input (readonly_client *client)
+{
+  std::string &input = client->input;
+  size_t pos = 0;
+  bool keep = true;
+
+  /* A client is sent one reply at a time, so wait until the previous
+     reply is sent before handling the next packet.  */
+  while (keep && pos < input.size () && client->output.empty ())
+    {
+      /* Acknowledgments, interrupt requests and line noise are
+	 dropped.  */
+      if (input[pos] != '$')
+	{
+	  pos++;
+	  continue;
+	}
+
+      size_t hash = input.find ('#', pos);
+      if (hash == std::string::npos || hash + 2 >= input.size ())
+	break;
+
+      const char *data = input.data () + pos + 1;
+      int packet_len = hash - pos - 1;
+      unsigned char csum = 0;
+
+      for (int i = 0; i < packet_len; i++)
+	csum += data[i];
+
+      bool csum_ok = (isxdigit (input[hash + 1])
+		      && isxdigit (input[hash + 2])
+		      && csum == ((fromhex (input[hash + 1]) << 4)
+				  | fromhex (input[hash + 2])));
+      pos = hash + 3;
+
+      client_state &cs = client->cs;
+
+      if (!cs.noack_mode
+	  && !readonly_client_write (client, csum_ok ? "+" : "-", 1))
+	return false;
+      if (!csum_ok)
+	continue;
+
+      if (packet_len > PBUFSIZ)
+	{
+	  remote_debug_printf ("readonly %d: packet too long", client->fd);
+	  write_enn (cs.own_buf);
+	  if (!readonly_client_putpkt (client, cs.own_buf,
+				       strlen (cs.own_buf)))
+	    return false;
+	  continue;
+	}
+
+      memcpy (cs.own_buf, data, packet_len);
+      cs.own_buf[packet_len] = '\0';
+
+      remote_debug_printf ("readonly %d: getpkt (\"%s\");", client->fd,
+			   cs.own_buf);
+
+      int reply_len = -1;
+      bool noack = strcmp (cs.own_buf, "QStartNoAckMode") == 0;
+
+      {
+	scoped_restore_tmpl<client_state *> restore_cs
+	  = make_scoped_restore_client_state (&cs);
+
+	try
+	  {
+	    keep = readonly_client_handle_packet (client, packet_len,
+						  &reply_len);
+	  }
+	catch (const gdb_exception_error &exception)
+	  {
+	    remote_debug_printf ("readonly %d: %s", client->fd,
+				 exception.what ());
+	    write_enn (cs.own_buf);
+	  }
+      }
+
+      if (reply_len < 0)
+	reply_len = strlen (cs.own_buf);
+
+      /* After killing, the client expects no reply.  */
+      if (cs.own_buf[0] != 'k'
+	  && !readonly_client_putpkt (client, cs.own_buf, reply_len))
+	return false;
+
+      if (noack)
+	cs.noack_mode = 1;
+    }
+
+  input.erase (0, pos);
+  return keep;
+}
+
+/* Event loop callback for input from the read-only client in
+   CLIENT_DATA.  */
+
+static void
+handle_readonly_client_event (int err, gdb_client_data client_data)
+{
+  readonly_client *client = (readonly_client *) client_data;
+  char buf[BUFSIZ];
+
+  int n = read (client->fd, buf, sizeof (buf));
+  if (n > 0)
+    {
+      client->input.append (buf, n);
+      if (readonly_client_process_input (client))
+	return;
+    }
+#ifdef USE_WIN32API
+  else if (n < 0 && WSAGetLastError () == WSAEWOULDBLOCK)
+    return;
+#else
+  else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK
+		     || errno == EINTR))
+    return;
+#endif
+
+  fprintf (stderr, _("Read-only client disconnected\n"));
+  readonly_client_close (client);
+}
+
+/* Event loop callback for a new read-only client.  */
+
+static void
+handle_readonly_accept_event (int err, gdb_client_data client_data)
+{
+  struct sockaddr_storage sockaddr;
+  socklen_t len = sizeof (sockaddr);
+
+  int fd = accept (readonly_listen_desc, (struct sockaddr *) &sockaddr,
+		   &len);
+  if (fd == -1)
+    {
+      warning (_("Accepting a read-only client failed: %s"),
+	       safe_strerror (errno));
+      return;
+    }
+
+  socklen_t tmp = 1;
+  setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, (char *) &tmp, sizeof (tmp));
+  tmp = 1;
+  setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, (char *) &tmp, sizeof (tmp));
+
+  /* A client that stops reading its replies must not stall the
+     debugging session, so never block on the connection.  */
+#ifdef USE_WIN32API
+  u_long nonblocking = 1;
+  ioctlsocket (fd, FIONBIO, &nonblocking);
+#else
+  fcntl (fd, F_SETFL, fcntl (fd, F_GETFL, 0) | O_NONBLOCK);
+
+  signal (SIGPIPE, SIG_IGN);
+#endif
+
+  char orig_host[GDB_NI_MAX_ADDR], orig_port[GDB_NI_MAX_PORT];
+
+  int r = getnameinfo ((struct sockaddr *) &sockaddr, len,
+		       orig_host, sizeof (orig_host),
+		       orig_port, sizeof (orig_port),
+		       NI_NUMERICHOST | NI_NUMERICSERV);
+
+  if (r != 0)
+    fprintf (stderr, _("Could not obtain remote address: %s\n"),
+	     gai_strerror (r));
+  else
+    fprintf (stderr, _("Read-only client from host %s, port %s\n"),
+	     orig_host, orig_port);
+
+  readonly_clients.emplace_back (new readonly_client (fd));
+  add_file_handler (fd, handle_readonly_client_event,
+		    readonly_clients.back ().get (), "readonly-client");
+}
+
+/* See readonly-client.h.  */
+
+void
+readonly_clients_listen (const char *name)
+{
+  readonly_listen_desc = remote_listen (name);
+  if (readonly_listen_desc == -1)
+    error (_("%s: read-only clients can only connect over TCP"), name);
+
+  struct sockaddr_storage sockaddr;
+  socklen_t len = sizeof (sockaddr);
+  char listen_port[GDB_NI_MAX_PORT];
+
+  if (getsockname (readonly_listen_desc, (struct sockaddr *) &sockaddr,
+		   &len) < 0)
+    perror_with_name ("Can't determine port");
+
+  int r = getnameinfo ((struct sockaddr *) &sockaddr, len,
+		       NULL, 0,
+		       listen_port, sizeof (listen_port),
+		       NI_NUMERICSERV);
+
+  if (r != 0)
+    fprintf (stderr, _("Can't obtain port where we are listening: %s"),
+	     gai_strerror (r));
+  else
+    fprintf (stderr, _("Listening on port %s for read-only clients\n"),
+	     listen_port);
+
+  fflush (stderr);
+
+  add_file_handler (readonly_listen_desc, handle_readonly_accept_event,
+		    NULL, "readonly-listen");
+}
@@ -0,0 +1,55 @@
+/* Read-only clients of the remote server for GDB.
+   Copyright (C) 2022 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDBSERVER_READONLY_CLIENT_H
+#define GDBSERVER_READONLY_CLIENT_H
+
+struct thread_info;
+struct regcache;
+
+/* Start accepting read-only clients on NAME, a [HOST]:PORT
+   specification.  Read-only clients may connect alongside the GDB
+   that controls the inferior, and only inspect it: they can read
+   registers and memory, list threads and query the trace run, but
+   never resume, stop or modify the inferior.  */
+
+extern void readonly_clients_listen (const char *name);
+
+/* Called when THREAD is resumed, with REGCACHE holding its registers,
+   so that read-only clients can still be shown them while it
+   runs.  */
+
+extern void readonly_clients_save_registers (thread_info *thread,
+					     struct regcache *regcache);
+
+/* Called when GDB is about to resume THREAD, so that read-only
+   clients can be shown its registers while it runs, even if GDB never
+   read them.  */
+
+extern void readonly_clients_thread_resuming (thread_info *thread);
+
+/* Called when THREAD is gone.  */
+
+extern void readonly_clients_forget_thread (thread_info *thread);
+
+/* Forget the memory read-only clients were shown since the inferior
+   last stopped, because it stopped again or was written to.  */
+
+extern void readonly_clients_invalidate_memory ();
+
+#endif /* GDBSERVER_READONLY_CLIENT_H */
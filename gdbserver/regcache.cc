@@ -21,6 +21,7 @@
 #include "gdbthread.h"
 #include "tdesc.h"
 #include "gdbsupport/rsp-low.h"
+#include "readonly-client.h"
 #ifndef IN_PROCESS_AGENT
 
 struct regcache *
@@ -86,6 +87,8 @@ regcache_invalidate_thread (struct thread_info *thread)
 
       switch_to_thread (thread);
       store_inferior_registers (regcache, -1);
+
+      readonly_clients_save_registers (thread, regcache);
     }
 
   regcache->registers_valid = 0;
@@ -227,6 +230,42 @@ registers_to_string (struct regcache *regcache, char *buf)
   *buf = '\0';
 }
 
+/* Write register REGNO of REGCACHE to BUF as a "NN:VALUE;" pair.
+   Return a pointer to the end of the written data.  */
+
+static char *
+outreg (struct regcache *regcache, int regno, char *buf)
+{
+  if ((regno >> 12) != 0)
+    *buf++ = tohex ((regno >> 12) & 0xf);
+  if ((regno >> 8) != 0)
+    *buf++ = tohex ((regno >> 8) & 0xf);
+  *buf++ = tohex ((regno >> 4) & 0xf);
+  *buf++ = tohex (regno & 0xf);
+  *buf++ = ':';
+  collect_register_as_string (regcache, regno, buf);
+  buf += 2 * register_size (regcache->tdesc, regno);
+  *buf++ = ';';
+
+  return buf;
+}
+
+/* See regcache.h.  */
+
+char *
+expedited_registers_to_string (struct regcache *regcache, char *buf)
+{
+  const char **regp = regcache->tdesc->expedite_regs;
+
+  while (*regp)
+    {
+      buf = outreg (regcache, find_regno (regcache->tdesc, *regp), buf);
+      regp++;
+    }
+
+  return buf;
+}
+
 void
 registers_from_string (struct regcache *regcache, char *buf)
 {
@@ -266,6 +305,7 @@ free_register_cache_thread (struct thread_info *thread)
       regcache_invalidate_thread (thread);
       free_register_cache (regcache);
       set_thread_regcache_data (thread, NULL);
+      readonly_clients_forget_thread (thread);
     }
 }
 
@@ -102,6 +102,13 @@ void registers_to_string (struct regcache *regcache, char *buf);
 
 void registers_from_string (struct regcache *regcache, char *buf);
 
+/* Write the expedited registers of REGCACHE's target description to
+   BUF, as a series of "NN:VALUE;" pairs, the format used in stop
+   replies.  Return a pointer to the end of the written data.  Does
+   not NUL-terminate BUF.  */
+
+char *expedited_registers_to_string (struct regcache *regcache, char *buf);
+
 /* For regcache_read_pc see gdbsupport/common-regcache.h.  */
 
 void regcache_write_pc (struct regcache *regcache, CORE_ADDR pc);
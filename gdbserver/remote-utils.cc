@@ -208,28 +208,16 @@ handle_accept_event (int err, gdb_client_data client_data)
   target_async (0);
 }
 
-/* Prepare for a later connection to a remote debugger.
-   NAME is the filename used for communication.  */
+/* See remote-utils.h.  */
 
-void
-remote_prepare (const char *name)
+int
+remote_listen (const char *name)
 {
-  client_state &cs = get_client_state ();
 #ifdef USE_WIN32API
   static int winsock_initialized;
 #endif
   socklen_t tmp;
-
-  remote_is_stdio = 0;
-  if (strcmp (name, STDIO_CONNECTION_NAME) == 0)
-    {
-      /* We need to record fact that we're using stdio sooner than the
-	 call to remote_open so start_inferior knows the connection is
-	 via stdio.  */
-      remote_is_stdio = 1;
-      cs.transport_is_reliable = 1;
-      return;
-    }
+  int fd;
 
   struct addrinfo hint;
   struct addrinfo *ainfo;
@@ -245,10 +233,7 @@ remote_prepare (const char *name)
     = parse_connection_spec_without_prefix (name, &hint);
 
   if (parsed.port_str.empty ())
-    {
-      cs.transport_is_reliable = 0;
-      return;
-    }
+    return -1;
 
 #ifdef USE_WIN32API
   if (!winsock_initialized)
@@ -272,10 +257,10 @@ remote_prepare (const char *name)
 
   for (iter = ainfo; iter != NULL; iter = iter->ai_next)
     {
-      listen_desc = gdb_socket_cloexec (iter->ai_family, iter->ai_socktype,
-					iter->ai_protocol);
+      fd = gdb_socket_cloexec (iter->ai_family, iter->ai_socktype,
+			       iter->ai_protocol);
 
-      if (listen_desc >= 0)
+      if (fd >= 0)
 	break;
     }
 
@@ -284,7 +269,7 @@ remote_prepare (const char *name)
 
   /* Allow rapid reuse of this port. */
   tmp = 1;
-  setsockopt (listen_desc, SOL_SOCKET, SO_REUSEADDR, (char *) &tmp,
+  setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, (char *) &tmp,
 	      sizeof (tmp));
 
   switch (iter->ai_family)
@@ -300,12 +285,41 @@ remote_prepare (const char *name)
 		      _("Invalid 'ai_family' %d\n"), iter->ai_family);
     }
 
-  if (bind (listen_desc, iter->ai_addr, iter->ai_addrlen) != 0)
+  if (bind (fd, iter->ai_addr, iter->ai_addrlen) != 0)
     perror_with_name ("Can't bind address");
 
-  if (listen (listen_desc, 1) != 0)
+  if (listen (fd, 1) != 0)
     perror_with_name ("Can't listen on socket");
 
+  return fd;
+}
+
+/* Prepare for a later connection to a remote debugger.
+   NAME is the filename used for communication.  */
+
+void
+remote_prepare (const char *name)
+{
+  client_state &cs = get_client_state ();
+
+  remote_is_stdio = 0;
+  if (strcmp (name, STDIO_CONNECTION_NAME) == 0)
+    {
+      /* We need to record fact that we're using stdio sooner than the
+	 call to remote_open so start_inferior knows the connection is
+	 via stdio.  */
+      remote_is_stdio = 1;
+      cs.transport_is_reliable = 1;
+      return;
+    }
+
+  listen_desc = remote_listen (name);
+  if (listen_desc == -1)
+    {
+      cs.transport_is_reliable = 0;
+      return;
+    }
+
   cs.transport_is_reliable = 1;
 }
 
@@ -1033,23 +1047,6 @@ write_enn (char *buf)
 
 #ifndef IN_PROCESS_AGENT
 
-static char *
-outreg (struct regcache *regcache, int regno, char *buf)
-{
-  if ((regno >> 12) != 0)
-    *buf++ = tohex ((regno >> 12) & 0xf);
-  if ((regno >> 8) != 0)
-    *buf++ = tohex ((regno >> 8) & 0xf);
-  *buf++ = tohex ((regno >> 4) & 0xf);
-  *buf++ = tohex (regno & 0xf);
-  *buf++ = ':';
-  collect_register_as_string (regcache, regno, buf);
-  buf += 2 * register_size (regcache->tdesc, regno);
-  *buf++ = ';';
-
-  return buf;
-}
-
 void
 prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
 {
@@ -1068,7 +1065,6 @@ prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
     case TARGET_WAITKIND_SYSCALL_ENTRY:
     case TARGET_WAITKIND_SYSCALL_RETURN:
       {
-	const char **regp;
 	struct regcache *regcache;
 	char *buf_start = buf;
 
@@ -1155,8 +1151,6 @@ prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
 
 	switch_to_thread (the_target, ptid);
 
-	regp = current_target_desc ()->expedite_regs;
-
 	regcache = get_thread_regcache (current_thread, 1);
 
 	if (the_target->stopped_by_watchpoint ())
@@ -1188,11 +1182,7 @@ prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
 	    buf += strlen (buf);
 	  }
 
-	while (*regp)
-	  {
-	    buf = outreg (regcache, find_regno (regcache->tdesc, *regp), buf);
-	    regp ++;
-	  }
+	buf = expedited_registers_to_string (regcache, buf);
 	*buf = '\0';
 
 	/* Formerly, if the debugger had not used any thread features
@@ -31,6 +31,12 @@ int putpkt (char *buf);
 int putpkt_binary (char *buf, int len);
 int putpkt_notif (char *buf);
 int getpkt (char *buf);
+
+/* Open a socket listening for TCP connections on NAME, a [HOST]:PORT
+   specification, and return its descriptor.  Return -1 if NAME has no
+   port, e.g. if it names a serial device.  */
+int remote_listen (const char *name);
+
 void remote_prepare (const char *name);
 void remote_open (const char *name);
 void remote_close (void);
@@ -35,6 +35,8 @@
 #include "tracepoint.h"
 #include "dll.h"
 #include "hostio.h"
+#include "readonly-client.h"
+#include "profile.h"
 #include <vector>
 #include "gdbsupport/common-inferior.h"
 #include "gdbsupport/job-control.h"
@@ -158,13 +160,26 @@ static struct btrace_config current_btrace_conf;
 
 static client_state g_client_state;
 
+/* The state of the client whose request is being handled.  This is
+   G_CLIENT_STATE, except while serving a read-only client.  */
+
+static client_state *current_client_state = &g_client_state;
+
 client_state &
 get_client_state ()
 {
-  client_state &cs = g_client_state;
+  client_state &cs = *current_client_state;
   return cs;
 }
 
+/* See server.h.  */
+
+scoped_restore_tmpl<client_state *>
+make_scoped_restore_client_state (client_state *cs)
+{
+  return make_scoped_restore (&current_client_state, cs);
+}
+
 
 /* Put a stop reply to the stop reply queue.  */
 
@@ -716,6 +731,49 @@ handle_general_set (char *own_buf)
       return;
     }
 
+  if (startswith (own_buf, "QSoftwareWatchpoints:"))
+    {
+      const char *p = own_buf + sizeof ("QSoftwareWatchpoints:") - 1;
+      struct process_info *process;
+
+      if (!target_running () || !the_target->supports_software_watchpoints ())
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      if (strcmp (p, "0") != 0
+	  && !(p[0] == '1' && (p[1] == ';' || p[1] == '\0')))
+	{
+	  fprintf (stderr, "Unknown software watchpoints mode requested: %s\n",
+		   own_buf);
+	  write_enn (own_buf);
+	  return;
+	}
+
+      process = current_process ();
+      clear_software_watchpoints (process);
+
+      for (p++; *p == ';' && p[1] == 'X'; )
+	{
+	  p++;
+	  add_software_watchpoint (process, &p);
+	}
+
+      if (*p != '\0')
+	{
+	  clear_software_watchpoints (process);
+	  write_enn (own_buf);
+	  return;
+	}
+
+      /* Changes made while the threads were stopped are not reported,
+	 as with hardware watchpoints.  */
+      record_software_watchpoint_values ();
+      write_ok (own_buf);
+      return;
+    }
+
   if (strcmp (own_buf, "QEnvironmentReset") == 0)
     {
       our_environ = gdb_environ::from_host_environ ();
@@ -834,6 +892,9 @@ handle_general_set (char *own_buf)
       && handle_tracepoint_general_set (own_buf))
     return;
 
+  if (handle_profile_general_set (own_buf))
+    return;
+
   if (startswith (own_buf, "QAgent:"))
     {
       char *mode = own_buf + strlen ("QAgent:");
@@ -1205,6 +1266,7 @@ handle_detach (char *own_buf)
 
   fprintf (stderr, "Detaching from process %d\n", process->pid);
   stop_tracing ();
+  stop_profiling ();
 
   /* We'll need this after PROCESS has been destroyed.  */
   int pid = process->pid;
@@ -1756,6 +1818,101 @@ handle_qxfer_threads (const char *annex,
   return len;
 }
 
+/* Helper for handle_qxfer_expedited_registers.  Emit the expedited
+   registers of THREAD, if GDB knows it is stopped, to BUFFER.
+   REGS_BUF is scratch space of PBUFSIZ bytes.  */
+
+static void
+handle_qxfer_expedited_registers_worker (thread_info *thread,
+					 struct buffer *buffer,
+					 char *regs_buf)
+{
+  /* In non-stop mode, only report the threads GDB knows are stopped.
+     In all-stop mode, all threads are stopped while GDB can talk to
+     us.  */
+  if (non_stop && thread->last_status.kind () == TARGET_WAITKIND_IGNORE)
+    return;
+
+  /* GDB doesn't know about fork children until it sees the
+     corresponding fork event.  */
+  if (target_thread_pending_parent (thread) != nullptr)
+    return;
+
+  char *p = write_ptid (regs_buf, ptid_of (thread));
+  *p++ = ';';
+
+  struct regcache *regcache = get_thread_regcache (thread, 1);
+  p = expedited_registers_to_string (regcache, p);
+  *p++ = '\n';
+  *p = '\0';
+
+  buffer_grow_str (buffer, regs_buf);
+}
+
+/* Handle qXfer:expedited-registers:read.  */
+
+static int
+handle_qxfer_expedited_registers (const char *annex,
+				  gdb_byte *readbuf, const gdb_byte *writebuf,
+				  ULONGEST offset, LONGEST len)
+{
+  client_state &cs = get_client_state ();
+  static char *result = 0;
+  static unsigned int result_length = 0;
+
+  if (writebuf != NULL)
+    return -2;
+
+  if (annex[0] != '\0' || !target_running ())
+    return -1;
+
+  /* When looking at a traceframe, the registers come from the trace
+     buffer, not from the threads.  */
+  if (cs.current_traceframe != -1)
+    return -1;
+
+  if (offset == 0)
+    {
+      struct buffer buffer;
+
+      /* When asked for data at offset 0, generate everything and
+	 store into 'result'.  Successive reads will be served off
+	 'result'.  */
+      free (result);
+
+      buffer_init (&buffer);
+
+      gdb::unique_xmalloc_ptr<char> regs_buf ((char *) xmalloc (PBUFSIZ));
+
+      for_each_thread ([&] (thread_info *thread)
+	{
+	  handle_qxfer_expedited_registers_worker (thread, &buffer,
+						   regs_buf.get ());
+	});
+
+      buffer_grow_str0 (&buffer, "");
+      result = buffer_finish (&buffer);
+      result_length = strlen (result);
+      buffer_free (&buffer);
+    }
+
+  if (offset >= result_length)
+    {
+      /* We're out of data.  */
+      free (result);
+      result = NULL;
+      result_length = 0;
+      return 0;
+    }
+
+  if (len > result_length - offset)
+    len = result_length - offset;
+
+  memcpy (readbuf, result + offset, len);
+
+  return len;
+}
+
 /* Handle qXfer:traceframe-info:read.  */
 
 static int
@@ -1807,6 +1964,35 @@ handle_qxfer_traceframe_info (const char *annex,
   return len;
 }
 
+/* Handle qXfer:trace-buffer:read.  */
+
+static int
+handle_qxfer_trace_buffer (const char *annex,
+			   gdb_byte *readbuf, const gdb_byte *writebuf,
+			   ULONGEST offset, LONGEST len)
+{
+  if (writebuf != NULL)
+    return -2;
+
+  return read_trace_buffer (annex, offset, readbuf, len);
+}
+
+/* Handle qXfer:profile:read.  */
+
+static int
+handle_qxfer_profile (const char *annex,
+		      gdb_byte *readbuf, const gdb_byte *writebuf,
+		      ULONGEST offset, LONGEST len)
+{
+  if (writebuf != NULL)
+    return -2;
+
+  if (annex[0] != '\0')
+    return -1;
+
+  return read_profile_samples (offset, readbuf, len);
+}
+
 /* Handle qXfer:fdpic:read.  */
 
 static int
@@ -1980,18 +2166,23 @@ static const struct qxfer qxfer_packets[] =
     { "btrace", handle_qxfer_btrace },
     { "btrace-conf", handle_qxfer_btrace_conf },
     { "exec-file", handle_qxfer_exec_file},
+    { "expedited-registers", handle_qxfer_expedited_registers },
     { "fdpic", handle_qxfer_fdpic},
     { "features", handle_qxfer_features },
     { "libraries", handle_qxfer_libraries },
     { "libraries-svr4", handle_qxfer_libraries_svr4 },
     { "osdata", handle_qxfer_osdata },
+    { "profile", handle_qxfer_profile },
     { "siginfo", handle_qxfer_siginfo },
     { "statictrace", handle_qxfer_statictrace },
     { "threads", handle_qxfer_threads },
+    { "trace-buffer", handle_qxfer_trace_buffer },
     { "traceframe-info", handle_qxfer_traceframe_info },
   };
 
-static int
+/* See server.h.  */
+
+int
 handle_qxfer (char *own_buf, int packet_len, int *new_packet_len_p)
 {
   int i;
@@ -2397,6 +2588,9 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       if (target_supports_catch_syscall ())
 	strcat (own_buf, ";QCatchSyscalls+");
 
+      if (the_target->supports_software_watchpoints ())
+	strcat (own_buf, ";QSoftwareWatchpoints+");
+
       if (the_target->supports_qxfer_libraries_svr4 ())
 	strcat (own_buf, ";qXfer:libraries-svr4:read+"
 		";augmented-libraries-svr4-read+");
@@ -2441,13 +2635,19 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	strcat (own_buf, ";exec-events+");
 
       if (target_supports_non_stop ())
-	strcat (own_buf, ";QNonStop+");
+	{
+	  strcat (own_buf, ";QNonStop+");
+	  strcat (own_buf, ";QProfile+");
+	  strcat (own_buf, ";qXfer:profile:read+");
+	}
 
       if (target_supports_disable_randomization ())
 	strcat (own_buf, ";QDisableRandomization+");
 
       strcat (own_buf, ";qXfer:threads:read+");
 
+      strcat (own_buf, ";qXfer:expedited-registers:read+");
+
       if (target_supports_tracepoints ())
 	{
 	  strcat (own_buf, ";ConditionalTracepoints+");
@@ -2460,6 +2660,9 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	  strcat (own_buf, ";InstallInTrace+");
 	  strcat (own_buf, ";qXfer:statictrace:read+");
 	  strcat (own_buf, ";qXfer:traceframe-info:read+");
+	  strcat (own_buf, ";qXfer:trace-buffer:read+");
+	  if (trace_buffer_zlib_supported ())
+	    strcat (own_buf, ";TraceBufferZlib+");
 	  strcat (own_buf, ";EnableDisableTracepoints+");
 	  strcat (own_buf, ";QTBuffer:size+");
 	  strcat (own_buf, ";tracenz+");
@@ -2773,6 +2976,20 @@ handle_pending_status (const struct thread_resume *resumption,
   return 0;
 }
 
+/* Callback for visit_actioned_threads.  If RESUMPTION resumes
+   THREAD, let read-only clients see its registers while it runs.  */
+
+static int
+save_registers_for_readonly_clients (const struct thread_resume *resumption,
+				     struct thread_info *thread)
+{
+  if (resumption->kind != resume_stop)
+    readonly_clients_thread_resuming (thread);
+
+  /* Only the first action that applies to THREAD counts.  */
+  return 1;
+}
+
 /* Parse vCont packets.  */
 static void
 handle_v_cont (char *own_buf)
@@ -2906,6 +3123,12 @@ resume (struct thread_resume *actions, size_t num_actions)
 
       enable_async_io ();
     }
+  else
+    for_each_thread ([&] (thread_info *thread)
+      {
+	visit_actioned_threads (thread, actions, num_actions,
+				save_registers_for_readonly_clients);
+      });
 
   the_target->resume (actions, num_actions);
 
@@ -3445,6 +3668,9 @@ gdbserver_usage (FILE *stream)
 	   "  --multi               Start server without a specific program, and\n"
 	   "                        only quit when explicitly commanded.\n"
 	   "  --once                Exit after the first connection has closed.\n"
+	   "  --readonly-listen=[HOST]:PORT\n"
+	   "                        Also accept connections on PORT from clients\n"
+	   "                        that only inspect the inferior, alongside GDB.\n"
 	   "  --help                Print this message and then exit.\n"
 	   "  --version             Display version information and exit.\n"
 	   "\n"
@@ -3687,6 +3913,7 @@ captured_main (int argc, char *argv[])
   int pid;
   char *arg_end;
   const char *port = NULL;
+  const char *readonly_port = NULL;
   char **next_arg = &argv[1];
   volatile int multi_mode = 0;
   volatile int attach = 0;
@@ -3830,6 +4057,8 @@ captured_main (int argc, char *argv[])
 	startup_with_shell = false;
       else if (strcmp (*next_arg, "--once") == 0)
 	run_once = true;
+      else if (startswith (*next_arg, "--readonly-listen="))
+	readonly_port = *next_arg + strlen ("--readonly-listen=");
       else if (strcmp (*next_arg, "--selftest") == 0)
 	selftest = true;
       else if (startswith (*next_arg, "--selftest="))
@@ -3881,6 +4110,8 @@ captured_main (int argc, char *argv[])
      start_inferior.  */
   if (port != NULL)
     remote_prepare (port);
+  if (readonly_port != NULL)
+    readonly_clients_listen (readonly_port);
 
   bad_attach = 0;
   pid = 0;
@@ -4019,6 +4250,8 @@ captured_main (int argc, char *argv[])
 		   "Remote side has terminated connection.  "
 		   "GDBserver will reopen the connection.\n");
 
+	  stop_profiling ();
+
 	  /* Get rid of any pending statuses.  An eventual reconnection
 	     (by the same GDB instance or another) will refresh all its
 	     state from scratch.  */
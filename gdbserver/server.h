@@ -97,6 +97,7 @@ extern int in_queued_stop_replies (ptid_t ptid);
 #include "utils.h"
 #include "debug.h"
 #include "gdbsupport/gdb_vecs.h"
+#include "gdbsupport/scoped_restore.h"
 
 /* Maximum number of bytes to read/write at once.  The value here
    is chosen to fill up a packet (the headers account for the 32).  */
@@ -134,6 +135,13 @@ struct client_state
     own_buf ((char *) xmalloc (PBUFSIZ + 1)) 
   {}
 
+  ~client_state ()
+  {
+    xfree (own_buf);
+  }
+
+  DISABLE_COPY_AND_ASSIGN (client_state);
+
   /* The thread set with an `Hc' packet.  `Hc' is deprecated in favor of
      `vCont'.  Note the multi-process extensions made `vCont' a
      requirement, so `Hc pPID.TID' is pretty much undefined.  So
@@ -197,6 +205,20 @@ struct client_state
 
 client_state &get_client_state ();
 
+/* Make CS the state get_client_state returns, while handling a request
+   from a client other than the main one, until the returned object is
+   destroyed.  */
+
+extern scoped_restore_tmpl<client_state *>
+  make_scoped_restore_client_state (client_state *cs);
+
+/* Handle a qXfer packet in OWN_BUF, of length PACKET_LEN.  Return 1
+   if the packet was handled, with the reply in OWN_BUF and its length
+   in *NEW_PACKET_LEN_P if it is binary, or 0 if it is not supported.  */
+
+extern int handle_qxfer (char *own_buf, int packet_len,
+			 int *new_packet_len_p);
+
 #include "gdbthread.h"
 #include "inferiors.h"
 
@@ -22,6 +22,7 @@
 #include "tracepoint.h"
 #include "gdbsupport/byte-vector.h"
 #include "hostio.h"
+#include "readonly-client.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -127,6 +128,7 @@ target_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
      update it.  */
   gdb::byte_vector buffer (myaddr, myaddr + len);
   check_mem_write (memaddr, buffer.data (), myaddr, len);
+  readonly_clients_invalidate_memory ();
   return the_target->write_memory (memaddr, buffer.data (), len);
 }
 
@@ -141,6 +143,11 @@ mywait (ptid_t ptid, struct target_waitstatus *ourstatus,
 
   ret = target_wait (ptid, ourstatus, options);
 
+  /* Whatever memory read-only clients were shown may have changed
+     while the thread ran.  */
+  if (ourstatus->kind () != TARGET_WAITKIND_IGNORE)
+    readonly_clients_invalidate_memory ();
+
   /* We don't expose _LOADED events to gdbserver core.  See the
      `dlls_changed' global.  */
   if (ourstatus->kind () == TARGET_WAITKIND_LOADED)
@@ -728,6 +735,18 @@ process_stratum_target::supports_range_stepping ()
   return false;
 }
 
+bool
+process_stratum_target::supports_software_watchpoints ()
+{
+  return false;
+}
+
+int
+process_stratum_target::frame_pointer_regno ()
+{
+  return -1;
+}
+
 bool
 process_stratum_target::supports_pid_to_exec_file ()
 {
@@ -412,6 +412,17 @@ class process_stratum_target
   /* Return true if target supports range stepping.  */
   virtual bool supports_range_stepping ();
 
+  /* Return true if the target can single-step the threads GDB wants
+     running, and only report a stop when the value of a software
+     watchpoint changes (see QSoftwareWatchpoints).  */
+  virtual bool supports_software_watchpoints ();
+
+  /* Return the number of the register that holds the frame pointer
+     of the current thread, if its frames can be walked by following
+     a chain of saved frame pointers, each stored just below the
+     return address of the frame.  Return -1 otherwise.  */
+  virtual int frame_pointer_regno ();
+
   /* Return true if the pid_to_exec_file op is supported.  */
   virtual bool supports_pid_to_exec_file ();
 
@@ -649,6 +660,9 @@ target_read_btrace_conf (struct btrace_target_info *tinfo,
 #define target_supports_range_stepping() \
   the_target->supports_range_stepping ()
 
+#define target_frame_pointer_regno() \
+  the_target->frame_pointer_regno ()
+
 #define target_supports_stopped_by_sw_breakpoint() \
   the_target->supports_stopped_by_sw_breakpoint ()
 
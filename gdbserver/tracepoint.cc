@@ -29,6 +29,12 @@
 #include "ax.h"
 #include "tdesc.h"
 
+#if !defined IN_PROCESS_AGENT && defined HAVE_LIBZ && defined HAVE_ZLIB_H
+#define HAVE_TRACE_BUFFER_ZLIB 1
+#include <zlib.h>
+#include "gdbsupport/byte-vector.h"
+#endif
+
 #define IPA_SYM_STRUCT_NAME ipa_sym_addresses
 #include "gdbsupport/agent.h"
 
@@ -126,6 +132,12 @@ trace_vdebug (const char *fmt, ...)
   IPA_SYM_EXPORTED_NAME (get_trace_state_variable_value_ptr)
 # define set_trace_state_variable_value_ptr \
   IPA_SYM_EXPORTED_NAME (set_trace_state_variable_value_ptr)
+# define compiled_ax_trace_ptr IPA_SYM_EXPORTED_NAME (compiled_ax_trace_ptr)
+# define compiled_ax_trace_quick_ptr \
+  IPA_SYM_EXPORTED_NAME (compiled_ax_trace_quick_ptr)
+# define compiled_ax_tracenz_ptr \
+  IPA_SYM_EXPORTED_NAME (compiled_ax_tracenz_ptr)
+# define compiled_ax_tracev_ptr IPA_SYM_EXPORTED_NAME (compiled_ax_tracev_ptr)
 # define ust_loaded IPA_SYM_EXPORTED_NAME (ust_loaded)
 # define helper_thread_id IPA_SYM_EXPORTED_NAME (helper_thread_id)
 # define cmd_buf IPA_SYM_EXPORTED_NAME (cmd_buf)
@@ -166,6 +178,10 @@ struct ipa_sym_addresses
   CORE_ADDR addr_get_raw_reg_ptr;
   CORE_ADDR addr_get_trace_state_variable_value_ptr;
   CORE_ADDR addr_set_trace_state_variable_value_ptr;
+  CORE_ADDR addr_compiled_ax_trace_ptr;
+  CORE_ADDR addr_compiled_ax_trace_quick_ptr;
+  CORE_ADDR addr_compiled_ax_tracenz_ptr;
+  CORE_ADDR addr_compiled_ax_tracev_ptr;
   CORE_ADDR addr_ust_loaded;
   CORE_ADDR addr_ipa_tdesc_idx;
 };
@@ -203,6 +219,10 @@ static struct
   IPA_SYM(get_raw_reg_ptr),
   IPA_SYM(get_trace_state_variable_value_ptr),
   IPA_SYM(set_trace_state_variable_value_ptr),
+  IPA_SYM(compiled_ax_trace_ptr),
+  IPA_SYM(compiled_ax_trace_quick_ptr),
+  IPA_SYM(compiled_ax_tracenz_ptr),
+  IPA_SYM(compiled_ax_tracev_ptr),
   IPA_SYM(ust_loaded),
   IPA_SYM(ipa_tdesc_idx),
 };
@@ -501,6 +521,10 @@ struct eval_expr_action
   struct tracepoint_action base;
 
   struct agent_expr *expr;
+
+  /* The address of the native code of EXPR, if it was compiled.  Only
+     the in-process agent runs it.  */
+  CORE_ADDR compiled;
 };
 
 /* An 'L' (collect static trace data) action.  */
@@ -691,6 +715,13 @@ struct tracepoint_hit_ctx;
 typedef enum eval_result_type (*condfn) (unsigned char *,
 					 ULONGEST *);
 
+#ifdef IN_PROCESS_AGENT
+/* The context of the collection action whose native code is running,
+   for the functions that code calls to record data.  Collection is
+   serialized by the jump pad's lock, so one is enough.  */
+static struct eval_agent_expr_context *compiled_ax_ctx;
+#endif
+
 /* The definition of a tracepoint.  */
 
 /* Tracepoints may have multiple locations, each at a different
@@ -1994,6 +2025,7 @@ add_tracepoint_action (struct tracepoint *tpoint, const char *packet)
 
 	    trace_debug ("Want to evaluate expression");
 	    xaction->expr = gdb_parse_agent_expr (&act);
+	    xaction->compiled = 0;
 	    break;
 	  }
 	default:
@@ -3612,8 +3644,13 @@ cmd_qtframe (char *own_buf)
     sprintf (own_buf, "F-1");
 }
 
+/* Reply to a qTStatus packet in PACKET.  If PAUSE is false, don't
+   pause the inferior to pull in the traceframes the in-process agent
+   collected since the last time; the status then does not count
+   them.  */
+
 static void
-cmd_qtstatus (char *packet)
+cmd_qtstatus (char *packet, bool pause)
 {
   char *stop_reason_rsp = NULL;
   char *buf1, *buf2, *buf3;
@@ -3641,7 +3678,7 @@ cmd_qtstatus (char *packet)
   trace_debug ("Returning trace status as %d, stop reason %s",
 	       tracing, tracing_stop_reason);
 
-  if (agent_loaded_p ())
+  if (pause && agent_loaded_p ())
     {
       target_pause_all (true);
 
@@ -4036,6 +4073,188 @@ cmd_qtbuffer (char *own_buf)
   bin2hex (tbp, own_buf, num);
 }
 
+/* Return the number of bytes of traceframes in the trace buffer.  */
+
+static ULONGEST
+trace_buffer_used (void)
+{
+  if (trace_buffer_free >= trace_buffer_start)
+    return trace_buffer_free - trace_buffer_start;
+  else
+    return ((trace_buffer_wrap - trace_buffer_start)
+	    + (trace_buffer_free - trace_buffer_lo));
+}
+
+/* Set *PTR to the data at OFFSET bytes from the first traceframe, and
+   return how many bytes are contiguous there, accounting for
+   wraparound.  OFFSET must be less than trace_buffer_used ().  */
+
+static ULONGEST
+trace_buffer_contiguous (ULONGEST offset, unsigned char **ptr)
+{
+  unsigned char *tbp = trace_buffer_start + offset;
+  ULONGEST tot = trace_buffer_used ();
+
+  if (tbp >= trace_buffer_wrap)
+    tbp -= (trace_buffer_wrap - trace_buffer_lo);
+
+  *ptr = tbp;
+  if (tbp >= trace_buffer_start)
+    return std::min<ULONGEST> (trace_buffer_wrap - tbp, tot - offset);
+  return tot - offset;
+}
+
+#ifdef HAVE_TRACE_BUFFER_ZLIB
+
+/* State of the zlib-compressed transfer of the trace buffer.  GDB
+   reads the compressed stream sequentially, so we compress it as GDB
+   asks for more, and only keep the output not yet sent.  */
+
+struct trace_buffer_deflate
+{
+  z_stream stream;
+
+  /* True if STREAM was initialized.  */
+  bool active = false;
+
+  /* True once all the input was compressed.  */
+  bool finished = false;
+
+  /* Number of bytes of the trace buffer to compress, as of the start
+     of the transfer, and how many were compressed so far.  */
+  ULONGEST in_size = 0;
+  ULONGEST in_offset = 0;
+
+  /* Compressed data GDB didn't get yet, and its offset in the
+     compressed stream.  */
+  gdb::byte_vector out;
+  ULONGEST out_offset = 0;
+};
+
+static trace_buffer_deflate trace_buffer_zlib;
+
+/* Read LEN bytes of the zlib-compressed trace buffer at OFFSET into
+   BUF.  Return the number of bytes read, 0 at the end of the stream,
+   or -1 on error.  An OFFSET of 0 starts a new transfer; otherwise,
+   OFFSET must not be before that of the previous request.  */
+
+static int
+read_trace_buffer_zlib (ULONGEST offset, unsigned char *buf, ULONGEST len)
+{
+  trace_buffer_deflate &z = trace_buffer_zlib;
+
+  if (offset == 0)
+    {
+      if (z.active)
+	deflateEnd (&z.stream);
+      memset (&z.stream, 0, sizeof (z.stream));
+      z.active = deflateInit (&z.stream, Z_BEST_SPEED) == Z_OK;
+      if (!z.active)
+	return -1;
+      z.finished = false;
+      z.in_size = trace_buffer_used ();
+      z.in_offset = 0;
+      z.out.clear ();
+      z.out_offset = 0;
+    }
+  else if (!z.active || offset < z.out_offset)
+    return -1;
+  else if (offset > z.out_offset + z.out.size ())
+    return z.finished ? 0 : -1;
+
+  /* Drop what GDB already has.  */
+  z.out.erase (z.out.begin (), z.out.begin () + (offset - z.out_offset));
+  z.out_offset = offset;
+
+  while (z.out.size () < len && !z.finished)
+    {
+      size_t old_size = z.out.size ();
+      unsigned char *in = NULL;
+      ULONGEST in_len = 0;
+      int flush = Z_FINISH;
+
+      z.out.resize (old_size + std::max<ULONGEST> (len, 4096));
+      z.stream.next_out = z.out.data () + old_size;
+      z.stream.avail_out = z.out.size () - old_size;
+
+      if (z.in_offset < z.in_size)
+	{
+	  in_len = trace_buffer_contiguous (z.in_offset, &in);
+	  in_len = std::min<ULONGEST> (in_len, z.in_size - z.in_offset);
+	  in_len = std::min<ULONGEST> (in_len, 1 << 20);
+	  flush = Z_NO_FLUSH;
+	}
+      z.stream.next_in = in;
+      z.stream.avail_in = in_len;
+
+      int ret = deflate (&z.stream, flush);
+
+      z.in_offset += in_len - z.stream.avail_in;
+      z.out.resize (z.out.size () - z.stream.avail_out);
+      if (ret == Z_STREAM_END)
+	z.finished = true;
+      else if (ret != Z_OK && ret != Z_BUF_ERROR)
+	{
+	  trace_debug ("deflate failed: %d", ret);
+	  return -1;
+	}
+    }
+
+  len = std::min<ULONGEST> (len, z.out.size ());
+  memcpy (buf, z.out.data (), len);
+  return len;
+}
+
+#endif
+
+/* See tracepoint.h.  */
+
+bool
+trace_buffer_zlib_supported (void)
+{
+#ifdef HAVE_TRACE_BUFFER_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* See tracepoint.h.  */
+
+int
+read_trace_buffer (const char *annex, ULONGEST offset,
+		   unsigned char *buf, ULONGEST len)
+{
+  trace_debug ("Want to read trace buffer (%s), %d bytes at offset 0x%s",
+	       annex, (int) len, phex_nz (offset, 0));
+
+#ifdef HAVE_TRACE_BUFFER_ZLIB
+  if (strcmp (annex, "zlib") == 0)
+    return read_trace_buffer_zlib (offset, buf, len);
+#endif
+
+  if (annex[0] != '\0')
+    return -1;
+
+  ULONGEST tot = trace_buffer_used ();
+
+  if (offset >= tot)
+    return 0;
+
+  len = std::min (len, tot - offset);
+  for (ULONGEST done = 0; done < len; )
+    {
+      unsigned char *tbp;
+      ULONGEST n = trace_buffer_contiguous (offset + done, &tbp);
+
+      n = std::min (n, len - done);
+      memcpy (buf + done, tbp, n);
+      done += n;
+    }
+
+  return len;
+}
+
 static void
 cmd_bigqtbuffer_circular (char *own_buf)
 {
@@ -4224,7 +4443,7 @@ handle_tracepoint_query (char *packet)
 {
   if (strcmp ("qTStatus", packet) == 0)
     {
-      cmd_qtstatus (packet);
+      cmd_qtstatus (packet, true);
       return 1;
     }
   else if (startswith (packet, "qTP:"))
@@ -4286,6 +4505,35 @@ handle_tracepoint_query (char *packet)
   return 0;
 }
 
+/* See tracepoint.h.  */
+
+int
+handle_tracepoint_readonly_query (char *packet)
+{
+  if (strcmp ("qTStatus", packet) == 0)
+    {
+      cmd_qtstatus (packet, false);
+      return 1;
+    }
+  else if (startswith (packet, "qTP:"))
+    {
+      cmd_qtp (packet);
+      return 1;
+    }
+  else if (startswith (packet, "qTV:"))
+    {
+      cmd_qtv (packet);
+      return 1;
+    }
+  else if (startswith (packet, "qTBuffer:"))
+    {
+      cmd_qtbuffer (packet);
+      return 1;
+    }
+
+  return 0;
+}
+
 #endif
 #ifndef IN_PROCESS_AGENT
 
@@ -4791,6 +5039,37 @@ do_action_at_tracepoint (struct tracepoint_hit_ctx *ctx,
 
 	trace_debug ("Want to collect registers");
 
+#ifdef IN_PROCESS_AGENT
+	if (ctx->type == fast_tracepoint
+	    && !((struct fast_tracepoint_ctx *) ctx)->regcache_initted)
+	  {
+	    struct fast_tracepoint_ctx *fctx
+	      = (struct fast_tracepoint_ctx *) ctx;
+	    const struct target_desc *ipa_tdesc
+	      = get_ipa_tdesc (ipa_tdesc_idx);
+
+	    /* Nothing read the registers yet (the condition, if any,
+	       was compiled).  Supply them straight into the regblock,
+	       and use that as the context's register cache from now on,
+	       instead of filling the cache and copying it.  */
+	    regcache_size = register_cache_size (ipa_tdesc);
+	    regspace = add_traceframe_block (tframe, tpoint,
+					     1 + regcache_size);
+	    if (regspace == NULL)
+	      {
+		trace_debug ("Trace buffer block allocation failed, skipping");
+		break;
+	      }
+	    *regspace = 'R';
+
+	    fctx->regcache_initted = 1;
+	    init_register_cache (&fctx->regcache, ipa_tdesc, regspace + 1);
+	    supply_regblock (&fctx->regcache, NULL);
+	    supply_fast_tracepoint_registers (&fctx->regcache, fctx->regs);
+	    break;
+	  }
+#endif
+
 	context_regcache = get_context_regcache (ctx);
 	regcache_size = register_cache_size (context_regcache->tdesc);
 
@@ -4838,13 +5117,31 @@ do_action_at_tracepoint (struct tracepoint_hit_ctx *ctx,
 	struct eval_agent_expr_context ax_ctx;
 
 	eaction = (struct eval_expr_action *) taction;
-	ax_ctx.regcache = get_context_regcache (ctx);
 	ax_ctx.tframe = tframe;
 	ax_ctx.tpoint = tpoint;
 
 	trace_debug ("Want to evaluate expression");
 
-	err = gdb_eval_agent_expr (&ax_ctx, eaction->expr, NULL);
+#ifdef IN_PROCESS_AGENT
+	if (eaction->compiled != 0 && ctx->type == fast_tracepoint)
+	  {
+	    struct fast_tracepoint_ctx *fctx
+	      = (struct fast_tracepoint_ctx *) ctx;
+	    ULONGEST value;
+
+	    /* Native code reads the raw registers itself.  */
+	    ax_ctx.regcache = NULL;
+	    compiled_ax_ctx = &ax_ctx;
+	    err = ((condfn) (uintptr_t) eaction->compiled) (fctx->regs,
+							      &value);
+	    compiled_ax_ctx = NULL;
+	  }
+	else
+#endif
+	  {
+	    ax_ctx.regcache = get_context_regcache (ctx);
+	    err = gdb_eval_agent_expr (&ax_ctx, eaction->expr, NULL);
+	  }
 
 	if (err != expr_eval_no_error)
 	  {
@@ -5815,6 +6112,10 @@ gdb_collect (struct tracepoint *tpoint, unsigned char *regs)
       if (ctx.tpoint->type != tpoint->type)
 	continue;
 
+      /* The register cache may live in the previous tracepoint's
+	 traceframe, which is not ours to keep using.  */
+      ctx.regcache_initted = 0;
+
       /* Test the condition if present, and collect if true.  */
       if (ctx.tpoint->cond == NULL
 	  || condition_true_at_tracepoint ((struct tracepoint_hit_ctx *) &ctx,
@@ -5849,6 +6150,38 @@ gdb_collect (struct tracepoint *tpoint, unsigned char *regs)
     }
 }
 
+/* The functions the native code of collection actions calls for the
+   trace, tracenz, trace_quick and tracev bytecodes.  They do what the
+   interpreter does for them.  */
+
+static void
+compiled_ax_trace (LONGEST addr, LONGEST size)
+{
+  if (compiled_ax_ctx != NULL)
+    agent_mem_read (compiled_ax_ctx, NULL, (CORE_ADDR) addr, size);
+}
+
+static void
+compiled_ax_tracenz (LONGEST addr, LONGEST size)
+{
+  if (compiled_ax_ctx != NULL)
+    agent_mem_read_string (compiled_ax_ctx, NULL, (CORE_ADDR) addr, size);
+}
+
+static void
+compiled_ax_trace_quick (int size, LONGEST addr)
+{
+  if (compiled_ax_ctx != NULL)
+    agent_mem_read (compiled_ax_ctx, NULL, (CORE_ADDR) addr, size);
+}
+
+static void
+compiled_ax_tracev (int num, LONGEST top)
+{
+  if (compiled_ax_ctx != NULL)
+    agent_tsv_read (compiled_ax_ctx, num);
+}
+
 /* These global variables points to the corresponding functions.  This is
    necessary on powerpc64, where asking for function symbol address from gdb
    results in returning the actual code pointer, instead of the descriptor
@@ -5858,6 +6191,8 @@ typedef void (*gdb_collect_ptr_type) (struct tracepoint *, unsigned char *);
 typedef ULONGEST (*get_raw_reg_ptr_type) (const unsigned char *, int);
 typedef LONGEST (*get_trace_state_variable_value_ptr_type) (int);
 typedef void (*set_trace_state_variable_value_ptr_type) (int, LONGEST);
+typedef void (*compiled_ax_trace_ptr_type) (LONGEST, LONGEST);
+typedef void (*compiled_ax_trace_quick_ptr_type) (int, LONGEST);
 
 EXTERN_C_PUSH
 IP_AGENT_EXPORT_VAR gdb_collect_ptr_type gdb_collect_ptr = gdb_collect;
@@ -5866,6 +6201,14 @@ IP_AGENT_EXPORT_VAR get_trace_state_variable_value_ptr_type
   get_trace_state_variable_value_ptr = get_trace_state_variable_value;
 IP_AGENT_EXPORT_VAR set_trace_state_variable_value_ptr_type
   set_trace_state_variable_value_ptr = set_trace_state_variable_value;
+IP_AGENT_EXPORT_VAR compiled_ax_trace_ptr_type
+  compiled_ax_trace_ptr = compiled_ax_trace;
+IP_AGENT_EXPORT_VAR compiled_ax_trace_quick_ptr_type
+  compiled_ax_trace_quick_ptr = compiled_ax_trace_quick;
+IP_AGENT_EXPORT_VAR compiled_ax_trace_ptr_type
+  compiled_ax_tracenz_ptr = compiled_ax_tracenz;
+IP_AGENT_EXPORT_VAR compiled_ax_trace_quick_ptr_type
+  compiled_ax_tracev_ptr = compiled_ax_tracev;
 EXTERN_C_POP
 
 #endif
@@ -5910,42 +6253,86 @@ get_set_tsv_func_addr (void)
   return res;
 }
 
-static void
-compile_tracepoint_condition (struct tracepoint *tpoint,
-			      CORE_ADDR *jump_entry)
+/* Return the function pointer stored at ADDR in the IPA.  NAME is the
+   name of the pointer, for the error message.  */
+
+static CORE_ADDR
+get_ipa_func_addr (CORE_ADDR addr, const char *name)
+{
+  CORE_ADDR res;
+
+  if (read_inferior_data_pointer (addr, &res))
+    error ("error extracting %s", name);
+  return res;
+}
+
+CORE_ADDR
+get_trace_func_addr (void)
+{
+  return get_ipa_func_addr (ipa_sym_addrs.addr_compiled_ax_trace_ptr,
+			    "compiled_ax_trace_ptr");
+}
+
+CORE_ADDR
+get_trace_quick_func_addr (void)
+{
+  return get_ipa_func_addr (ipa_sym_addrs.addr_compiled_ax_trace_quick_ptr,
+			    "compiled_ax_trace_quick_ptr");
+}
+
+CORE_ADDR
+get_tracenz_func_addr (void)
+{
+  return get_ipa_func_addr (ipa_sym_addrs.addr_compiled_ax_tracenz_ptr,
+			    "compiled_ax_tracenz_ptr");
+}
+
+CORE_ADDR
+get_tracev_func_addr (void)
+{
+  return get_ipa_func_addr (ipa_sym_addrs.addr_compiled_ax_tracev_ptr,
+			    "compiled_ax_tracev_ptr");
+}
+
+/* Align V up to N bits.  */
+#define UALIGN(V, N) (((V) + ((N) - 1)) & ~((N) - 1))
+
+/* Compile AEXPR into native code at *JUMP_ENTRY, for tracepoint
+   TPOINT.  WHAT says what AEXPR is, for debug output.  Return the
+   address of the code, or 0 if AEXPR could not be compiled.  */
+
+static CORE_ADDR
+compile_tracepoint_expr (struct tracepoint *tpoint, struct agent_expr *aexpr,
+			 const char *what, CORE_ADDR *jump_entry)
 {
   CORE_ADDR entry_point = *jump_entry;
   enum eval_result_type err;
 
-  trace_debug ("Starting condition compilation for tracepoint %d\n",
-	       tpoint->number);
+  trace_debug ("Starting %s compilation for tracepoint %d\n",
+	       what, tpoint->number);
 
   /* Initialize the global pointer to the code being built.  */
   current_insn_ptr = *jump_entry;
 
   emit_prologue ();
 
-  err = compile_bytecodes (tpoint->cond);
+  err = compile_bytecodes (aexpr);
 
   if (err == expr_eval_no_error)
     {
       emit_epilogue ();
 
-      /* Record the beginning of the compiled code.  */
-      tpoint->compiled_cond = entry_point;
-
-      trace_debug ("Condition compilation for tracepoint %d complete\n",
-		   tpoint->number);
+      trace_debug ("%s compilation for tracepoint %d complete\n",
+		   what, tpoint->number);
     }
   else
     {
       /* Leave the unfinished code in situ, but don't point to it.  */
+      entry_point = 0;
 
-      tpoint->compiled_cond = 0;
-
-      trace_debug ("Condition compilation for tracepoint %d failed, "
+      trace_debug ("%s compilation for tracepoint %d failed, "
 		   "error code %d",
-		   tpoint->number, err);
+		   what, tpoint->number, err);
     }
 
   /* Update the code pointer passed in.  Note that we do this even if
@@ -5955,6 +6342,41 @@ compile_tracepoint_condition (struct tracepoint *tpoint,
 
   /* Leave a gap, to aid dump decipherment.  */
   *jump_entry += 16;
+
+  return entry_point;
+}
+
+static void
+compile_tracepoint_condition (struct tracepoint *tpoint,
+			      CORE_ADDR *jump_entry)
+{
+  tpoint->compiled_cond = compile_tracepoint_expr (tpoint, tpoint->cond,
+						   "condition", jump_entry);
+}
+
+/* Compile the expressions of TPOINT's 'X' actions.  */
+
+static void
+compile_tracepoint_actions (struct tracepoint *tpoint,
+			    CORE_ADDR *jump_entry)
+{
+  for (int i = 0; i < tpoint->numactions; i++)
+    {
+      struct tracepoint_action *action = tpoint->actions[i];
+
+      if (action->type == 'X')
+	{
+	  struct eval_expr_action *eaction
+	    = (struct eval_expr_action *) action;
+
+	  /* Pad to 8-byte alignment.  */
+	  *jump_entry = UALIGN (*jump_entry, 8);
+
+	  eaction->compiled = compile_tracepoint_expr (tpoint, eaction->expr,
+						       "action expression",
+						       jump_entry);
+	}
+    }
 }
 
 /* The base pointer of the IPA's heap.  This is the only memory the
@@ -6009,9 +6431,6 @@ download_agent_expr (struct agent_expr *expr)
   return expr_addr;
 }
 
-/* Align V up to N bits.  */
-#define UALIGN(V, N) (((V) + ((N) - 1)) & ~((N) - 1))
-
 /* Sync tracepoint with IPA, but leave maintenance of linked list to caller.  */
 
 static void
@@ -6023,7 +6442,8 @@ download_tracepoint_1 (struct tracepoint *tpoint)
   gdb_assert (tpoint->type == fast_tracepoint
 	      || tpoint->type == static_tracepoint);
 
-  if (tpoint->cond != NULL && target_emit_ops () != NULL)
+  if ((tpoint->cond != NULL || tpoint->type == fast_tracepoint)
+      && target_emit_ops () != NULL)
     {
       CORE_ADDR jentry, jump_entry;
 
@@ -6039,6 +6459,13 @@ download_tracepoint_1 (struct tracepoint *tpoint)
 	  compile_tracepoint_condition (tpoint, &jentry);
 	}
 
+      /* The in-process agent only runs the native code of actions of
+	 fast tracepoints.  Only targets that can compile the trace
+	 bytecodes are able to compile them.  */
+      if (tpoint->type == fast_tracepoint
+	  && target_emit_ops ()->emit_void_call_pop_2 != NULL)
+	compile_tracepoint_actions (tpoint, &jentry);
+
       /* Pad to 8-byte alignment.  */
       jentry = UALIGN (jentry, 8);
       claim_jump_space (jentry - jump_entry);
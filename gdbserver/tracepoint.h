@@ -78,6 +78,11 @@ void stop_tracing (void);
 int handle_tracepoint_general_set (char *own_buf);
 int handle_tracepoint_query (char *own_buf);
 
+/* Handle the tracepoint queries read-only clients may send, which
+   neither change the trace run nor pause the inferior.  Return 1 if
+   OWN_BUF held one, with the reply in OWN_BUF.  */
+int handle_tracepoint_readonly_query (char *own_buf);
+
 int tracepoint_finished_step (struct thread_info *tinfo, CORE_ADDR stop_pc);
 int tracepoint_was_hit (struct thread_info *tinfo, CORE_ADDR stop_pc);
 
@@ -97,6 +102,19 @@ int traceframe_read_sdata (int tfnum, ULONGEST offset,
 
 int traceframe_read_info (int tfnum, struct buffer *buffer);
 
+/* Read LEN bytes of the trace buffer at OFFSET into BUF, for
+   qXfer:trace-buffer:read.  With an empty ANNEX, OFFSET is relative
+   to the first traceframe; with "zlib", the data read is the
+   zlib-compressed trace buffer.  Return the number of bytes read, 0
+   at the end, or -1 on error.  */
+
+int read_trace_buffer (const char *annex, ULONGEST offset,
+		       unsigned char *buf, ULONGEST len);
+
+/* Return true if read_trace_buffer supports the "zlib" annex.  */
+
+bool trace_buffer_zlib_supported (void);
+
 /* If a thread is determined to be collecting a fast tracepoint, this
    structure holds the collect status.  */
 
@@ -191,5 +209,12 @@ CORE_ADDR get_get_tsv_func_addr (void);
 /* Returns the address of the set_trace_state_variable_value
    function in the IPA.  */
 CORE_ADDR get_set_tsv_func_addr (void);
+/* Return the addresses of the functions in the IPA that compiled
+   collection actions call for the trace, trace_quick, tracenz and
+   tracev bytecodes.  */
+CORE_ADDR get_trace_func_addr (void);
+CORE_ADDR get_trace_quick_func_addr (void);
+CORE_ADDR get_tracenz_func_addr (void);
+CORE_ADDR get_tracev_func_addr (void);
 
 #endif /* GDBSERVER_TRACEPOINT_H */
@@ -21,6 +21,8 @@
 #include "gdbsupport/event-loop.h"
 
 #include <chrono>
+#include <set>
+#include <unordered_map>
 
 #ifdef HAVE_POLL
 #if defined (HAVE_POLL_H)
@@ -30,6 +32,11 @@
 #endif
 #endif
 
+#if defined (HAVE_POLL) && defined (__linux__)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
 #include <sys/types.h>
 #include "gdbsupport/gdb_sys_time.h"
 #include "gdbsupport/gdb_select.h"
@@ -74,8 +81,15 @@ struct file_handler
   /* Was an error detected on this fd?  */
   int error;
 
+  /* Tag identifying this file handler in the events reported by
+     epoll.  */
+  unsigned int epoll_tag;
+
   /* Next registered file descriptor.  */
   struct file_handler *next_file;
+
+  /* Previous registered file descriptor.  */
+  struct file_handler *prev_file;
 };
 
 /* Do we use poll or select ? */
@@ -87,6 +101,22 @@ struct file_handler
 
 static unsigned char use_poll = USE_POLL;
 
+/* Do we use epoll?  Unlike poll and select, epoll does not need to be
+   passed all the monitored file descriptors on each call, and only
+   returns the ready ones, so waiting for events does not get slower
+   as the number of file descriptors grows.  When epoll is used,
+   USE_POLL is set too, as the event masks are the same as poll's.  If
+   a file descriptor cannot be monitored with epoll (regular files, for
+   example), we switch to poll or select for good.  epoll and timerfd
+   exist on every GNU/Linux kernel and C library GDB supports.  */
+#if defined (HAVE_POLL) && defined (__linux__)
+#define USE_EPOLL 1
+#else
+#define USE_EPOLL 0
+#endif
+
+static unsigned char use_epoll = USE_EPOLL;
+
 #ifdef USE_WIN32API
 #include <windows.h>
 #include <io.h>
@@ -105,6 +135,9 @@ static struct
     /* Ptr to head of file handler list.  */
     file_handler *first_file_handler;
 
+    /* The file handlers, indexed by file descriptor.  */
+    std::unordered_map<int, file_handler *> file_handlers;
+
     /* Next file handler to handle, for the select variant.  To level
        the fairness across event sources, we serve file handlers in a
        round-robin-like fashion.  The number and order of the polled
@@ -143,6 +176,23 @@ static struct
 
     /* Flag to tell whether the timeout should be used.  */
     int timeout_valid;
+
+#if USE_EPOLL
+    /* The epoll instance, or -1 if it was not created yet.  */
+    int epoll_fd = -1;
+
+    /* A timerfd, monitored by EPOLL_FD, that is armed to expire with
+       the first timer, so that epoll_wait does not need a timeout.  */
+    int timer_fd = -1;
+
+    /* Whether TIMER_FD is armed, and for when.  */
+    bool timer_fd_armed;
+    std::chrono::steady_clock::time_point timer_fd_when;
+
+    /* The tag of the last file handler created.  Tag 0 identifies
+       TIMER_FD.  */
+    unsigned int last_epoll_tag;
+#endif
   }
 gdb_notifier;
 
@@ -151,18 +201,22 @@ gdb_notifier;
 struct gdb_timer
   {
     std::chrono::steady_clock::time_point when;
-    int timer_id;
-    struct gdb_timer *next;
     timer_handler_func *proc;	    /* Function to call to do the work.  */
     gdb_client_data client_data;    /* Argument to async_handler_func.  */
   };
 
-/* List of currently active timers.  It is sorted in order of
-   increasing timers.  */
+/* A timer in the timer queue: its expiration time and its id.  */
+typedef std::pair<std::chrono::steady_clock::time_point, int> timer_key;
+
+/* The currently active timers.  */
 static struct
   {
-    /* Pointer to first in timer list.  */
-    struct gdb_timer *first_timer;
+    /* The timers, sorted in order of increasing expiration time, then
+       of creation.  */
+    std::set<timer_key> queue;
+
+    /* The timers, indexed by id.  */
+    std::unordered_map<int, gdb_timer> timers;
 
     /* Id of the last timer created.  */
     int num_timers;
@@ -172,6 +226,7 @@ timer_list;
 static void create_file_handler (int fd, int mask, handler_func *proc,
 				 gdb_client_data client_data,
 				 std::string &&name, bool is_ui);
+static void notifier_add_file_handler (file_handler *file_ptr);
 static int gdb_wait_for_event (int);
 static int update_wait_timeout (void);
 static int poll_timers (void);
@@ -242,6 +297,191 @@ gdb_do_one_event (void)
   return 1;
 }
 
+#if USE_EPOLL
+
+/* Return the data to register with epoll for file descriptor FD, whose
+   events are reported to the file handler with tag TAG.
+
+   epoll keeps monitoring a file description as long as it is open,
+   even if the file descriptor it was registered with is closed, as
+   when the description was duplicated or inherited.  The events it
+   then reports still carry the old number, which may have been reused
+   for a new file handler since.  The tag tells these stale events
+   apart.  */
+
+static uint64_t
+epoll_event_data (int fd, unsigned int tag)
+{
+  return ((uint64_t) tag << 32) | (uint32_t) fd;
+}
+
+/* Create a new epoll instance that monitors TIMER_FD.  Return -1 on
+   failure.  */
+
+static int
+epoll_create_instance (int timer_fd)
+{
+  int epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  if (epoll_fd == -1)
+    return -1;
+
+  struct epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.u64 = epoll_event_data (timer_fd, 0);
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, timer_fd, &event) == -1)
+    {
+      close (epoll_fd);
+      return -1;
+    }
+
+  return epoll_fd;
+}
+
+/* Create the epoll instance and the timer fd, if not done yet.  Return
+   false if epoll cannot be used.  */
+
+static bool
+epoll_init ()
+{
+  if (gdb_notifier.epoll_fd != -1)
+    return true;
+
+  int timer_fd = timerfd_create (CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (timer_fd == -1)
+    return false;
+
+  int epoll_fd = epoll_create_instance (timer_fd);
+  if (epoll_fd == -1)
+    {
+      close (timer_fd);
+      return false;
+    }
+
+  gdb_notifier.epoll_fd = epoll_fd;
+  gdb_notifier.timer_fd = timer_fd;
+  gdb_notifier.timer_fd_armed = false;
+  return true;
+}
+
+/* Stop using epoll, and monitor all the file handlers with poll (or
+   select, if USE_POLL was cleared) from now on.  */
+
+static void
+epoll_disable ()
+{
+  use_epoll = 0;
+
+  if (gdb_notifier.epoll_fd != -1)
+    {
+      close (gdb_notifier.timer_fd);
+      close (gdb_notifier.epoll_fd);
+      gdb_notifier.timer_fd = -1;
+      gdb_notifier.epoll_fd = -1;
+    }
+
+  gdb_notifier.num_fds = 0;
+  for (file_handler *file_ptr = gdb_notifier.first_file_handler;
+       file_ptr != NULL;
+       file_ptr = file_ptr->next_file)
+    {
+      if (!use_poll)
+	file_ptr->mask = GDB_READABLE | GDB_EXCEPTION;
+      notifier_add_file_handler (file_ptr);
+    }
+}
+
+/* Start monitoring FILE_PTR with epoll, or update its event mask.
+   Return false if epoll cannot monitor its file descriptor.  */
+
+static bool
+epoll_add_file_handler (file_handler *file_ptr)
+{
+  struct epoll_event event {};
+  event.events = file_ptr->mask;
+  event.data.u64 = epoll_event_data (file_ptr->fd, file_ptr->epoll_tag);
+
+  if (epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_MOD, file_ptr->fd,
+		 &event) == 0)
+    return true;
+
+  /* The file descriptor is not known, or was closed and reopened since
+     it was added.  */
+  return epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_ADD, file_ptr->fd,
+		    &event) == 0;
+}
+
+/* Replace the epoll instance with a new one that monitors all the
+   file handlers, which is the only way to get rid of the stale
+   registrations of file descriptors that were closed while their
+   file description stays open.  Fall back to poll if that fails.  */
+
+static void
+epoll_rebuild ()
+{
+  close (gdb_notifier.epoll_fd);
+  gdb_notifier.epoll_fd = epoll_create_instance (gdb_notifier.timer_fd);
+  if (gdb_notifier.epoll_fd == -1)
+    {
+      close (gdb_notifier.timer_fd);
+      gdb_notifier.timer_fd = -1;
+      epoll_disable ();
+      return;
+    }
+
+  for (file_handler *file_ptr = gdb_notifier.first_file_handler;
+       file_ptr != NULL;
+       file_ptr = file_ptr->next_file)
+    if (!epoll_add_file_handler (file_ptr))
+      {
+	epoll_disable ();
+	return;
+      }
+}
+
+/* Arm the timer fd to expire with the first timer, or disarm it if
+   there is no timer.  */
+
+static void
+epoll_update_timer_fd ()
+{
+  using namespace std::chrono;
+
+  if (timer_list.queue.empty ())
+    {
+      if (gdb_notifier.timer_fd_armed)
+	{
+	  struct itimerspec spec {};
+	  timerfd_settime (gdb_notifier.timer_fd, 0, &spec, NULL);
+	  gdb_notifier.timer_fd_armed = false;
+	}
+      return;
+    }
+
+  steady_clock::time_point when = timer_list.queue.begin ()->first;
+  if (gdb_notifier.timer_fd_armed && gdb_notifier.timer_fd_when == when)
+    return;
+
+  /* std::chrono::steady_clock is CLOCK_MONOTONIC on GNU/Linux.  A zero
+     expiration time would disarm the timer, so make it at least one
+     nanosecond; a time in the past expires at once.  */
+  nanoseconds ns = duration_cast<nanoseconds> (when.time_since_epoch ());
+  seconds sec = duration_cast<seconds> (ns);
+  struct itimerspec spec {};
+  spec.it_value.tv_sec = sec.count ();
+  spec.it_value.tv_nsec = (ns - sec).count ();
+  if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+    spec.it_value.tv_nsec = 1;
+
+  if (timerfd_settime (gdb_notifier.timer_fd, TFD_TIMER_ABSTIME, &spec,
+		       NULL) == -1)
+    perror_with_name (("timerfd_settime"));
+
+  gdb_notifier.timer_fd_armed = true;
+  gdb_notifier.timer_fd_when = when;
+}
+
+#endif /* USE_EPOLL */
+
 /* See event-loop.h  */
 
 void
@@ -263,7 +503,13 @@ add_file_handler (int fd, handler_func *proc, gdb_client_data client_data,
       fds.fd = fd;
       fds.events = POLLIN;
       if (poll (&fds, 1, 0) == 1 && (fds.revents & POLLNVAL))
-	use_poll = 0;
+	{
+	  use_poll = 0;
+#if USE_EPOLL
+	  if (use_epoll)
+	    epoll_disable ();
+#endif
+	}
 #else
       internal_error (__FILE__, __LINE__,
 		      _("use_poll without HAVE_POLL"));
@@ -301,15 +547,12 @@ create_file_handler (int fd, int mask, handler_func * proc,
 		     bool is_ui)
 {
   file_handler *file_ptr;
+  bool is_new = false;
 
   /* Do we already have a file handler for this file?  (We may be
      changing its associated procedure).  */
-  for (file_ptr = gdb_notifier.first_file_handler; file_ptr != NULL;
-       file_ptr = file_ptr->next_file)
-    {
-      if (file_ptr->fd == fd)
-	break;
-    }
+  auto it = gdb_notifier.file_handlers.find (fd);
+  file_ptr = it != gdb_notifier.file_handlers.end () ? it->second : NULL;
 
   /* It is a new file descriptor.  Add it to the list.  Otherwise, just
      change the data associated with it.  */
@@ -318,56 +561,99 @@ create_file_handler (int fd, int mask, handler_func * proc,
       file_ptr = new file_handler;
       file_ptr->fd = fd;
       file_ptr->ready_mask = 0;
+#if USE_EPOLL
+      /* Tag 0 is the timer fd's.  */
+      if (++gdb_notifier.last_epoll_tag == 0)
+	++gdb_notifier.last_epoll_tag;
+      file_ptr->epoll_tag = gdb_notifier.last_epoll_tag;
+#endif
+      file_ptr->prev_file = NULL;
       file_ptr->next_file = gdb_notifier.first_file_handler;
+      if (file_ptr->next_file != NULL)
+	file_ptr->next_file->prev_file = file_ptr;
       gdb_notifier.first_file_handler = file_ptr;
+      gdb_notifier.file_handlers[fd] = file_ptr;
+      is_new = true;
+    }
 
-      if (use_poll)
-	{
+  file_ptr->proc = proc;
+  file_ptr->client_data = client_data;
+  file_ptr->mask = mask;
+  file_ptr->name = std::move (name);
+  file_ptr->is_ui = is_ui;
+
+#if USE_EPOLL
+  if (use_epoll && epoll_init ())
+    {
+      if (is_new)
+	gdb_notifier.num_fds++;
+      if (epoll_add_file_handler (file_ptr))
+	return;
+    }
+
+  /* Either epoll could not be set up, or it cannot monitor FD.  Fall
+     back to poll for all the file descriptors.  This also registers
+     FILE_PTR.  */
+  if (use_epoll)
+    {
+      epoll_disable ();
+      return;
+    }
+#endif
+
+  if (is_new)
+    notifier_add_file_handler (file_ptr);
+}
+
+/* Register the new file handler FILE_PTR with the poll or select
+   notifier.  */
+
+static void
+notifier_add_file_handler (file_handler *file_ptr)
+{
+  int fd = file_ptr->fd;
+  int mask = file_ptr->mask;
+
+  if (use_poll)
+    {
 #ifdef HAVE_POLL
-	  gdb_notifier.num_fds++;
-	  if (gdb_notifier.poll_fds)
-	    gdb_notifier.poll_fds =
-	      (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
-					  (gdb_notifier.num_fds
-					   * sizeof (struct pollfd)));
-	  else
-	    gdb_notifier.poll_fds =
-	      XNEW (struct pollfd);
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
+      gdb_notifier.num_fds++;
+      if (gdb_notifier.poll_fds)
+	gdb_notifier.poll_fds =
+	  (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
+				      (gdb_notifier.num_fds
+				       * sizeof (struct pollfd)));
+      else
+	gdb_notifier.poll_fds =
+	  XNEW (struct pollfd);
+      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
+      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
+      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
 #else
-	  internal_error (__FILE__, __LINE__,
-			  _("use_poll without HAVE_POLL"));
+      internal_error (__FILE__, __LINE__,
+		      _("use_poll without HAVE_POLL"));
 #endif /* HAVE_POLL */
-	}
+    }
+  else
+    {
+      if (mask & GDB_READABLE)
+	FD_SET (fd, &gdb_notifier.check_masks[0]);
       else
-	{
-	  if (mask & GDB_READABLE)
-	    FD_SET (fd, &gdb_notifier.check_masks[0]);
-	  else
-	    FD_CLR (fd, &gdb_notifier.check_masks[0]);
+	FD_CLR (fd, &gdb_notifier.check_masks[0]);
 
-	  if (mask & GDB_WRITABLE)
-	    FD_SET (fd, &gdb_notifier.check_masks[1]);
-	  else
-	    FD_CLR (fd, &gdb_notifier.check_masks[1]);
+      if (mask & GDB_WRITABLE)
+	FD_SET (fd, &gdb_notifier.check_masks[1]);
+      else
+	FD_CLR (fd, &gdb_notifier.check_masks[1]);
 
-	  if (mask & GDB_EXCEPTION)
-	    FD_SET (fd, &gdb_notifier.check_masks[2]);
-	  else
-	    FD_CLR (fd, &gdb_notifier.check_masks[2]);
+      if (mask & GDB_EXCEPTION)
+	FD_SET (fd, &gdb_notifier.check_masks[2]);
+      else
+	FD_CLR (fd, &gdb_notifier.check_masks[2]);
 
-	  if (gdb_notifier.num_fds <= fd)
-	    gdb_notifier.num_fds = fd + 1;
-	}
+      if (gdb_notifier.num_fds <= fd)
+	gdb_notifier.num_fds = fd + 1;
     }
-
-  file_ptr->proc = proc;
-  file_ptr->client_data = client_data;
-  file_ptr->mask = mask;
-  file_ptr->name = std::move (name);
-  file_ptr->is_ui = is_ui;
 }
 
 /* Return the next file handler to handle, and advance to the next
@@ -406,19 +692,30 @@ delete_file_handler (int fd)
   int j;
   struct pollfd *new_poll_fds;
 #endif
+#if USE_EPOLL
+  bool rebuild_epoll = false;
+#endif
 
   /* Find the entry for the given file.  */
 
-  for (file_ptr = gdb_notifier.first_file_handler; file_ptr != NULL;
-       file_ptr = file_ptr->next_file)
-    {
-      if (file_ptr->fd == fd)
-	break;
-    }
-
-  if (file_ptr == NULL)
+  auto it = gdb_notifier.file_handlers.find (fd);
+  if (it == gdb_notifier.file_handlers.end ())
     return;
+  file_ptr = it->second;
+  gdb_notifier.file_handlers.erase (it);
 
+#if USE_EPOLL
+  if (use_epoll)
+    {
+      /* This fails if FD was closed already.  Its file description
+	 may still be open elsewhere though, and then still monitored,
+	 so start afresh once FILE_PTR is gone.  */
+      if (epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_DEL, fd, NULL) == -1)
+	rebuild_epoll = true;
+      gdb_notifier.num_fds--;
+    }
+  else
+#endif
   if (use_poll)
     {
 #ifdef HAVE_POLL
@@ -489,18 +786,20 @@ delete_file_handler (int fd)
     }
 
   /* Get rid of the file handler in the file handler list.  */
-  if (file_ptr == gdb_notifier.first_file_handler)
+  prev_ptr = file_ptr->prev_file;
+  if (prev_ptr == NULL)
     gdb_notifier.first_file_handler = file_ptr->next_file;
   else
-    {
-      for (prev_ptr = gdb_notifier.first_file_handler;
-	   prev_ptr->next_file != file_ptr;
-	   prev_ptr = prev_ptr->next_file)
-	;
-      prev_ptr->next_file = file_ptr->next_file;
-    }
+    prev_ptr->next_file = file_ptr->next_file;
+  if (file_ptr->next_file != NULL)
+    file_ptr->next_file->prev_file = prev_ptr;
 
   delete file_ptr;
+
+#if USE_EPOLL
+  if (rebuild_epoll)
+    epoll_rebuild ();
+#endif
 }
 
 /* Handle the given event by calling the procedure associated to the
@@ -599,6 +898,60 @@ gdb_wait_for_event (int block)
   if (block)
     update_wait_timeout ();
 
+#if USE_EPOLL
+  if (use_epoll)
+    {
+      /* Only ask for one event.  epoll moves the file descriptors it
+	 reports to the end of its ready list, so the ready file
+	 descriptors are served in a round-robin fashion, and there is
+	 no stale event left over should the handler change the set of
+	 monitored file descriptors.  */
+      struct epoll_event event;
+
+      num_found = epoll_wait (gdb_notifier.epoll_fd, &event, 1,
+			      block ? -1 : 0);
+
+      /* Don't print anything if we get out of epoll_wait because of a
+	 signal.  */
+      if (num_found == -1 && errno != EINTR)
+	perror_with_name (("epoll_wait"));
+
+      if (num_found <= 0)
+	return 0;
+
+      int fd = (uint32_t) event.data.u64;
+      unsigned int tag = event.data.u64 >> 32;
+
+      if (tag == 0)
+	{
+	  uint64_t expirations;
+
+	  /* Consume the expiration, the timer is handled below.  This
+	     may fail with EAGAIN if the timer was re-armed in the
+	     meantime, which is fine.  */
+	  ssize_t ret ATTRIBUTE_UNUSED
+	    = read (gdb_notifier.timer_fd, &expirations,
+		    sizeof (expirations));
+	  gdb_notifier.timer_fd_armed = false;
+	  return poll_timers ();
+	}
+
+      /* An event for a file handler that is gone, from a stale
+	 registration.  Get rid of it, or it would be reported again
+	 and again.  */
+      auto it = gdb_notifier.file_handlers.find (fd);
+      if (it == gdb_notifier.file_handlers.end ()
+	  || it->second->epoll_tag != tag)
+	{
+	  epoll_rebuild ();
+	  return 0;
+	}
+
+      handle_file_event (it->second, event.events);
+      return 1;
+    }
+#endif
+
   if (use_poll)
     {
 #ifdef HAVE_POLL
@@ -687,14 +1040,10 @@ gdb_wait_for_event (int block)
 	    break;
 	}
 
-      for (file_ptr = gdb_notifier.first_file_handler;
-	   file_ptr != NULL;
-	   file_ptr = file_ptr->next_file)
-	{
-	  if (file_ptr->fd == (gdb_notifier.poll_fds + i)->fd)
-	    break;
-	}
-      gdb_assert (file_ptr != NULL);
+      auto it = gdb_notifier.file_handlers.find
+	((gdb_notifier.poll_fds + i)->fd);
+      gdb_assert (it != gdb_notifier.file_handlers.end ());
+      file_ptr = it->second;
 
       mask = (gdb_notifier.poll_fds + i)->revents;
       handle_file_event (file_ptr, mask);
@@ -738,47 +1087,23 @@ create_timer (int ms, timer_handler_func *proc,
 	      gdb_client_data client_data)
 {
   using namespace std::chrono;
-  struct gdb_timer *timer_ptr, *timer_index, *prev_timer;
 
   steady_clock::time_point time_now = steady_clock::now ();
 
-  timer_ptr = new gdb_timer ();
-  timer_ptr->when = time_now + milliseconds (ms);
-  timer_ptr->proc = proc;
-  timer_ptr->client_data = client_data;
   timer_list.num_timers++;
-  timer_ptr->timer_id = timer_list.num_timers;
-
-  /* Now add the timer to the timer queue, making sure it is sorted in
-     increasing order of expiration.  */
-
-  for (timer_index = timer_list.first_timer;
-       timer_index != NULL;
-       timer_index = timer_index->next)
-    {
-      if (timer_index->when > timer_ptr->when)
-	break;
-    }
+  int timer_id = timer_list.num_timers;
 
-  if (timer_index == timer_list.first_timer)
-    {
-      timer_ptr->next = timer_list.first_timer;
-      timer_list.first_timer = timer_ptr;
-
-    }
-  else
-    {
-      for (prev_timer = timer_list.first_timer;
-	   prev_timer->next != timer_index;
-	   prev_timer = prev_timer->next)
-	;
+  gdb_timer &timer = timer_list.timers[timer_id];
+  timer.when = time_now + milliseconds (ms);
+  timer.proc = proc;
+  timer.client_data = client_data;
 
-      prev_timer->next = timer_ptr;
-      timer_ptr->next = timer_index;
-    }
+  /* Now add the timer to the timer queue, which is kept sorted in
+     increasing order of expiration.  */
+  timer_list.queue.emplace (timer.when, timer_id);
 
   gdb_notifier.timeout_valid = 0;
-  return timer_ptr->timer_id;
+  return timer_id;
 }
 
 /* There is a chance that the creator of the timer wants to get rid of
@@ -786,31 +1111,14 @@ create_timer (int ms, timer_handler_func *proc,
 void
 delete_timer (int id)
 {
-  struct gdb_timer *timer_ptr, *prev_timer = NULL;
-
   /* Find the entry for the given timer.  */
-
-  for (timer_ptr = timer_list.first_timer; timer_ptr != NULL;
-       timer_ptr = timer_ptr->next)
-    {
-      if (timer_ptr->timer_id == id)
-	break;
-    }
-
-  if (timer_ptr == NULL)
+  auto it = timer_list.timers.find (id);
+  if (it == timer_list.timers.end ())
     return;
-  /* Get rid of the timer in the timer list.  */
-  if (timer_ptr == timer_list.first_timer)
-    timer_list.first_timer = timer_ptr->next;
-  else
-    {
-      for (prev_timer = timer_list.first_timer;
-	   prev_timer->next != timer_ptr;
-	   prev_timer = prev_timer->next)
-	;
-      prev_timer->next = timer_ptr->next;
-    }
-  delete timer_ptr;
+
+  /* Get rid of the timer in the timer queue.  */
+  timer_list.queue.erase (timer_key (it->second.when, id));
+  timer_list.timers.erase (it);
 
   gdb_notifier.timeout_valid = 0;
 }
@@ -837,13 +1145,21 @@ duration_cast_timeval (const Duration &d)
 static int
 update_wait_timeout (void)
 {
-  if (timer_list.first_timer != NULL)
+#if USE_EPOLL
+  /* With epoll, the timer fd takes care of waking up when the first
+     timer expires.  */
+  if (use_epoll && gdb_notifier.epoll_fd != -1)
+    epoll_update_timer_fd ();
+#endif
+
+  if (!timer_list.queue.empty ())
     {
       using namespace std::chrono;
       steady_clock::time_point time_now = steady_clock::now ();
+      steady_clock::time_point first_when = timer_list.queue.begin ()->first;
       struct timeval timeout;
 
-      if (timer_list.first_timer->when < time_now)
+      if (first_when < time_now)
 	{
 	  /* It expired already.  */
 	  timeout.tv_sec = 0;
@@ -851,7 +1167,7 @@ update_wait_timeout (void)
 	}
       else
 	{
-	  steady_clock::duration d = timer_list.first_timer->when - time_now;
+	  steady_clock::duration d = first_when - time_now;
 	  timeout = duration_cast_timeval (d);
 	}
 
@@ -872,7 +1188,7 @@ update_wait_timeout (void)
 	}
       gdb_notifier.timeout_valid = 1;
 
-      if (timer_list.first_timer->when < time_now)
+      if (first_when < time_now)
 	return 1;
     }
   else
@@ -891,17 +1207,18 @@ poll_timers (void)
 {
   if (update_wait_timeout ())
     {
-      struct gdb_timer *timer_ptr = timer_list.first_timer;
-      timer_handler_func *proc = timer_ptr->proc;
-      gdb_client_data client_data = timer_ptr->client_data;
+      auto first = timer_list.queue.begin ();
+      auto it = timer_list.timers.find (first->second);
+      timer_handler_func *proc = it->second.proc;
+      gdb_client_data client_data = it->second.client_data;
 
-      /* Get rid of the timer from the beginning of the list.  */
-      timer_list.first_timer = timer_ptr->next;
+      /* Get rid of the timer from the beginning of the queue.  */
+      timer_list.queue.erase (first);
 
       /* Delete the timer before calling the callback, not after, in
 	 case the callback itself decides to try deleting the timer
 	 too.  */
-      delete timer_ptr;
+      timer_list.timers.erase (it);
 
       /* Call the procedure associated with that timer.  */
       (proc) (client_data);
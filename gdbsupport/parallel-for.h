@@ -21,7 +21,10 @@
 #define GDBSUPPORT_PARALLEL_FOR_H
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <type_traits>
+#include "gdbsupport/function-view.h"
 #include "gdbsupport/thread-pool.h"
 
 namespace gdb
@@ -111,6 +114,67 @@ struct par_for_accumulator<void>
   std::vector<std::future<void>> m_futures;
 };
 
+/* This is a helper class that holds the result of each chunk of a
+   dynamically scheduled parallel_for.  There is a specialization for
+   'void', below.  */
+template<typename T>
+struct par_for_chunk_results
+{
+public:
+
+  explicit par_for_chunk_results (size_t n_chunks)
+    : m_results (n_chunks)
+  {
+  }
+
+  /* The result type that is accumulated.  */
+  typedef std::vector<T> result_type;
+
+  /* Run TASK, which computes the result of the Ith chunk.  */
+  void run (size_t i, gdb::function_view<T ()> task)
+  {
+    m_results[i] = task ();
+  }
+
+  /* Return the results, in the order of the chunks.  */
+  result_type release ()
+  {
+    return std::move (m_results);
+  }
+
+private:
+
+  std::vector<T> m_results;
+};
+
+/* See the generic template.  */
+template<>
+struct par_for_chunk_results<void>
+{
+public:
+
+  explicit par_for_chunk_results (size_t n_chunks)
+  {
+  }
+
+  /* This specialization does not compute results.  */
+  typedef void result_type;
+
+  void run (size_t i, gdb::function_view<void ()> task)
+  {
+    task ();
+  }
+
+  result_type release ()
+  {
+  }
+};
+
+/* The number of chunks per thread that a size-weighted parallel_for
+   aims for.  Having more chunks than threads lets threads that are
+   done early pick up the remaining work.  */
+static constexpr size_t par_for_chunks_per_thread = 4;
+
 }
 
 /* A very simple "parallel for".  This splits the range of iterators
@@ -125,22 +189,134 @@ struct par_for_accumulator<void>
    at least N elements processed per thread.  Setting N to 0 is not
    allowed.
 
+   If TASK_SIZE is null, the range is split into one subrange of equal
+   element count per thread.  Otherwise, TASK_SIZE returns an estimate
+   of the cost of processing an element, and the range is split into
+   several subranges of about equal cost per thread.  The subranges
+   are handed out to the threads as they become free, costliest first,
+   so that a few expensive elements do not leave the other threads
+   idle.
+
    If the function returns a non-void type, then a vector of the
-   results is returned.  The size of the resulting vector depends on
-   the number of threads that were used.  */
+   results is returned, in the order of the subranges.  The size of
+   the resulting vector depends on the number of threads that were
+   used, and on how the range was split.  */
 
 template<class RandomIt, class RangeFunction>
 typename gdb::detail::par_for_accumulator<
     typename std::result_of<RangeFunction (RandomIt, RandomIt)>::type
   >::result_type
 parallel_for_each (unsigned n, RandomIt first, RandomIt last,
-		   RangeFunction callback)
+		   RangeFunction callback,
+		   gdb::function_view<size_t (RandomIt)> task_size = nullptr)
 {
   using result_type
     = typename std::result_of<RangeFunction (RandomIt, RandomIt)>::type;
 
   size_t n_threads = thread_pool::g_thread_pool->thread_count ();
   size_t n_elements = last - first;
+
+  if (task_size != nullptr && n_threads > 1 && n_elements > 1)
+    {
+      /* Require that there should be at least N elements in a
+	 subrange.  */
+      gdb_assert (n > 0);
+
+      size_t total_size = 0;
+      for (RandomIt iter = first; iter != last; ++iter)
+	total_size += task_size (iter);
+
+      size_t n_chunks = n_threads * detail::par_for_chunks_per_thread;
+      size_t chunk_size = std::max (total_size / n_chunks, (size_t) 1);
+
+      /* Subrange I is [BOUNDS[I], BOUNDS[I + 1]), and has cost
+	 SIZES[I].  */
+      std::vector<RandomIt> bounds;
+      std::vector<size_t> sizes;
+      bounds.push_back (first);
+      size_t this_size = 0;
+      size_t this_count = 0;
+      for (RandomIt iter = first; iter != last; ++iter)
+	{
+	  this_size += task_size (iter);
+	  ++this_count;
+	  if (this_size >= chunk_size && this_count >= n)
+	    {
+	      bounds.push_back (iter + 1);
+	      sizes.push_back (this_size);
+	      this_size = 0;
+	      this_count = 0;
+	    }
+	}
+      if (bounds.back () != last)
+	{
+	  bounds.push_back (last);
+	  sizes.push_back (this_size);
+	}
+      n_chunks = sizes.size ();
+
+      std::vector<size_t> order (n_chunks);
+      for (size_t i = 0; i < n_chunks; ++i)
+	order[i] = i;
+      std::stable_sort (order.begin (), order.end (),
+			[&] (size_t a, size_t b)
+			{
+			  return sizes[a] > sizes[b];
+			});
+
+      gdb::detail::par_for_chunk_results<result_type> results (n_chunks);
+      std::atomic<size_t> next_chunk (0);
+      auto run_chunks = [&] ()
+	{
+	  while (true)
+	    {
+	      size_t k = next_chunk++;
+	      if (k >= n_chunks)
+		break;
+	      size_t i = order[k];
+	      results.run (i, [&] ()
+		{
+		  return callback (bounds[i], bounds[i + 1]);
+		});
+	    }
+	};
+
+      n_threads = std::min (n_threads, n_chunks);
+      std::vector<std::future<void>> futures;
+      for (size_t i = 0; i < n_threads - 1; ++i)
+	futures.push_back (thread_pool::g_thread_pool->post_task (run_chunks));
+
+      /* The main thread takes part too.  The background tasks refer to
+	 the local variables, so they must all be waited for even if an
+	 exception is thrown.  */
+      std::exception_ptr exc;
+      try
+	{
+	  run_chunks ();
+	}
+      catch (...)
+	{
+	  exc = std::current_exception ();
+	}
+      for (auto &future : futures)
+	{
+	  try
+	    {
+	      /* Use 'get' and not 'wait', to propagate any exception.  */
+	      future.get ();
+	    }
+	  catch (...)
+	    {
+	      if (exc == nullptr)
+		exc = std::current_exception ();
+	    }
+	}
+      if (exc != nullptr)
+	std::rethrow_exception (exc);
+
+      return results.release ();
+    }
+
   size_t elts_per_thread = 0;
   if (n_threads > 1)
     {
@@ -130,6 +130,24 @@ set_thread_name (const char *name)
 namespace gdb
 {
 
+#if CXX_STD_THREAD
+
+struct thread_pool_worker
+{
+  /* The tasks posted by this worker.  The worker itself takes them
+     from the back, other workers steal them from the front.  */
+  std::deque<std::packaged_task<void ()>> tasks;
+
+  /* Protects TASKS.  */
+  std::mutex mutex;
+};
+
+/* The state of the current thread, if it is a worker of the thread
+   pool.  */
+static thread_local thread_pool_worker *current_worker;
+
+#endif /* CXX_STD_THREAD */
+
 /* The thread pool detach()s its threads, so that the threads will not
    prevent the process from exiting.  However, it was discovered that
    if any detached threads were still waiting on a condition variable,
@@ -141,6 +159,8 @@ namespace gdb
 */
 thread_pool *thread_pool::g_thread_pool = new thread_pool ();
 
+thread_pool::thread_pool () = default;
+
 thread_pool::~thread_pool ()
 {
   /* Because this is a singleton, we don't need to clean up.  The
@@ -155,13 +175,20 @@ thread_pool::set_thread_count (size_t num_threads)
 #if CXX_STD_THREAD
   std::lock_guard<std::mutex> guard (m_tasks_mutex);
 
+  /* When growing, threads that were asked to exit but did not do so
+     yet can simply be kept.  */
+  size_t kept = 0;
+  if (m_thread_count < num_threads)
+    kept = std::min (m_exit_requests, num_threads - m_thread_count);
+  m_exit_requests -= kept;
+
   /* If the new size is larger, start some new threads.  */
   if (m_thread_count < num_threads)
     {
       /* Ensure that signals used by gdb are blocked in the new
 	 threads.  */
       block_signals blocker;
-      for (size_t i = m_thread_count; i < num_threads; ++i)
+      for (size_t i = m_thread_count + kept; i < num_threads; ++i)
 	{
 	  try
 	    {
@@ -178,11 +205,11 @@ thread_pool::set_thread_count (size_t num_threads)
 	    }
 	}
     }
-  /* If the new size is smaller, terminate some existing threads.  */
+  /* If the new size is smaller, terminate some existing threads.
+     They exit once all the queued tasks have been taken.  */
   if (num_threads < m_thread_count)
     {
-      for (size_t i = num_threads; i < m_thread_count; ++i)
-	m_tasks.emplace ();
+      m_exit_requests += m_thread_count - num_threads;
       m_tasks_cv.notify_all ();
     }
 
@@ -193,15 +220,34 @@ thread_pool::set_thread_count (size_t num_threads)
 }
 
 void
-thread_pool::do_post_task (std::packaged_task<void ()> &&func)
+thread_pool::do_post_task (std::packaged_task<void ()> &&func,
+			   priority prio)
 {
   std::packaged_task<void ()> t (std::move (func));
 
 #if CXX_STD_THREAD
-  if (m_thread_count != 0)
+  thread_pool_worker *self = current_worker;
+  if (self != nullptr && prio == priority::normal)
+    {
+      /* A worker posting a task keeps it for itself, other workers
+	 can steal it if they are idle.  */
+      {
+	std::lock_guard<std::mutex> guard (self->mutex);
+	self->tasks.push_back (std::move (t));
+      }
+
+      /* This must be read after the task was pushed, see
+	 thread_function.  */
+      if (m_idle_workers > 0)
+	{
+	  std::lock_guard<std::mutex> guard (m_tasks_mutex);
+	  m_tasks_cv.notify_one ();
+	}
+    }
+  else if (m_thread_count != 0)
     {
       std::lock_guard<std::mutex> guard (m_tasks_mutex);
-      m_tasks.emplace (std::move (t));
+      m_tasks[(int) prio].push_back (std::move (t));
       m_tasks_cv.notify_one ();
     }
   else
@@ -214,6 +260,57 @@ thread_pool::do_post_task (std::packaged_task<void ()> &&func)
 
 #if CXX_STD_THREAD
 
+optional<thread_pool::task_t>
+thread_pool::find_task (thread_pool_worker *self)
+{
+  optional<task_t> result;
+
+  /* The most recent task of this worker, which is the most likely to
+     still have its data in the cache.  */
+  {
+    std::lock_guard<std::mutex> guard (self->mutex);
+    if (!self->tasks.empty ())
+      {
+	result.emplace (std::move (self->tasks.back ()));
+	self->tasks.pop_back ();
+	return result;
+      }
+  }
+
+  std::deque<task_t> &normal_tasks = m_tasks[(int) priority::normal];
+  if (!normal_tasks.empty ())
+    {
+      result.emplace (std::move (normal_tasks.front ()));
+      normal_tasks.pop_front ();
+      return result;
+    }
+
+  /* Steal the oldest task of another worker.  */
+  for (const auto &other : m_workers)
+    {
+      if (other.get () == self)
+	continue;
+
+      std::lock_guard<std::mutex> guard (other->mutex);
+      if (!other->tasks.empty ())
+	{
+	  result.emplace (std::move (other->tasks.front ()));
+	  other->tasks.pop_front ();
+	  return result;
+	}
+    }
+
+  std::deque<task_t> &background_tasks
+    = m_tasks[(int) priority::background];
+  if (!background_tasks.empty ())
+    {
+      result.emplace (std::move (background_tasks.front ()));
+      background_tasks.pop_front ();
+    }
+
+  return result;
+}
+
 void
 thread_pool::thread_function ()
 {
@@ -225,22 +322,53 @@ thread_pool::thread_function ()
      stack.  */
   gdb::alternate_signal_stack signal_stack;
 
+  thread_pool_worker *self = new thread_pool_worker;
+  {
+    std::lock_guard<std::mutex> guard (m_tasks_mutex);
+    m_workers.emplace_back (self);
+  }
+  current_worker = self;
+
   while (true)
     {
       optional<task_t> t;
 
       {
-	/* We want to hold the lock while examining the task list, but
-	   not while invoking the task function.  */
+	/* We want to hold the lock while looking for a task, but not
+	   while invoking the task function.  */
 	std::unique_lock<std::mutex> guard (m_tasks_mutex);
-	while (m_tasks.empty ())
-	  m_tasks_cv.wait (guard);
-	t = std::move (m_tasks.front());
-	m_tasks.pop ();
+
+	/* Count this worker as idle before looking at the deques.  A
+	   worker pushing a task to its deque reads the count after the
+	   push, so either the task is seen here, or the pushing worker
+	   wakes us up.  */
+	++m_idle_workers;
+	while (true)
+	  {
+	    t = find_task (self);
+	    if (t.has_value () || m_exit_requests > 0)
+	      break;
+	    m_tasks_cv.wait (guard);
+	  }
+	--m_idle_workers;
+
+	if (!t.has_value ())
+	  {
+	    /* The thread count was reduced and there is nothing left
+	       to do.  The deque of this worker is empty, as find_task
+	       looked at it first.  */
+	    --m_exit_requests;
+	    current_worker = nullptr;
+	    for (auto it = m_workers.begin (); it != m_workers.end (); ++it)
+	      if (it->get () == self)
+		{
+		  m_workers.erase (it);
+		  break;
+		}
+	    break;
+	  }
       }
 
-      if (!t.has_value ())
-	break;
       (*t) ();
     }
 }
@@ -20,10 +20,12 @@
 #ifndef GDBSUPPORT_THREAD_POOL_H
 #define GDBSUPPORT_THREAD_POOL_H
 
-#include <queue>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <functional>
 #if CXX_STD_THREAD
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -34,17 +36,41 @@
 namespace gdb
 {
 
+#if CXX_STD_THREAD
+/* The state of a worker thread of the thread pool.  */
+struct thread_pool_worker;
+#endif
+
 /* A thread pool.
 
    There is a single global thread pool, see g_thread_pool.  Tasks can
    be submitted to the thread pool.  They will be processed in worker
-   threads as time allows.  */
+   threads as time allows.
+
+   Tasks posted from a worker thread go to a deque owned by that
+   worker.  A worker takes its own tasks from the back of its deque,
+   and, when it has none, takes tasks from the shared queues or steals
+   them from the front of the deques of the other workers.  Background
+   tasks are only run when there is nothing else to do, so that work
+   the user is waiting for is not stuck behind them.  */
 class thread_pool
 {
 public:
   /* The sole global thread pool.  */
   static thread_pool *g_thread_pool;
 
+  /* The priority of a task.  */
+  enum class priority
+  {
+    /* Work that something is waiting for, like a "parallel for".  */
+    normal,
+
+    /* Work that is done ahead of time and whose result may not even
+       be needed, like highlighting a source file.  Nothing may wait
+       for such a task, as it can stay queued behind normal tasks.  */
+    background,
+  };
+
   ~thread_pool ();
   DISABLE_COPY_AND_ASSIGN (thread_pool);
 
@@ -62,53 +88,70 @@ class thread_pool
 #endif
   }
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
-  std::future<void> post_task (std::function<void ()> &&func)
+  /* Post a task to the thread pool, with priority PRIO.  A future is
+     returned, which can be used to wait for the result.  */
+  std::future<void> post_task (std::function<void ()> &&func,
+			       priority prio = priority::normal)
   {
     std::packaged_task<void ()> task (std::move (func));
     std::future<void> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), prio);
     return result;
   }
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
+  /* Post a task to the thread pool, with priority PRIO.  A future is
+     returned, which can be used to wait for the result.  */
   template<typename T>
-  std::future<T> post_task (std::function<T ()> &&func)
+  std::future<T> post_task (std::function<T ()> &&func,
+			    priority prio = priority::normal)
   {
     std::packaged_task<T ()> task (std::move (func));
     std::future<T> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), prio);
     return result;
   }
 
 private:
 
-  thread_pool () = default;
+  thread_pool ();
+
+  /* Post a task to the thread pool, with priority PRIO.  */
+  void do_post_task (std::packaged_task<void ()> &&func, priority prio);
 
 #if CXX_STD_THREAD
+  /* A convenience typedef for the type of a task.  */
+  typedef std::packaged_task<void ()> task_t;
+
   /* The callback for each worker thread.  */
   void thread_function ();
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
-  void do_post_task (std::packaged_task<void ()> &&func);
+  /* Find a task for worker SELF, removing it from where it was found.
+     M_TASKS_MUTEX must be held.  */
+  optional<task_t> find_task (thread_pool_worker *self);
 
   /* The current thread count.  */
   size_t m_thread_count = 0;
 
-  /* A convenience typedef for the type of a task.  */
-  typedef std::packaged_task<void ()> task_t;
+  /* The number of workers that should exit once there is no more
+     work, because the thread count was reduced.  */
+  size_t m_exit_requests = 0;
+
+  /* The tasks that were posted from outside the worker threads and
+     have not been processed yet, one queue per priority.  Background
+     tasks posted by workers go here too.  */
+  std::deque<task_t> m_tasks[2];
+
+  /* All the workers.  */
+  std::vector<std::unique_ptr<thread_pool_worker>> m_workers;
 
-  /* The tasks that have not been processed yet.  An optional is used
-     to represent a task.  If the optional is empty, then this means
-     that the receiving thread should terminate.  If the optional is
-     non-empty, then it is an actual task to evaluate.  */
-  std::queue<optional<task_t>> m_tasks;
+  /* The number of workers waiting for a task.  This is used to avoid
+     locking M_TASKS_MUTEX when a worker posts a task to its own
+     deque while no other worker could take it.  */
+  std::atomic<size_t> m_idle_workers {0};
 
   /* A condition variable and mutex that are used for communication
-     between the main thread and the worker threads.  */
+     between the main thread and the worker threads.  The mutex
+     protects everything above except the workers' own deques.  */
   std::condition_variable m_tasks_cv;
   std::mutex m_tasks_mutex;
 #endif /* CXX_STD_THREAD */